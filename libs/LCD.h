@@ -1,81 +1,98 @@
-/***************************************************************************//**
- * @file    LCD.h
- * @exnum   1
- * @author  Christopher Haas
- * @date    08.05.23
- * @mtrcn   3308365
- * @mail    tronikhaas@web.de
- *
- * @brief   Functions to drive and control the HD44780 LCD.
- *
- ******************************************************************************/
-
-#ifndef LIBS_LCD_H_
-#define LIBS_LCD_H_
-
-/******************************************************************************
- * INCLUDES
- *****************************************************************************/
-
-#include <msp430g2553.h>
-
-/******************************************************************************
- * CONSTANTS
- *****************************************************************************/
-
-
-
-/******************************************************************************
- * VARIABLES
- *****************************************************************************/
-
-
-
-/******************************************************************************
- * FUNCTION PROTOTYPES
- *****************************************************************************/
-
-/** Initialization */
-
-// Initialization of the LCD; set all pin directions,
-// basic setup of the LCD, etc. (1 pt.)
-void lcd_init (void);
-
-
-/** Control functions */
-
-// Enable (1) or disable (0) the display (i.e. hide all text) (0.5 pts.)
-void lcd_enable (unsigned char on);
-
-// Set the cursor to a certain x/y-position (0.5 pts.)
-void lcd_cursorSet (unsigned char x, unsigned char y);
-
-// Show (1) or hide (0) the cursor (0.5 pts.)
-void lcd_cursorShow (unsigned char on);
-
-// Blink (1) or don't blink (0) the cursor (0.5 pts.)
-void lcd_cursorBlink (unsigned char on);
-
-
-/** Data manipulation */
-
-// Delete everything on the LCD (1 pt.)
-void lcd_clear (void);
-
-// Put a single character on the display at the cursor's current position (1 pt.)
-void lcd_putChar (char character);
-
-// Show a given string on the display. If the text is too long to display,
-// don't show the rest (i.e. don't break into the next line) (1 pt.).
-void lcd_putText (char * text);
-
-// Show a given number at the cursor's current position.
-// Note that this is a signed variable! (1 pt.)
-void lcd_putNumber (int number);
-
-// Bonus create custom char
-void create_custom_char_one();
-void create_custom_char_two();
-void create_custom_char_three();
-
-#endif /* LIBS_LCD_H_ */
+/***************************************************************************//**
+ * @file    LCD.h
+ * @exnum   1
+ * @author  Christopher Haas
+ * @date    08.05.23
+ * @mtrcn   3308365
+ * @mail    tronikhaas@web.de
+ *
+ * @brief   Functions to drive and control the HD44780 LCD.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_LCD_H_
+#define LIBS_LCD_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include <msp430g2553.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define LCD_COLUMNS 16                  // visible cells per line
+#define LCD_LINES 2
+#define LCD_POWER_UP_MS 50              // wait after power-up before the first instruction
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/** Initialization */
+
+// Initialization of the LCD; set all pin directions,
+// basic setup of the LCD, etc. (1 pt.)
+void lcd_init (void);
+
+// The same in two parts, so other work can be done during the power-up time:
+// lcd_powerUp() sets the pins, lcd_configure() has to follow LCD_POWER_UP_MS later.
+void lcd_powerUp (void);
+void lcd_configure (void);
+
+
+/** Control functions */
+
+// Enable (1) or disable (0) the display (i.e. hide all text) (0.5 pts.)
+void lcd_enable (unsigned char on);
+
+// Set the cursor to a certain x/y-position (0.5 pts.)
+void lcd_cursorSet (unsigned char x, unsigned char y);
+
+// Show (1) or hide (0) the cursor (0.5 pts.)
+void lcd_cursorShow (unsigned char on);
+
+// Blink (1) or don't blink (0) the cursor (0.5 pts.)
+void lcd_cursorBlink (unsigned char on);
+
+
+/** Data manipulation */
+
+// Delete everything on the LCD (1 pt.)
+void lcd_clear (void);
+
+// Put a single character on the display at the cursor's current position (1 pt.)
+void lcd_putChar (char character);
+
+// Show a given string on the display. If the text is too long to display,
+// don't show the rest (i.e. don't break into the next line) (1 pt.).
+void lcd_putText (char * text);
+
+// Show a given number at the cursor's current position.
+// Note that this is a signed variable! (1 pt.)
+void lcd_putNumber (int number);
+
+// Show a given unsigned 32 bit number at the cursor's current position.
+void lcd_putLongNumber (unsigned long number);
+
+// Write the digits of an unsigned 32 bit number to text (at most 10 chars,
+// no terminating 0). Returns the number of digits.
+unsigned char lcd_formatLong (char * text, unsigned long number);
+
+// Show the LCD_COLUMNS chars of cells on line y, only the cells which differ
+// from what is shown are written. Cells can hold custom chars (0x00 - 0x07).
+void lcd_updateLine (unsigned char y, const char * cells);
+
+// Bonus upload all custom chars at once: a note (0x00), arrow down (0x02)
+// and arrow up (0x04)
+void lcd_loadGlyphs (void);
+
+#endif /* LIBS_LCD_H_ */
@@ -0,0 +1,70 @@
+/***************************************************************************//**
+ * @file    board.h
+ * @date    19.10.26
+ *
+ * @brief   Pin assignment of the board, the one place the drivers take it from.
+ *
+ * A pin is its port number and the mask of its bit, which the macros of
+ * hal.h take apart, e.g. HAL_HIGH(BOARD_LCD_EN). A mask can hold several
+ * bits of the same port to set them at once.
+ *
+ * The jumpers have to be set as described in main.c.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_BOARD_H_
+#define LIBS_BOARD_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include <msp430g2553.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+// HD44780 display in 4 bit mode
+#define BOARD_LCD_RS            3, BIT0
+#define BOARD_LCD_RW            3, BIT1
+#define BOARD_LCD_EN            3, BIT2
+#define BOARD_LCD_CONTROL       3, (BIT0 | BIT1 | BIT2)
+#define BOARD_LCD_D4            2, BIT0
+#define BOARD_LCD_D5            2, BIT1
+#define BOARD_LCD_D6            2, BIT2
+#define BOARD_LCD_D7            2, BIT3
+#define BOARD_LCD_DATA          2, (BIT0 | BIT1 | BIT2 | BIT3)
+
+// Two 74HC194, register 1 reads the buttons, register 2 drives the LEDs.
+// The mode pins are shared with the data pins of the display.
+#define BOARD_SHIFT_S0_2        2, BIT0
+#define BOARD_SHIFT_S1_2        2, BIT1
+#define BOARD_SHIFT_S0_1        2, BIT2
+#define BOARD_SHIFT_S1_1        2, BIT3
+#define BOARD_SHIFT_MODES       2, (BIT0 | BIT1 | BIT2 | BIT3)
+#define BOARD_SHIFT_CLK         2, BIT4
+#define BOARD_SHIFT_MR          2, BIT5     // /MR, low clears both registers
+#define BOARD_SHIFT_SR          2, BIT6     // serial input of both registers
+#define BOARD_SHIFT_QD          2, BIT7     // QD of register 1
+#define BOARD_SHIFT_OUTPUTS     2, (BIT0 | BIT1 | BIT2 | BIT3 | BIT4 | BIT5 | BIT6)
+#define BOARD_SHIFT_GPIO        2, (BIT6 | BIT7)    // XIN / XOUT after reset
+
+// USCI_A0 UART to the PC
+#define BOARD_UART_PINS         1, (BIT1 | BIT2)            // RXD, TXD
+
+// USCI_B0 is wired to the ADAC (I2C) and the flash (SPI), I2C_/SPI chooses
+#define BOARD_BUS_I2C           1, BIT3     // I2C_/SPI, high for I2C
+#define BOARD_I2C_PINS          1, (BIT6 | BIT7)            // XSCL, XSDA
+#define BOARD_SPI_PINS          1, (BIT5 | BIT6 | BIT7)     // CC_CLK, CC_SO, CC_SI
+
+// M25P16 flash
+#define BOARD_FLASH_CS          3, BIT4     // F_/CS
+#define BOARD_FLASH_HOLD        3, BIT3     // F_/HOLD
+#define BOARD_FLASH_WP          3, BIT5     // F_/WP
+#define BOARD_FLASH_IDLE        3, (BIT3 | BIT5)
+
+// Buzzer on TA0.2
+#define BOARD_BUZZER            3, BIT6
+
+#endif /* LIBS_BOARD_H_ */
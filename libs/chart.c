@@ -0,0 +1,109 @@
+/***************************************************************************//**
+ * @file    chart.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the chart decoder, format see chart.h.
+ *
+ * The decoder always holds the next note and only reads the following
+ * byte once that note was returned, so decoding a slot is O(1) and needs
+ * no buffer of the whole song.
+ ******************************************************************************/
+
+#include "./chart.h"
+#include <stddef.h>
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+void chart_fetch(ChartReader *r);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+/**
+ * Decode the next note into r->note and r->lane, sets r->done at the end
+ * and r->waiting if the source has no byte yet.
+ */
+void chart_fetch(ChartReader *r){
+    unsigned char b;
+
+    r->waiting = 0;
+    while(!r->done){
+        b = r->data != NULL ? *r->data++ : r->source();
+        if(b == CHART_WAIT){
+            r->waiting = 1;
+            return;
+        }
+        if(b == CHART_END){
+            r->done = 1;
+        }
+        else if(b == CHART_SKIP){
+            r->last += 63;
+        }
+        else{
+            r->last += b >> 2;
+            r->note = r->last;
+            r->lane = b & 0x3;
+            return;
+        }
+    }
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void chart_open(ChartReader *r, const unsigned char *chart){
+    r->length = chart[0] | (chart[1] << 8);
+    r->data = chart + 2;
+    r->source = NULL;
+    r->slot = 0;
+    r->last = 0;
+    r->done = 0;
+    r->mask = 0;
+    chart_fetch(r);
+}
+
+void chart_openSource(ChartReader *r, ChartSource source){
+    r->length = source();
+    r->length |= source() << 8;
+    r->data = NULL;
+    r->source = source;
+    r->slot = 0;
+    r->last = 0;
+    r->done = 0;
+    r->mask = 0;
+    chart_fetch(r);
+}
+
+unsigned char chart_next(ChartReader *r){
+    unsigned char mask;
+
+    if(r->waiting){
+        chart_fetch(r);
+    }
+    // collect all notes of this slot, more than one is a chord
+    while(!r->waiting && !r->done && r->note == r->slot){
+        r->mask |= 1 << r->lane;
+        chart_fetch(r);
+    }
+    if(r->waiting){
+        return CHART_WAITING;
+    }
+    mask = r->mask;
+    r->mask = 0;
+    r->slot++;
+    return mask;
+}
+
+unsigned int chart_length(const ChartReader *r){
+    return r->length;
+}
@@ -0,0 +1,103 @@
+/***************************************************************************//**
+ * @file    chart.h
+ * @date    19.10.26
+ *
+ * @brief   Packed chart format for the songs and a streaming decoder for it.
+ *
+ * A chart is a list of note events instead of one char per 1/8-slot:
+ *
+ *      byte 0, 1   number of slots of the song, low byte first
+ *      byte 2...   one byte per note, bits 7-2 are the number of slots since
+ *                  the previous note (0 - 62, 0 is a chord with it), bits 1-0
+ *                  the lane 1 - 4 minus one
+ *      0xFC        no note, just skip 63 slots (for longer pauses)
+ *      0xFF        end of the notes
+ *
+ * A ChartSource which can't give the next byte yet returns CHART_WAIT
+ * instead, chart_next() then returns CHART_WAITING and asks again on the
+ * next call.
+ *
+ * Lane n is the same as the char '0' + n in the old notes arrays and
+ * button n on the board.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_CHART_H_
+#define LIBS_CHART_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+// Helpers to write charts in the source code.
+#define CHART_LENGTH(slots)     ((slots) & 0xFF), ((slots) >> 8)
+#define CHART_NOTE(gap, lane)   (((gap) << 2) | ((lane) - 1))
+#define CHART_SKIP              0xFC
+#define CHART_WAIT              0xFE    // from a ChartSource: no byte yet, never in a chart
+#define CHART_END               0xFF
+
+#define CHART_WAITING           0x10    // from chart_next(): the slot isn't decoded yet
+
+#define CHART_MAX_GAP           62      // longest gap of CHART_NOTE(), use CHART_SKIP before for longer ones
+#define CHART_MIN_SLOTS         16      // shortest chart, the display shows 16 slots at once
+
+// Number of notes of a chart array, known at build time.
+// Only for charts without CHART_SKIP, every other byte but the header and
+// CHART_END is one note.
+#define CHART_NOTES(chart)      (sizeof(chart) - 3)
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+// State of the decoder for one chart, see chart_open() and chart_next().
+// Returns the next byte of a chart which is not in the MCU flash.
+typedef unsigned char (*ChartSource)(void);
+
+typedef struct{
+    const unsigned char *data;  // next byte to decode, NULL if read from source
+    ChartSource source;         // gives the bytes if data is NULL
+    unsigned int length;        // number of slots of the song
+    unsigned int slot;          // slot which chart_next() returns next
+    unsigned int last;          // slot of the last decoded note, gaps count from here
+    unsigned int note;          // slot of the decoded note not returned yet
+    unsigned char lane;         // lane (0 - 3) of that note
+    unsigned char done;         // 1 once CHART_END was read
+    unsigned char waiting;      // 1 if the source had no byte for the next note yet
+    unsigned char mask;         // lanes of the slot decoded before the source had to wait
+}ChartReader;
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Start decoding the chart at <chart> from slot 0.
+ */
+void chart_open(ChartReader *r, const unsigned char *chart);
+
+/**
+ * Start decoding a chart whose bytes come one by one from <source>,
+ * beginning with the length.
+ */
+void chart_openSource(ChartReader *r, ChartSource source);
+
+/**
+ * Returns the lanes of the next slot as mask, bit 0 is lane 1 ... bit 3
+ * is lane 4, 0 if there is no note. Slots after the end of the song are empty.
+ * Returns CHART_WAITING if the source has to be asked again for the slot.
+ */
+unsigned char chart_next(ChartReader *r);
+
+/**
+ * Returns the number of slots of the song.
+ */
+unsigned int chart_length(const ChartReader *r);
+
+#endif /* LIBS_CHART_H_ */
@@ -1,59 +1,72 @@
-/***************************************************************************//**
- * @file    common_isr.c
- * @author  Christopher Haas
- * @date    21.06.23
- *
- * @brief   To implement the callbacks
- *
- ******************************************************************************/
-
-/******************************************************************************
- * INCLUDES
- *****************************************************************************/
-
-#include "common_isr.h"
-
-/******************************************************************************
- * CONSTANTS
- *****************************************************************************/
-
-
-
-/******************************************************************************
- * VARIABLES
- *****************************************************************************/
-
-ISR_callback tx_isr = 0;
-ISR_callback rx_isr = 0;
-
-/******************************************************************************
- * FUNCTION PROTOTYPES
- *****************************************************************************/
-
-void tx_callback(ISR_callback callback) {
-    tx_isr = callback;
-}
-
-void rx_callback(ISR_callback callback) {
-    rx_isr = callback;
-}
-
-/**
- * Common ISR for USCIAB0TX
- * Vector number 6 can be found in msp430g2553.h
- */
-#pragma vector = 6
-__interrupt void USCIAB0TX_ISR(void)
-{
-    tx_isr();
-}
-
-/**
- * Common ISR for USCIAB0RX
- * Vector number 7 can be found in msp430g2553.h
- */
-#pragma vector = 7
-__interrupt void USCIAB0RX_ISR(void)
-{
-    rx_isr();
-}
+/***************************************************************************//**
+ * @file    common_isr.c
+ * @author  Christopher Haas
+ * @date    21.06.23
+ *
+ * @brief   The shared interrupts of USCI_A0 and USCI_B0
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include "common_isr.h"
+#include "uart.h"
+#include "i2c.h"
+#include "spi.h"
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Common ISR for USCIAB0TX
+ * Vector number 6 can be found in msp430g2553.h
+ */
+#pragma vector = 6
+__interrupt void USCIAB0TX_ISR(void)
+{
+    if((IE2 & UCA0TXIE) && (IFG2 & UCA0TXIFG)){
+        uart_txIsr();           // a pending USCI_B0 flag calls again right after
+        if(!(IE2 & UCA0TXIE)){
+            __bic_SR_register_on_exit(LPM0_bits);   // the ring is empty, ends uart_drain()
+        }
+    }
+    else if(COMMON_ISR_I2C()){
+        i2c_tx_isr();
+    }
+    else{
+        spi_tx_isr();
+    }
+}
+
+/**
+ * Common ISR for USCIAB0RX
+ * Vector number 7 can be found in msp430g2553.h
+ */
+#pragma vector = 7
+__interrupt void USCIAB0RX_ISR(void)
+{
+    if((IE2 & UCA0RXIE) && (IFG2 & UCA0RXIFG)){
+        uart_rxIsr();
+    }
+    else if(COMMON_ISR_I2C()){
+        i2c_rx_isr();
+    }
+    else{
+        spi_rx_isr();
+    }
+}
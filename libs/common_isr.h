@@ -1,45 +1,43 @@
-/***************************************************************************//**
- * @file    common_isr.h
- * @author  Christopher Haas
- * @date    21.06.23
- *
- * @brief   To implement the callbacks
- *
- ******************************************************************************/
-
-#ifndef LIBS_COMMON_ISR_H
-#define LIBS_COMMON_ISR_H
-
-/******************************************************************************
- * INCLUDES
- *****************************************************************************/
-
-
-
-/******************************************************************************
- * CONSTANTS
- *****************************************************************************/
-
-
-
-/******************************************************************************
- * VARIABLES
- *****************************************************************************/
-
-typedef void (*ISR_callback)(void);
-
-/******************************************************************************
- * FUNCTION PROTOTYPES
- *****************************************************************************/
-
-/**
- * Sets tx_isr to the callback
- */
-void tx_callback(ISR_callback tx_callback);
-
-/**
- * Sets rx_isr to the callback
- */
-void rx_callback(ISR_callback rx_callback);
-
-#endif /* LIBS_COMMON_ISR_H_ */
+/***************************************************************************//**
+ * @file    common_isr.h
+ * @author  Christopher Haas
+ * @date    21.06.23
+ *
+ * @brief   The shared interrupts of USCI_A0 and USCI_B0
+ *
+ * USCI_A0 (UART) and USCI_B0 (I2C / SPI) share the two vectors. The UART
+ * is always the same and its interrupts are called directly when its own
+ * flag caused the interrupt. Otherwise USCI_B0 caused it, and the mode it
+ * was set up in by i2c_init() or spi_init() picks the interrupt of I2C or
+ * SPI, without a callback pointer in RAM.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_COMMON_ISR_H
+#define LIBS_COMMON_ISR_H
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include <msp430g2553.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define COMMON_ISR_I2C()        ((UCB0CTL0 & UCMODE_3) == UCMODE_3)    // USCI_B0 runs I2C, else SPI
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+
+
+#endif /* LIBS_COMMON_ISR_H_ */
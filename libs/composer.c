@@ -0,0 +1,264 @@
+/***************************************************************************//**
+ * @file    composer.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the live chart recording.
+ *
+ * composer_press() packs the notes into composer_ring at composer_head,
+ * composer_poll() programs them from composer_tail on, which is also the
+ * offset of the next byte after the length of the chart. The length is
+ * only known at the end, its two bytes stay erased until then. A chunk
+ * ends at the end of the ring and of a flash page, so it is never split.
+ ******************************************************************************/
+
+#include "./composer.h"
+#include "./library.h"
+#include "./shared.h"
+#include "./flash.h"
+#include "./trace.h"
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define COMPOSER_BAR_SLOTS      (COMPOSER_BEAT * COMPOSER_BAR)
+#define COMPOSER_MAX_BYTES      (LIBRARY_MAX_SIZE - 3)  // packed notes at most, the length and CHART_END take 3
+
+enum ComposerState{
+    composerIdle,
+    composerRecording,
+    composerFinishing,                      // the rest of the notes and CHART_END are programmed
+    composerLength,                         // the length at the start of the chart
+    composerHeader,                         // the header without magic
+    composerMagic,                          // the magic, the song is complete with it
+};
+
+const unsigned char composer_end = CHART_END;
+const unsigned char composer_magic[2] = {LIBRARY_MAGIC & 0xFF, LIBRARY_MAGIC >> 8};
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+unsigned char composer_state = composerIdle;    // enum ComposerState
+unsigned char composer_flashing = 0;        // 1 after an erase or program was started
+
+#define composer_ring           (shared.compose.composer.ring)  // RAM of the mode
+#define composer_head           (shared.compose.composer.head)
+#define composer_tail           (shared.compose.composer.tail)
+#define composer_target         (shared.compose.composer.target)
+#define composer_lanes          (shared.compose.composer.lanes)
+#define composer_period         (shared.compose.composer.period)
+#define composer_grid           (shared.compose.composer.grid)
+#define composer_tick           (shared.compose.composer.tick)
+#define composer_last           (shared.compose.composer.last)
+#define composer_count          (shared.compose.composer.count)
+#define composer_length         (shared.compose.composer.length)
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+void composer_put(unsigned char byte);
+void composer_header(void);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void composer_put(unsigned char byte){
+    composer_ring[composer_head++ & (COMPOSER_BUFFER - 1)] = byte;
+}
+
+/**
+ * Program the header of the chart without its magic. The song plays with
+ * the tones of song 1, its name is "Recorded" and the number of the slot.
+ */
+void composer_header(void){
+    LibraryHeader header;
+    const char *text = "Recorded ";
+    unsigned char number = composer_target + 1;
+    unsigned char i;
+
+    header.size = 2 + composer_tail;
+    header.notes = composer_count;
+    header.period = COMPOSER_PERIOD;
+    for(i = 0; i < 4; i++){
+        header.tone[i] = songs[0].tone[i];
+    }
+    for(i = 0; *text; i++){
+        header.name[i] = *text++;
+    }
+    if(number >= 10){
+        header.name[i++] = '0' + number / 10;
+    }
+    header.name[i++] = '0' + number % 10;
+    while(i < LIBRARY_NAME){
+        header.name[i++] = ' ';
+    }
+    flash_program(LIBRARY_ADDRESS(composer_target) + 2, sizeof(LibraryHeader) - 2,
+                  (unsigned char *)&header.size);
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void composer_start(unsigned char slot, unsigned int period, unsigned int tick){
+    composer_target = slot;
+    composer_period = period;
+    composer_grid = -COMPOSER_COUNT_IN;
+    composer_tick = tick;
+    composer_last = 0;
+    composer_lanes = 0;
+    composer_count = 0;
+    composer_head = 0;
+    composer_tail = 0;
+    flash_erase(LIBRARY_ADDRESS(slot));     // also clears an unfinished chart of an earlier try
+    composer_flashing = 1;
+    composer_state = composerRecording;
+}
+
+unsigned char composer_step(void){
+    if(composer_state == composerRecording && composer_grid >= COMPOSER_MAX_SLOTS){
+        composer_finish();
+    }
+    if(composer_state != composerRecording){
+        return composerFull;
+    }
+    composer_grid++;
+    composer_tick += composer_period;
+    if(composer_grid % COMPOSER_BAR_SLOTS == 0){
+        return composerBar;
+    }
+    if(composer_grid % COMPOSER_BEAT == 0){
+        return composerBeat;
+    }
+    return composerSilent;
+}
+
+int composer_slot(void){
+    return composer_grid;
+}
+
+unsigned char composer_press(unsigned int tick, unsigned char lane){
+    int slot = composer_grid + (tick - composer_tick + composer_period / 2) / composer_period;
+    unsigned int gap;
+
+    if(composer_state != composerRecording || slot < 0){
+        return 0;
+    }
+    if((unsigned int)slot < composer_last){
+        slot = composer_last;               // a late task, the notes stay in order
+    }
+    gap = slot - composer_last;
+    if(gap == 0 && (composer_lanes & (1 << (lane - 1)))){
+        return 0;                           // the lane has its note in this slot
+    }
+    if(composer_head + gap / (CHART_MAX_GAP + 1) + 1 > COMPOSER_MAX_BYTES){
+        composer_finish();                  // the chart is full
+        return 0;
+    }
+    if(COMPOSER_BUFFER - (composer_head - composer_tail) < gap / (CHART_MAX_GAP + 1) + 1){
+        return 0;                           // the flash fell behind
+    }
+    while(gap > CHART_MAX_GAP){
+        composer_put(CHART_SKIP);
+        gap -= CHART_MAX_GAP + 1;
+    }
+    composer_put(CHART_NOTE(gap, lane));
+    if((unsigned int)slot != composer_last){
+        composer_lanes = 0;
+    }
+    composer_last = slot;
+    composer_lanes |= 1 << (lane - 1);
+    composer_count++;
+    return 1;
+}
+
+unsigned int composer_notes(void){
+    return composer_count;
+}
+
+void composer_finish(void){
+    unsigned int end = composer_last;
+
+    if(composer_state != composerRecording){
+        return;
+    }
+    if(composer_grid > (int)end){
+        end = composer_grid;
+    }
+    if(composer_count == 0){
+        composer_state = composerIdle;      // the erased sector stays an empty slot
+        return;
+    }
+    // one more bar, the game ends once the last 16 slots are on the display
+    composer_length = (end / COMPOSER_BAR_SLOTS + 2) * COMPOSER_BAR_SLOTS;
+    composer_state = composerFinishing;
+}
+
+unsigned char composer_poll(void){
+    long int address = LIBRARY_ADDRESS(composer_target) + LIBRARY_CHART + 2 + composer_tail;
+    unsigned int count = composer_head - composer_tail;
+    unsigned char length[2];
+    unsigned int room;
+
+    if(composer_flashing){
+        if(flash_busy()){
+            return 1;
+        }
+        composer_flashing = 0;
+    }
+    switch(composer_state){
+        case composerIdle:
+            return 0;
+        case composerRecording:
+        case composerFinishing:
+            if(count == 0 && composer_state == composerFinishing){
+                flash_program(address, 1, (unsigned char *)&composer_end);
+                composer_tail++;
+                composer_state = composerLength;
+                break;
+            }
+            if(count < COMPOSER_CHUNK && composer_state == composerRecording){
+                return 0;
+            }
+            if(count > COMPOSER_CHUNK){
+                count = COMPOSER_CHUNK;
+            }
+            room = 0x100 - (address & 0xFF);                                // to the end of the page
+            if(count > room){
+                count = room;
+            }
+            room = COMPOSER_BUFFER - (composer_tail & (COMPOSER_BUFFER - 1));   // to the end of the ring
+            if(count > room){
+                count = room;
+            }
+            flash_program(address, count, &composer_ring[composer_tail & (COMPOSER_BUFFER - 1)]);
+            composer_tail += count;
+            break;
+        case composerLength:
+            length[0] = composer_length & 0xFF;
+            length[1] = composer_length >> 8;
+            flash_program(LIBRARY_ADDRESS(composer_target) + LIBRARY_CHART, 2, length);
+            composer_state = composerHeader;
+            break;
+        case composerHeader:
+            composer_header();
+            composer_state = composerMagic;
+            break;
+        case composerMagic:
+            flash_program(LIBRARY_ADDRESS(composer_target), 2, (unsigned char *)composer_magic);
+            composer_state = composerIdle;
+            TRACE(traceComposer, composer_target);
+            break;
+    }
+    composer_flashing = 1;
+    return 1;
+}
+
+unsigned char composer_pending(void){
+    return composer_flashing || (composer_state != composerIdle && composer_state != composerRecording) ||
+           (composer_state == composerRecording && composer_head - composer_tail >= COMPOSER_CHUNK);
+}
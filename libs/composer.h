@@ -0,0 +1,126 @@
+/***************************************************************************//**
+ * @file    composer.h
+ * @date    19.10.26
+ *
+ * @brief   Live recording of a new chart into the song library.
+ *
+ * The player presses the buttons along with a metronome, every press is
+ * put on the nearest slot of the grid and becomes a note of its lane,
+ * button n is lane n like in the songs. The notes are packed like chart.h
+ * describes and programmed to the sector of a free slot of the library
+ * (library.h) while recording, so the chart isn't limited by the RAM. The
+ * recording ends by itself once the chart would get longer than
+ * LIBRARY_MAX_SIZE bytes or COMPOSER_MAX_SLOTS slots.
+ *
+ * The grid starts after COMPOSER_COUNT_IN slots of count-in, which also
+ * covers most of the sector erase. Once the recording ends the length of
+ * the chart and its header are programmed, the magic last like the loader
+ * does, and the song can be played right away.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_COMPOSER_H_
+#define LIBS_COMPOSER_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define COMPOSER_PERIOD         125         // ms per slot on Expert like song 1, Normal is twice as long
+#define COMPOSER_BEAT           4           // slots per beat of the metronome
+#define COMPOSER_BAR            4           // beats per bar, the first one is accented
+#define COMPOSER_COUNT_IN       (COMPOSER_BEAT * COMPOSER_BAR)  // slots before the first one of the chart
+#define COMPOSER_BUFFER         16          // RAM ring of packed notes, power of 2
+#define COMPOSER_CHUNK          8           // bytes programmed at once
+#define COMPOSER_MAX_SLOTS      0x7F00      // slots of the grid at most, the grid and the length stay in an int
+
+enum ComposerClick{
+    composerSilent,                         // the slot isn't on a beat
+    composerBeat,
+    composerBar,                            // first beat of a bar
+    composerFull,                           // the chart is full, the recording ended
+};
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+// RAM of a recording, only valid until it is programmed, see shared.h
+typedef struct{
+    unsigned char ring[COMPOSER_BUFFER];    // packed notes not programmed yet
+    unsigned int head;                      // next byte written by composer_press()
+    unsigned int tail;                      // next byte programmed by composer_poll()
+    unsigned char target;                   // library slot of the chart
+    unsigned char lanes;                    // lanes of the notes in slot last
+    unsigned int period;                    // ms per slot
+    int grid;                               // slot of the grid, negative during the count-in
+    unsigned int tick;                      // tick it started
+    unsigned int last;                      // slot of the last note, gaps count from here
+    unsigned int count;                     // notes of the chart
+    unsigned int length;                    // slots of the chart, set at the end
+}ComposerRam;
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Start recording a chart into library slot <slot> with <period> ms per
+ * slot. The count-in starts at tick <tick>, the sector of the slot is
+ * erased in the background. The flash has to be selected and idle.
+ */
+void composer_start(unsigned char slot, unsigned int period, unsigned int tick);
+
+/**
+ * Move on to the next slot, call it every period ms.
+ * Returns the enum ComposerClick of the metronome for it, composerFull
+ * once the recording ended because the chart is full.
+ */
+unsigned char composer_step(void);
+
+/**
+ * Returns the slot of the grid, negative during the count-in.
+ */
+int composer_slot(void);
+
+/**
+ * Put a press of <lane> (1 - 4) at tick <tick> on the nearest slot. Presses
+ * in the count-in, a second one of a lane in the same slot or one which
+ * doesn't fit into the ring any more are left out. One which doesn't fit
+ * into the chart any more ends the recording.
+ * Returns 1 if it became a note.
+ */
+unsigned char composer_press(unsigned int tick, unsigned char lane);
+
+/**
+ * Returns the number of notes so far.
+ */
+unsigned int composer_notes(void);
+
+/**
+ * End the recording, the chart lasts until the end of the current bar and
+ * one more, so the last notes reach the player. Without notes no song is
+ * written.
+ */
+void composer_finish(void);
+
+/**
+ * Erase the sector, program the next chunk of notes or the end of the
+ * chart, one step per call. Never waits for the flash. The flash has to
+ * be selected.
+ * Returns 1 while there is more to do than the recording has collected yet.
+ */
+unsigned char composer_poll(void);
+
+/**
+ * Returns 1 if composer_poll() has something to do.
+ */
+unsigned char composer_pending(void);
+
+#endif /* LIBS_COMPOSER_H_ */
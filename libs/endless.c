@@ -0,0 +1,131 @@
+/***************************************************************************//**
+ * @file    endless.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the endless chart generator.
+ *
+ * The LFSR is a Galois one with the taps 0xB400, which runs through all
+ * 65535 states but 0. Each random bit is one shift, a slot takes 8 bits
+ * for its note and 2 for the lane, so a slot costs a few shifts and no
+ * multiplication.
+ ******************************************************************************/
+
+#include "./endless.h"
+#include "./shared.h"
+#include <stddef.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define ENDLESS_TAPS            0xB400
+
+const Song endless_song = {
+    .chart = NULL, .size = 0,
+    .notes = 0,                                 // not known before the end
+    .tone = {262, 330, 392, 523},
+    .period = ENDLESS_PERIOD,
+    .perfect = {0xFFFFFFFF, 0xFFFFFFFF},        // a run has no perfect score
+    .good = {SCORE_MULTIPLIED(ENDLESS_GOOD) * SCORE_PERFECT_NORMAL,
+             SCORE_MULTIPLIED(ENDLESS_GOOD) * SCORE_PERFECT_EXPERT},
+    .tempo = endless_tempo,
+    .lives = ENDLESS_LIVES,
+};
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+#define endless_lfsr            (shared.play.chart.endless.lfsr)    // RAM of the mode
+#define endless_slot            (shared.play.chart.endless.slot)
+#define endless_last            (shared.play.chart.endless.last)
+#define endless_header          (shared.play.chart.endless.header)
+#define endless_chord           (shared.play.chart.endless.chord)
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+unsigned char endless_bits(unsigned char count);
+unsigned char endless_level(unsigned int slot);
+unsigned char endless_next(void);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+/**
+ * Shift the LFSR <count> (1 - 8) times, returns the bits shifted out.
+ */
+unsigned char endless_bits(unsigned char count){
+    unsigned char bits = 0;
+
+    while(count--){
+        bits = bits << 1 | (endless_lfsr & 1);
+        endless_lfsr = endless_lfsr & 1 ? endless_lfsr >> 1 ^ ENDLESS_TAPS : endless_lfsr >> 1;
+    }
+    return bits;
+}
+
+/**
+ * Returns the level of slot <slot>.
+ */
+unsigned char endless_level(unsigned int slot){
+    unsigned int level = slot / ENDLESS_LEVEL_SLOTS;
+
+    return level < ENDLESS_LEVELS ? level : ENDLESS_LEVELS - 1;
+}
+
+/**
+ * ChartSource of the generated chart: the length, then the next note, a
+ * second one of a chord or a CHART_SKIP once CHART_MAX_GAP slots in a row
+ * were empty. It never ends.
+ */
+unsigned char endless_next(void){
+    unsigned char level;
+    unsigned char lane;
+    unsigned int gap;
+
+    if(endless_header){
+        endless_header--;
+        return ENDLESS_LENGTH >> (8 * (1 - endless_header)) & 0xFF;   // low byte first
+    }
+    if(endless_chord){
+        lane = endless_chord;
+        endless_chord = 0;
+        return CHART_NOTE(0, lane);
+    }
+    while(endless_slot - endless_last <= CHART_MAX_GAP){
+        level = endless_level(endless_slot);
+        if(endless_bits(8) < ENDLESS_DENSITY + level * ENDLESS_DENSITY_STEP){
+            lane = endless_bits(2);
+            if(level >= ENDLESS_CHORD_LEVEL &&
+               endless_bits(8) < (level - ENDLESS_CHORD_LEVEL + 1) * ENDLESS_CHORD_STEP){
+                endless_chord = ((lane + 1 + endless_bits(1)) & 3) + 1;     // one of the next two lanes
+            }
+            gap = endless_slot - endless_last;
+            endless_last = endless_slot++;
+            return CHART_NOTE(gap, lane + 1);
+        }
+        endless_slot++;
+    }
+    endless_last += CHART_MAX_GAP + 1;
+    return CHART_SKIP;
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void endless_open(ChartReader *r, unsigned int seed){
+    endless_lfsr = seed ? seed : 1;
+    endless_slot = ENDLESS_LEAD_IN;
+    endless_last = 0;
+    endless_header = 2;
+    endless_chord = 0;
+    chart_openSource(r, endless_next);
+}
+
+unsigned int endless_tempo(unsigned int slot){
+    return ENDLESS_PERIOD - endless_level(slot) * ENDLESS_SPEEDUP;
+}
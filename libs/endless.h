@@ -0,0 +1,82 @@
+/***************************************************************************//**
+ * @file    endless.h
+ * @date    19.10.26
+ *
+ * @brief   Endless mode, a chart made up while it is played.
+ *
+ * A 16 bit LFSR started from a seed decides for every slot if it gets a
+ * note and on which lane, so no chart is stored and the same seed always
+ * gives the same chart. Its bytes come through a ChartSource like the ones
+ * of the library (chart.h), each call generates the slots up to the next
+ * note, which the decoder asks for once the note before scrolled onto the
+ * display.
+ *
+ * Every ENDLESS_LEVEL_SLOTS slots the level goes up: more slots get a note,
+ * from ENDLESS_CHORD_LEVEL on some of them a second one, and the tempo
+ * gets ENDLESS_SPEEDUP ms per slot faster. The song has no end, it is over
+ * once the player missed ENDLESS_LIVES times.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_ENDLESS_H_
+#define LIBS_ENDLESS_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include "./songs.h"
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define ENDLESS_LENGTH          0xFFFF      // slots of the chart, more than an hour
+#define ENDLESS_LEAD_IN         16          // slots without notes at the start
+
+#define ENDLESS_LEVEL_SLOTS     64          // slots per level, 4 bars
+#define ENDLESS_LEVELS          16          // the level stays at the last one
+#define ENDLESS_PERIOD          150         // ms per slot on Expert at level 0, Normal is twice as long
+#define ENDLESS_SPEEDUP         4           // ms per slot less each level
+#define ENDLESS_DENSITY         64          // of 256 slots get a note at level 0
+#define ENDLESS_DENSITY_STEP    10          // more each level
+#define ENDLESS_CHORD_LEVEL     4           // first level with chords
+#define ENDLESS_CHORD_STEP      6           // of 256 notes get a second lane each level from there
+
+#define ENDLESS_LIVES           8           // misses until the run is over
+#define ENDLESS_GOOD            200         // Perfect notes in a row of a "Very Good!" run
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+// Tones C4, E4, G4, C5, the tempo and the lives of the mode, the chart is
+// opened with endless_open().
+extern const Song endless_song;
+
+// RAM of the generator, only valid while its chart is played, see shared.h
+typedef struct{
+    unsigned int lfsr;                  // state of the LFSR, never 0
+    unsigned int slot;                  // next slot to generate
+    unsigned int last;                  // slot the gap of the next byte counts from
+    unsigned char header;               // bytes of the length still to give
+    unsigned char chord;                // lane (1 - 4) of a second note of the last slot, 0 for none
+}EndlessRam;
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Start a chart from <seed> in <r>, the next game_start() with endless_song
+ * plays it. A seed of 0 is taken as 1, the LFSR would stay 0.
+ */
+void endless_open(ChartReader *r, unsigned int seed);
+
+/**
+ * Returns the ms per slot on Expert at slot <slot>, the SongTempo of
+ * endless_song.
+ */
+unsigned int endless_tempo(unsigned int slot);
+
+#endif /* LIBS_ENDLESS_H_ */
@@ -0,0 +1,261 @@
+/***************************************************************************//**
+ * @file    game.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the game core.
+ *
+ * A step starts when <into> reaches the period, so the time never has to be
+ * counted from the start of the song and can't overflow on long songs.
+ ******************************************************************************/
+
+#include "./game.h"
+#include <stddef.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+// Text shown for each judgement
+const char *const game_judgeText[] = {
+    [judgePerfect]  = "Perfect",
+    [judgeGreat]    = "Great",
+    [judgeGood]     = "Good",
+    [judgeMiss]     = "Miss",
+};
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+void game_over(Game *g, GameOutput *out);
+void game_miss(Game *g, GameOutput *out);
+void game_decode(Game *g);
+void game_advance(Game *g, GameOutput *out);
+void game_press(Game *g, unsigned char press, GameOutput *out);
+unsigned char game_text(char *line, const char *text);
+unsigned char game_number(char *line, unsigned long number);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+/**
+ * End the song, its score is shown from now on.
+ */
+void game_over(Game *g, GameOutput *out){
+    g->phase = gameScore;
+    out->commands |= gameOver;
+}
+
+/**
+ * Count a miss against the lives of the song, the last one ends it.
+ */
+void game_miss(Game *g, GameOutput *out){
+    if(g->lives && --g->lives == 0 && g->phase == gamePlaying){
+        game_over(g, out);
+    }
+}
+
+/**
+ * Decode the slots up to slot + 16 into lanes, as far as the source of
+ * the chart has the bytes. A slot it has to wait for is decoded on a later
+ * step, it stays empty if it started by then.
+ */
+void game_decode(Game *g){
+    unsigned char mask;
+
+    // by difference, slot + 16 wraps at the end of a chart of 0xFFFF slots
+    while((int)(g->chart.slot - g->slot) <= 16 && (mask = chart_next(&g->chart)) != CHART_WAITING){
+        if(g->chart.slot > g->slot){
+            judge_setLanes(g->chart.slot - 1, mask);    // the slot chart_next() just returned
+        }
+    }
+}
+
+/**
+ * Start the step of the next slot: take the tempo of the song for it,
+ * count the notes which passed unplayed and decode the slot which becomes
+ * visible.
+ */
+void game_advance(Game *g, GameOutput *out){
+    unsigned char missed;
+    unsigned int period;
+    unsigned int length;
+
+    g->slot++;
+    g->feedback = GAME_NO_FEEDBACK;
+    if(g->song->tempo != NULL){
+        period = g->song->tempo(g->slot);
+        period = g->difficulty ? period : period * 2;
+        if(period != g->period){
+            g->period = period;
+            judge_setPeriod(period);
+            out->commands |= gameTempo;
+        }
+    }
+    for(missed = judge_step(g->slot); missed; missed--){
+        g->feedback = judgeMiss;
+        score_event(judgeMiss);
+        game_miss(g, out);
+    }
+    game_decode(g);
+
+    // the end once all slots were on the display, a chart of fewer than 16
+    // slots fits it at once, slot + 16 would wrap for one of nearly 0xFFFF
+    length = chart_length(&g->chart);
+    if(g->phase == gamePlaying && (length < 16 || g->slot > length - 16)){
+        game_over(g, out);
+    }
+    out->commands |= gameDraw;
+}
+
+/**
+ * Judge a press of button <press> at the current time, it plays the tone
+ * of its lane.
+ */
+void game_press(Game *g, unsigned char press, GameOutput *out){
+    g->feedback = judge_press(g->slot, g->into, press - 1);
+    score_event(g->feedback);
+    if(g->feedback == judgeMiss){
+        game_miss(g, out);
+    }
+    out->tone = g->song->tone[press - 1];
+    out->commands |= gameTone | gameDraw;
+}
+
+/**
+ * Copy <text> to <line>, returns its length.
+ */
+unsigned char game_text(char *line, const char *text){
+    unsigned char x = 0;
+
+    while(text[x] && x < GAME_COLUMNS){
+        line[x] = text[x];
+        x++;
+    }
+    return x;
+}
+
+/**
+ * Write the digits of <number> to <line>, returns their number.
+ */
+unsigned char game_number(char *line, unsigned long number){
+    char digits[10];                    // 10 digits of 2^32
+    unsigned char count = 0;
+    unsigned char i;
+
+    do{
+        digits[count++] = '0' + number % 10;
+        number /= 10;
+    }while(number);
+    for(i = 0; i < count; i++){
+        line[i] = digits[count - 1 - i];
+    }
+    return count;
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void game_start(Game *g, const Song *song, unsigned char difficulty){
+    unsigned char i;
+
+    g->song = song;
+    g->difficulty = difficulty;
+    g->phase = gamePlaying;
+    g->feedback = GAME_NO_FEEDBACK;
+    g->period = difficulty ? song->period : song->period * 2;
+    g->lives = song->lives;
+    g->slot = 0;
+    g->into = 0;
+    if(song->chart != NULL){
+        chart_open(&g->chart, song->chart);
+    }
+    for(i = 0; i < sizeof(g->lanes); i++){
+        g->lanes[i] = 0;                // slot -1 and the ones decoded later
+    }
+    judge_start(g->lanes, GAME_LANES_MASK, g->period);
+    game_decode(g);
+    score_reset(difficulty);
+}
+
+void game_step(Game *g, unsigned char press, unsigned int dt, GameOutput *out){
+    g->into += dt;
+
+    // steps which started before now, then the press, then a step starting now
+    while(g->phase == gamePlaying && g->into > g->period){
+        g->into -= g->period;
+        game_advance(g, out);
+    }
+    if(g->phase == gamePlaying && press){
+        game_press(g, press, out);
+    }
+    if(g->phase == gamePlaying && g->into == g->period){
+        g->into = 0;
+        game_advance(g, out);
+    }
+
+    if(g->phase == gameScore && g->into >= GAME_OVER_MS){
+        g->phase = gameDone;
+        out->commands |= gameMenu;
+    }
+}
+
+unsigned int game_next(const Game *g){
+    switch(g->phase){
+        case gamePlaying:
+            return g->period - g->into;
+        case gameScore:
+            return g->into < GAME_OVER_MS ? GAME_OVER_MS - g->into : 0;
+    }
+    return 0;
+}
+
+void game_frame(const Game *g, char lines[2][GAME_COLUMNS]){
+    unsigned char x;
+
+    for(x = 0; x < GAME_COLUMNS; x++){
+        lines[0][x] = ' ';
+        lines[1][x] = ' ';
+    }
+
+    if(g->phase != gamePlaying){
+        x = game_text(lines[0], "Score: ");
+        game_number(&lines[0][x], score_total());
+        // thresholds of the message depend on song and difficulty
+        if(score_total() == g->song->perfect[g->difficulty]){
+            game_text(lines[1], "Perfect!");
+        }
+        else if(score_total() > g->song->good[g->difficulty]){
+            game_text(lines[1], "Very Good!");
+        }
+        else{
+            game_text(lines[1], "Practice more!");
+        }
+        return;
+    }
+
+    if(g->feedback != GAME_NO_FEEDBACK){
+        game_text(lines[0], game_judgeText[g->feedback]);
+    }
+    if(score_multiplier() > 1){
+        lines[0][14] = 'x';             // multiplier in the upper right corner
+        lines[0][15] = '0' + score_multiplier();
+    }
+
+    // the 16 slots from the running one on, of a chord only the lowest lane
+    for(x = 0; x < GAME_COLUMNS; x++){
+        unsigned char mask = judge_lanes(g->slot + x);
+        unsigned char lane = '1';
+
+        if(!mask){
+            continue;
+        }
+        while(!(mask & 1)){
+            mask >>= 1;
+            lane++;
+        }
+        lines[1][x] = lane;
+    }
+}
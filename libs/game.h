@@ -0,0 +1,110 @@
+/***************************************************************************//**
+ * @file    game.h
+ * @date    19.10.26
+ *
+ * @brief   Rules of a song as a core without any hardware access.
+ *
+ * game_step() moves a Game on by the ms since the last call and takes the
+ * press of that moment. It doesn't draw, play or store anything itself but
+ * collects commands in a GameOutput, which the caller executes:
+ *
+ *      gameDraw    draw the frame of game_frame()
+ *      gameTone    play the tone of the press, GameOutput.tone
+ *      gameOver    the song ended, its score is shown now
+ *      gameMenu    the score was shown GAME_OVER_MS, back to the menu
+ *      gameTempo   the period changed, the next step is game_next() away
+ *
+ * The commands are OR'ed into the output, so the ones of several steps can
+ * be collected and executed at once. The same core runs in main.c and in
+ * the host tests. The judgement and the score are kept by judge.c and
+ * score.c, so only one song can be played at a time.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_GAME_H_
+#define LIBS_GAME_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include "./songs.h"
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define GAME_COLUMNS            16      // cells of a line of game_frame(), the display is as wide
+#define GAME_LANES_MASK         31      // slot n of the song is stored in lanes[(n & GAME_LANES_MASK) / 2], see judge.h
+#define GAME_OVER_MS            3000    // how long the score is shown
+#define GAME_NO_FEEDBACK        0xFF    // Game.feedback if no judgement is shown
+
+enum GameCommand{
+    gameDraw    = 0x01,
+    gameTone    = 0x02,
+    gameOver    = 0x04,
+    gameMenu    = 0x10,
+    gameTempo   = 0x20,
+};
+
+enum GamePhase{
+    gamePlaying,
+    gameScore,                          // the score is shown
+    gameDone,                           // gameMenu was given
+};
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+typedef struct{
+    const Song *song;
+    unsigned char difficulty;           // 0 Normal, 1 Expert
+    unsigned char phase;                // enum GamePhase
+    unsigned char feedback;             // enum Judgement of the last note, or GAME_NO_FEEDBACK
+    unsigned char lives;                // misses left until the song ends, 0 if it has no lives
+    unsigned int period;                // ms of one step, Normal is twice as long as song->period or song->tempo
+    unsigned int slot;                  // first slot on the display, its step is running
+    unsigned int into;                  // ms since that step started, or since the score is shown
+    ChartReader chart;                  // its next slot is slot + 17 unless its source had to wait
+    unsigned char lanes[(GAME_LANES_MASK + 1) / 2]; // lane masks of the slots slot - 1, ..., slot + 16,
+                                                    // two per byte, so nothing has to be moved
+}Game;
+
+typedef struct{
+    unsigned char commands;             // enum GameCommand
+    unsigned int tone;                  // frequency for gameTone
+}GameOutput;
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Start <song> on <difficulty> (0 Normal, 1 Expert) and reset the score.
+ * If song->chart is NULL, g->chart has to be opened before, e.g. with
+ * library_open().
+ */
+void game_start(Game *g, const Song *song, unsigned char difficulty);
+
+/**
+ * Let <dt> ms pass and then handle <press> (button 1 - 4, 0 for none).
+ * A press is judged before a step which starts at the same ms. Commands
+ * are added to <out>.
+ */
+void game_step(Game *g, unsigned char press, unsigned int dt, GameOutput *out);
+
+/**
+ * Returns the ms until game_step() has something to do without a press,
+ * 0 once the game is done.
+ */
+unsigned int game_next(const Game *g);
+
+/**
+ * Write the GAME_COLUMNS cells of both lines of the display to <lines>:
+ * the judgement of the last note and the multiplier above the notes while
+ * playing, the score and a message at the end.
+ */
+void game_frame(const Game *g, char lines[2][GAME_COLUMNS]);
+
+#endif /* LIBS_GAME_H_ */
@@ -0,0 +1,33 @@
+/***************************************************************************//**
+ * @file    hal.c
+ * @date    19.10.26
+ *
+ * @brief   Trace backend of hal.h, nothing is built without HAL_TRACE.
+ *
+ ******************************************************************************/
+
+#include "./hal.h"
+
+#ifdef HAL_TRACE
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+HalRecord hal_records[HAL_TRACE_SIZE];
+unsigned int hal_count = 0;
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void hal_trace(unsigned char access, unsigned char port, unsigned char mask){
+    HalRecord *r = &hal_records[hal_count & (HAL_TRACE_SIZE - 1)];
+
+    r->access = access;
+    r->port = port;
+    r->mask = mask;
+    hal_count++;
+}
+
+#endif /* HAL_TRACE */
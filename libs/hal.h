@@ -0,0 +1,109 @@
+/***************************************************************************//**
+ * @file    hal.h
+ * @date    19.10.26
+ *
+ * @brief   Access to the pins of board.h, with the backend chosen at build time.
+ *
+ *      HAL_OUTPUT(pin)     make the pin an output
+ *      HAL_HIGH(pin)       drive it high
+ *      HAL_LOW(pin)        drive it low
+ *      HAL_READ(pin)       its input, the mask of the pin if it is high
+ *      HAL_PERIPHERAL(pin) give it to the primary peripheral (PxSEL)
+ *      HAL_SECONDARY(pin)  give it to the secondary peripheral (PxSEL and PxSEL2)
+ *      HAL_GPIO(pin)       back to a port pin
+ *
+ * Backends:
+ *
+ *      default             the registers, each macro is the one instruction
+ *                          the driver wrote by hand before (e.g. bis.b)
+ *      host simulation     the same, compiled against sim/msp430g2553.h
+ *                          whose registers are simulated, see sim/sim.h
+ *      HAL_TRACE           defined: every access is also given to
+ *                          hal_trace() before it is made, tests/hal_test.c
+ *                          checks the accesses of shift.c with it
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_HAL_H_
+#define LIBS_HAL_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include "./board.h"
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define HAL_TRACE_SIZE          64      // records kept by hal_trace(), a power of 2
+
+enum HalAccess{
+    halOutput,
+    halHigh,
+    halLow,
+    halRead,
+    halPeripheral,
+    halSecondary,
+    halGpio,
+};
+
+// The pin macros expand board.h's "port, mask" first, the second level
+// gets them as two arguments.
+#define HAL_MASK(pin)           HAL_MASK_(pin)
+#define HAL_OUTPUT(pin)         HAL_OUTPUT_(pin)
+#define HAL_HIGH(pin)           HAL_HIGH_(pin)
+#define HAL_LOW(pin)            HAL_LOW_(pin)
+#define HAL_READ(pin)           HAL_READ_(pin)
+#define HAL_PERIPHERAL(pin)     HAL_PERIPHERAL_(pin)
+#define HAL_SECONDARY(pin)      HAL_SECONDARY_(pin)
+#define HAL_GPIO(pin)           HAL_GPIO_(pin)
+
+#define HAL_MASK_(port, mask)           (mask)
+#define HAL_OUTPUT_(port, mask)         HAL_ACCESS(halOutput, port, mask, P##port##DIR |= (mask))
+#define HAL_HIGH_(port, mask)           HAL_ACCESS(halHigh, port, mask, P##port##OUT |= (mask))
+#define HAL_LOW_(port, mask)            HAL_ACCESS(halLow, port, mask, P##port##OUT &= ~(mask))
+#define HAL_READ_(port, mask)           HAL_ACCESS(halRead, port, mask, P##port##IN & (mask))
+#define HAL_PERIPHERAL_(port, mask)     HAL_ACCESS(halPeripheral, port, mask, P##port##SEL |= (mask))
+#define HAL_SECONDARY_(port, mask)      HAL_ACCESS(halSecondary, port, mask, (P##port##SEL |= (mask), P##port##SEL2 |= (mask)))
+#define HAL_GPIO_(port, mask)           HAL_ACCESS(halGpio, port, mask, (P##port##SEL &= ~(mask), P##port##SEL2 &= ~(mask)))
+
+#ifdef HAL_TRACE
+#define HAL_ACCESS(access, port, mask, code)    (hal_trace((access), (port), (mask)), (code))
+#else
+#define HAL_ACCESS(access, port, mask, code)    (code)
+#endif
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+#ifdef HAL_TRACE
+
+// One pin access, see hal_trace()
+typedef struct{
+    unsigned char access;               // enum HalAccess
+    unsigned char port;
+    unsigned char mask;
+}HalRecord;
+
+extern HalRecord hal_records[HAL_TRACE_SIZE];
+extern unsigned int hal_count;          // accesses so far, the last HAL_TRACE_SIZE are in hal_records
+
+#endif /* HAL_TRACE */
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+#ifdef HAL_TRACE
+
+/**
+ * Record a pin access in hal_records[hal_count % HAL_TRACE_SIZE].
+ */
+void hal_trace(unsigned char access, unsigned char port, unsigned char mask);
+
+#endif /* HAL_TRACE */
+
+#endif /* LIBS_HAL_H_ */
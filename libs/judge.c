@@ -0,0 +1,119 @@
+/***************************************************************************//**
+ * @file    judge.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the time based judgement.
+ *
+ * All times are counted in ms relative to the start of a step, so only
+ * small signed numbers are needed even for very long songs.
+ ******************************************************************************/
+
+#include "./judge.h"
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+const JudgeWindows judge_windows = {
+    .perfect = 40,
+    .great = 80,
+    .good = 120,
+};
+
+unsigned char *judge_ring;              // ring of lane masks, two slots per byte, see judge_start()
+unsigned char judge_mask;               // slot n is in judge_ring[(n & judge_mask) >> 1]
+unsigned int judge_period;              // length of one step in ms
+unsigned int judge_checked;             // first slot not checked for unplayed notes yet
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void judge_start(unsigned char *lanes, unsigned char mask, unsigned int period){
+    judge_ring = lanes;
+    judge_mask = mask;
+    judge_period = period;
+    judge_checked = 0;
+}
+
+void judge_setPeriod(unsigned int period){
+    judge_period = period;
+}
+
+unsigned char judge_lanes(unsigned int slot){
+    unsigned char lanes = judge_ring[(slot & judge_mask) >> 1];
+
+    return slot & 1 ? lanes >> 4 : lanes & 0x0F;
+}
+
+void judge_setLanes(unsigned int slot, unsigned char mask){
+    unsigned char *lanes = &judge_ring[(slot & judge_mask) >> 1];
+
+    *lanes = slot & 1 ? (*lanes & 0x0F) | mask << 4 : (*lanes & 0xF0) | mask;
+}
+
+unsigned char judge_press(unsigned int slot, unsigned int into, unsigned char lane){
+    unsigned char bit = 1 << lane;
+    unsigned char reach = judge_windows.good / judge_period + 1;    // slots to look at before and after
+    unsigned int best = judge_windows.good + 1;                     // distance to the nearest note, above good for none
+    unsigned int at = slot - reach;                                 // slot looked at
+    unsigned int hit = at;                                          // the one of best
+    unsigned int away;
+    int distance;
+
+    // the note is in the middle of its step
+    distance = (int)(judge_period / 2) - (int)into - reach * (int)judge_period;
+    for(; at != slot + reach + 1; at++, distance += judge_period){
+        // don't look at slots before the song or ones already counted as unplayed
+        if((int)(at - judge_checked) < 0 || !(judge_lanes(at) & bit)){
+            continue;
+        }
+        away = distance < 0 ? -distance : distance;
+        if(away < best){
+            best = away;
+            hit = at;
+        }
+    }
+
+    if(best > judge_windows.good){
+        return judgeMiss;                       // no note of this lane near the press
+    }
+    judge_setLanes(hit, judge_lanes(hit) & ~bit);
+    if(best <= judge_windows.perfect){
+        return judgePerfect;
+    }
+    if(best <= judge_windows.great){
+        return judgeGreat;
+    }
+    return judgeGood;
+}
+
+unsigned char judge_step(unsigned int slot){
+    unsigned char missed = 0;
+    unsigned char mask;
+
+    // a slot is closed once the middle of its step is more than good ago
+    while(judge_checked < slot &&
+          (slot - judge_checked) * judge_period >= judge_period / 2 + judge_windows.good){
+        mask = judge_lanes(judge_checked);
+        while(mask){
+            missed += mask & 1;
+            mask >>= 1;
+        }
+        judge_setLanes(judge_checked, 0);
+        judge_checked++;
+    }
+    return missed;
+}
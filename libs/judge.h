@@ -0,0 +1,91 @@
+/***************************************************************************//**
+ * @file    judge.h
+ * @date    19.10.26
+ *
+ * @brief   Judges button presses by their time distance to the notes.
+ *
+ * The notes are taken from a ring of lane masks (bit 0 is lane 1). A mask
+ * only takes 4 bits, so a byte of the ring holds two slots: slot n of the
+ * song is in lanes[(n & mask) / 2], the low nibble if n is even. A slot is
+ * played during its step of one period and its note time is the middle of
+ * that step. Notes which were hit are removed from the ring, so they can't
+ * be hit twice.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_JUDGE_H_
+#define LIBS_JUDGE_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+enum Judgement{
+    judgePerfect,
+    judgeGreat,
+    judgeGood,
+    judgeMiss,
+};
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+// Largest distance in ms between press and note for each judgement.
+// A press further away than good from every note is a miss.
+typedef struct{
+    unsigned int perfect;
+    unsigned int great;
+    unsigned int good;
+}JudgeWindows;
+
+extern const JudgeWindows judge_windows;    // in judge.c
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Start judging a song with the given ring of (mask + 1) / 2 bytes and the
+ * length of one step in ms. The window judge_windows.good has to be shorter
+ * than the slots the ring holds before the current one.
+ */
+void judge_start(unsigned char *lanes, unsigned char mask, unsigned int period);
+
+/**
+ * Returns the lane mask of slot <slot> in the ring.
+ */
+unsigned char judge_lanes(unsigned int slot);
+
+/**
+ * Puts lane mask <mask> (0 - 15) of slot <slot> into the ring.
+ */
+void judge_setLanes(unsigned int slot, unsigned char mask);
+
+/**
+ * Change the length of one step to <period> ms from the current step on.
+ * The notes around it are measured with the new period too, so a change
+ * should only be a few ms.
+ */
+void judge_setPeriod(unsigned int period);
+
+/**
+ * Judge a press of <lane> (0 - 3) made <into> ms after the start of the
+ * step of slot <slot>. The nearest note of that lane is removed if it was hit.
+ * Returns the enum Judgement.
+ */
+unsigned char judge_press(unsigned int slot, unsigned int into, unsigned char lane);
+
+/**
+ * Call at the start of the step of slot <slot>. Returns the number of notes
+ * which left the good window since the last call without being hit.
+ */
+unsigned char judge_step(unsigned int slot);
+
+#endif /* LIBS_JUDGE_H_ */
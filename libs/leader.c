@@ -0,0 +1,294 @@
+/***************************************************************************//**
+ * @file    leader.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the leaderboards.
+ *
+ * leader_dirty has a bit for every board which has to be appended. The
+ * board in RAM is written as it is, every other one can only have been
+ * cleared by leader_reset() and is written empty. That's why no other
+ * board is loaded while one is dirty.
+ *
+ * The slots of a board are numbered on from its log into its copies:
+ * slot LEADER_SLOTS + n is copy n in sector LEADER_SPARE.
+ ******************************************************************************/
+
+#include "./leader.h"
+#include "./shared.h"
+#include "./flash.h"
+#include "./uart.h"
+#include "./trace.h"
+#include <stddef.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define LEADER_LOG              0                       // first slot of the log of a board
+#define LEADER_COPY             LEADER_SLOTS            // first slot of its copies
+
+enum LeaderState{
+    leaderIdle,
+    leaderErasing,                          // the sector of leader_slot is erased
+    leaderBody,                             // claim, count and entries are programmed
+    leaderCrc,                              // the CRC is programmed
+};
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+#define leader_data             (shared.leader) // the board in RAM of the menu
+unsigned char leader_loaded = LEADER_NONE;  // its number
+unsigned int leader_next;                   // first free slot of its log
+
+unsigned char leader_dirty = 0;             // bit n: board n has to be appended
+unsigned char leader_state = leaderIdle;    // enum LeaderState
+unsigned char leader_writing;               // board being appended
+unsigned int leader_slot;                   // slot it goes to, one of the copies first if its log is full
+unsigned char leader_crc;                   // CRC of the slot, programmed last
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+long int leader_address(unsigned char board, unsigned int slot);
+unsigned char leader_sum(const LeaderBoard *b);
+unsigned int leader_find(unsigned char board, unsigned int first, unsigned int count);
+unsigned char leader_last(unsigned char board, unsigned int first, unsigned int next);
+void leader_program(void);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+/**
+ * Returns the flash address of <slot> of <board>, in its log or its copies.
+ */
+long int leader_address(unsigned char board, unsigned int slot){
+    if(slot >= LEADER_COPY){
+        slot += board * LEADER_COPIES - LEADER_COPY;
+        return ((long int)LEADER_SPARE << 16) + (long int)slot * LEADER_SLOT;
+    }
+    return ((long int)(LEADER_SECTOR + board) << 16) + (long int)slot * LEADER_SLOT;
+}
+
+/**
+ * Returns the CRC of the count and the used entries of <b>. 0xFF is the
+ * value of a CRC which was never programmed, so it is taken as 0.
+ */
+unsigned char leader_sum(const LeaderBoard *b){
+    const unsigned char *bytes = (const unsigned char *)b->entries;
+    unsigned int length = b->count * sizeof(LeaderEntry);
+    unsigned char crc = uart_crc8(0, b->count);
+    unsigned int i;
+
+    for(i = 0; i < length; i++){
+        crc = uart_crc8(crc, bytes[i]);
+    }
+    return crc == 0xFF ? 0 : crc;
+}
+
+/**
+ * Returns the first free one of the <count> slots of <board> from <first>
+ * on, first + count if all are taken. Binary search on the claim bytes, as
+ * the taken slots are the first ones.
+ */
+unsigned int leader_find(unsigned char board, unsigned int first, unsigned int count){
+    unsigned char claim[2];                 // flash_read() reads one dummy byte first
+    unsigned int low = first;
+    unsigned int high = first + count;
+    unsigned int middle;
+
+    while(low < high){
+        middle = (low + high) / 2;
+        flash_read(leader_address(board, middle), 1, claim);
+        if(claim[1] == LEADER_CLAIM){
+            low = middle + 1;
+        }
+        else{
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/**
+ * Read the last complete one of the slots of <board> from <first> to the
+ * free slot <next> into leader_data, each in one burst. Only the last two
+ * are tried, one cut off by a power failure and the one before it.
+ * Returns 1 if one was complete.
+ */
+unsigned char leader_last(unsigned char board, unsigned int first, unsigned int next){
+    unsigned int slot;
+
+    for(slot = next; slot > first && slot + 2 > next; slot--){
+        flash_read(leader_address(board, slot - 1), sizeof(LeaderBoard) - 1, &leader_data.dummy);
+        if(leader_data.claim == LEADER_CLAIM && leader_data.count <= LEADER_SIZE &&
+           leader_data.crc == leader_sum(&leader_data)){
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Program claim, count and entries of board leader_writing to leader_slot.
+ * The CRC is left erased and programmed in the next step.
+ */
+void leader_program(void){
+    unsigned char empty[2] = {LEADER_CLAIM, 0};
+    long int address = leader_address(leader_writing, leader_slot);
+
+    leader_dirty &= ~(1 << leader_writing);     // later changes need the next slot
+    if(leader_writing == leader_loaded){
+        leader_data.claim = LEADER_CLAIM;
+        leader_data.crc = 0xFF;                 // programming 0xFF leaves the byte erased
+        leader_crc = leader_sum(&leader_data);
+        flash_program(address, 3 + leader_data.count * sizeof(LeaderEntry), &leader_data.claim);
+    }
+    else{
+        leader_crc = uart_crc8(0, 0);
+        flash_program(address, sizeof(empty), empty);
+    }
+    leader_state = leaderBody;
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+unsigned char leader_load(unsigned char board){
+    unsigned char started;
+
+    if(board == leader_loaded){
+        return 1;
+    }
+    if(leader_pending()){
+        return 0;
+    }
+    leader_loaded = board;
+    started = leader_find(board, LEADER_LOG, 1);   // 1 if slot 0 is taken
+    leader_next = leader_find(board, LEADER_LOG, LEADER_SLOTS);
+    if(started && leader_last(board, LEADER_LOG, leader_next)){
+        return 1;
+    }
+
+    // the power failed while the log was erased for its copy or before its
+    // slot 0 was complete, the log is started again from the copy
+    if((!started || leader_next == 1) &&
+       leader_last(board, LEADER_COPY, leader_find(board, LEADER_COPY, LEADER_COPIES))){
+        leader_next = LEADER_SLOTS;
+        leader_dirty |= 1 << board;
+        return 1;
+    }
+    leader_data.count = 0;
+    return 1;
+}
+
+unsigned char leader_board(void){
+    return leader_loaded;
+}
+
+const LeaderEntry *leader_entry(unsigned char rank){
+    if(leader_loaded == LEADER_NONE || rank >= leader_data.count){
+        return NULL;
+    }
+    return &leader_data.entries[rank];
+}
+
+unsigned char leader_insert(const LeaderEntry *entry){
+    unsigned char i = leader_data.count;
+
+    if(leader_loaded == LEADER_NONE){
+        return 0;
+    }
+    if(i == LEADER_SIZE){
+        if(entry->score <= leader_data.entries[LEADER_SIZE - 1].score){
+            return 0;
+        }
+        i--;                                    // the last one drops out
+    }
+    else{
+        leader_data.count++;
+    }
+
+    // move the lower ones down until its place is found
+    while(i > 0 && leader_data.entries[i - 1].score < entry->score){
+        leader_data.entries[i] = leader_data.entries[i - 1];
+        i--;
+    }
+    leader_data.entries[i] = *entry;
+    leader_dirty |= 1 << leader_loaded;
+    return i + 1;
+}
+
+void leader_reset(void){
+    leader_loaded = LEADER_NONE;                // every board is written empty
+    leader_dirty = (1 << LEADER_BOARDS) - 1;
+}
+
+void leader_forget(void){
+    leader_loaded = LEADER_NONE;
+}
+
+unsigned char leader_poll(void){
+    unsigned char board;
+
+    if(leader_state != leaderIdle && flash_busy()){
+        return 1;
+    }
+    switch(leader_state){
+        case leaderIdle:
+            if(!leader_dirty){
+                return 0;
+            }
+            for(board = 0; !(leader_dirty & (1 << board)); board++);
+            leader_writing = board;
+            leader_slot = board == leader_loaded ? leader_next : leader_find(board, LEADER_LOG, LEADER_SLOTS);
+            if(leader_slot == LEADER_SLOTS){
+                // the log is full, a copy of the board first
+                leader_slot = leader_find(board, LEADER_COPY, LEADER_COPIES);
+            }
+            if(leader_slot < LEADER_COPY + LEADER_COPIES){
+                leader_program();
+            }
+            else{
+                // the copies are used up, the logs hold their boards
+                flash_erase(leader_address(board, LEADER_COPY));
+                leader_slot = LEADER_COPY;
+                leader_state = leaderErasing;
+            }
+            break;
+        case leaderErasing:
+            leader_program();
+            break;
+        case leaderBody:
+            flash_program(leader_address(leader_writing, leader_slot) + 2, 1, &leader_crc);
+            leader_state = leaderCrc;
+            break;
+        case leaderCrc:
+            if(leader_slot >= LEADER_COPY){
+                // the copy is complete, start the log again
+                flash_erase(leader_address(leader_writing, LEADER_LOG));
+                leader_slot = LEADER_LOG;
+                leader_state = leaderErasing;
+                break;
+            }
+            if(leader_writing == leader_loaded){
+                leader_next = leader_slot + 1;
+            }
+            leader_state = leaderIdle;
+            TRACE(traceLeader, leader_writing);
+            return leader_dirty != 0;
+    }
+    return 1;
+}
+
+unsigned char leader_busy(void){
+    return leader_state != leaderIdle;
+}
+
+unsigned char leader_pending(void){
+    return leader_dirty || leader_state != leaderIdle;
+}
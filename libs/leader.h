@@ -0,0 +1,147 @@
+/***************************************************************************//**
+ * @file    leader.h
+ * @date    19.10.26
+ *
+ * @brief   Leaderboards of the songs in the SPI flash, the best LEADER_SIZE
+ *          players of each song and difficulty.
+ *
+ * Each board has its own sector, LEADER_SECTOR + board, used as a log of
+ * LEADER_SLOTS slots. A change appends the whole board to the next free
+ * slot, so the sector is only erased once all its slots were used:
+ *
+ *      0x00        claim, LEADER_CLAIM once the slot is taken
+ *      0x01        count of entries
+ *      0x02        CRC-8 of count and entries, programmed last
+ *      0x03        the entries, see LeaderBoard
+ *
+ * The taken slots are always the first ones of a sector, so the end of the
+ * log is found with a binary search on the claim bytes. The last slot is
+ * then read in one burst. A slot whose CRC doesn't match was cut off by a
+ * power failure, the one before it is taken instead.
+ *
+ * A full log is never erased while it holds the only copy of its board.
+ * The board is first appended to its LEADER_COPIES slots in sector
+ * LEADER_SPARE, then its sector is erased and the board programmed to slot
+ * 0 again. If the power fails in between, slot 0 of the sector isn't
+ * complete. The board is then read from its last copy when it is loaded
+ * next, and its log is started again like a full one. The spare sector is
+ * erased once the copies of one board are used up, after LEADER_COPIES *
+ * LEADER_SLOTS changes of it; a board which waits for its copy since a
+ * power failure and wasn't loaded in all that time is lost then.
+ *
+ * Only one board is kept in RAM, in the one of the menu (shared.h). It is
+ * loaded when it is shown, a song on it starts or ends, not at boot.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_LEADER_H_
+#define LIBS_LEADER_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include "./songs.h"
+#include <stdint.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define LEADER_SIZE             4           // entries of a board
+#define LEADER_BOARDS           ((SONG_COUNT + 1) * 2)  // the songs and the endless mode
+#define LEADER_SECTOR           18          // sector of board 0, after the record copies of store.h
+#define LEADER_SLOT             128         // bytes of a slot, a LeaderBoard fits
+#define LEADER_SLOTS            (0x10000UL / LEADER_SLOT)
+#define LEADER_SPARE            28          // sector of the copies of full logs, after the recordings of recorder.h
+#define LEADER_COPIES           (LEADER_SLOTS / LEADER_BOARDS)  // slots of each board in it
+#define LEADER_CLAIM            0x4C        // "L", the slot is taken
+#define LEADER_NONE             0xFF        // no board loaded
+
+// Board of song <song> (index of songs[]) on <difficulty> (0 Normal, 1 Expert)
+#define LEADER_BOARD(song, difficulty)  ((song) * 2 + (difficulty))
+#define LEADER_ENDLESS          SONG_COUNT  // <song> of the boards of the endless mode
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+// Fields are fixed wide where int is wider too (host build)
+typedef struct{
+    uint32_t score;
+    char name[4];                   // player name, not 0 terminated
+    uint16_t replay;                // slot of the recording of the play, see recorder.h
+    uint16_t seed;                  // of the endless chart, 0 for the songs, see endless.h
+    uint8_t accuracy;               // in percent, see score_accuracy()
+}LeaderEntry;
+
+// A board in RAM, the bytes from claim on are the ones of its slot
+typedef struct{
+    uint8_t dummy;                  // flash_read() reads one byte before the slot
+    uint8_t claim;                  // LEADER_CLAIM
+    uint8_t count;                  // entries used, the best first
+    uint8_t crc;
+    LeaderEntry entries[LEADER_SIZE];
+}LeaderBoard;
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Read board <board> into RAM unless it is there already. The flash has to
+ * be selected. Returns 1 if the board is in RAM, 0 if it can't be read now
+ * because a change still has to be written (see leader_pending()).
+ */
+unsigned char leader_load(unsigned char board);
+
+/**
+ * Returns the board in RAM, LEADER_NONE if none was loaded yet.
+ */
+unsigned char leader_board(void);
+
+/**
+ * Returns the entry of rank <rank> (0 is the best) of the board in RAM,
+ * NULL if there is none.
+ */
+const LeaderEntry *leader_entry(unsigned char rank);
+
+/**
+ * Put <entry> on the board in RAM, below the ones with the same score.
+ * O(LEADER_SIZE). The board is written by leader_poll().
+ * Returns the rank it got (1 is the best), 0 if it was too low.
+ */
+unsigned char leader_insert(const LeaderEntry *entry);
+
+/**
+ * Clear all boards, they are written by leader_poll(). The board in RAM
+ * is forgotten, it is read again once they are.
+ */
+void leader_reset(void);
+
+/**
+ * Forget the board in RAM, a mode of shared.h takes its RAM. Nothing may
+ * be pending (see leader_pending()).
+ */
+void leader_forget(void);
+
+/**
+ * Append the changed boards to their logs, one step per call: program a
+ * slot, then its CRC, or erase a sector. A board whose log is full takes
+ * the steps for its copy first. Never waits for the flash. The flash has
+ * to be selected.
+ * Returns 1 while there is something to write, 0 once everything is.
+ */
+unsigned char leader_poll(void);
+
+/**
+ * Returns 1 while a step of leader_poll() waits for the flash.
+ */
+unsigned char leader_busy(void);
+
+/**
+ * Returns 1 if a board changed and isn't written completely yet.
+ */
+unsigned char leader_pending(void);
+
+#endif /* LIBS_LEADER_H_ */
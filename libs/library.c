@@ -0,0 +1,135 @@
+/***************************************************************************//**
+ * @file    library.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the song library in the SPI flash.
+ *
+ * Only one chart of the flash is decoded at a time, its read position
+ * and the ring of bytes read ahead are kept here. library_prefetch()
+ * writes library_head, the decoder reads at library_tail, both only
+ * count up and are masked on access.
+ ******************************************************************************/
+
+#include "./library.h"
+#include "./flash.h"
+#include "./shared.h"
+#include <stddef.h>
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+long int library_address;               // next byte of the open chart to read into the ring
+unsigned int library_left = 0;          // bytes of the open chart not read yet
+#define library_ring            (shared.play.chart.flash.library)   // RAM of the mode
+unsigned char library_head = 0;         // next byte written by library_prefetch()
+unsigned char library_tail = 0;         // next byte taken by the decoder
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+unsigned char library_next(void);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+/**
+ * ChartSource of the open chart. If the prefetch fell behind, e.g. while
+ * the flash programs a chunk of a recording, it gives CHART_WAIT and the
+ * game asks again on its next step. The flash isn't read from here, that
+ * would put the frames of the whole read on top of the deepest call chain
+ * of the game. A chart without CHART_END ends with its last byte.
+ */
+unsigned char library_next(void){
+    if(library_head == library_tail){
+        return library_left ? CHART_WAIT : CHART_END;
+    }
+    return library_ring[library_tail++ & (LIBRARY_RING - 1)];
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+unsigned int library_scan(void){
+    unsigned char buffer[3];
+    unsigned int present = 0;
+    unsigned char slot;
+
+    for(slot = 0; slot < LIBRARY_SLOTS; slot++){
+        flash_read(LIBRARY_ADDRESS(slot), 2, buffer);
+        if((buffer[1] | (buffer[2] << 8)) == LIBRARY_MAGIC){
+            present |= 1 << slot;
+        }
+    }
+    return present;
+}
+
+unsigned char library_header(unsigned char slot, LibraryHeader *header){
+    unsigned char buffer[sizeof(LibraryHeader) + 1];
+    unsigned char *bytes = (unsigned char *)header;
+    unsigned char i;
+
+    flash_read(LIBRARY_ADDRESS(slot), sizeof(LibraryHeader), buffer);
+    for(i = 0; i < sizeof(LibraryHeader); i++){
+        bytes[i] = buffer[i + 1];
+    }
+    return header->magic == LIBRARY_MAGIC;
+}
+
+void library_name(unsigned char slot, unsigned char *name){
+    flash_read(LIBRARY_ADDRESS(slot) + offsetof(LibraryHeader, name), LIBRARY_NAME, name);
+}
+
+void library_song(const LibraryHeader *header, Song *song){
+    unsigned long multiplied = SCORE_MULTIPLIED(header->notes);
+    unsigned char i;
+
+    song->chart = NULL;
+    song->size = header->size;
+    song->notes = header->notes;
+    song->period = header->period;
+    song->tempo = NULL;
+    song->lives = 0;
+    for(i = 0; i < 4; i++){
+        song->tone[i] = header->tone[i];
+    }
+    song->perfect[0] = multiplied * SCORE_PERFECT_NORMAL;
+    song->perfect[1] = multiplied * SCORE_PERFECT_EXPERT;
+    song->good[0] = song->perfect[0] * 4 / 5;
+    song->good[1] = song->perfect[1] * 4 / 5;
+}
+
+void library_open(ChartReader *r, unsigned char slot, unsigned int size){
+    library_address = LIBRARY_ADDRESS(slot) + LIBRARY_CHART;
+    library_left = size;
+    library_head = 0;
+    library_tail = 0;
+    while(library_prefetch());
+    chart_openSource(r, library_next);
+}
+
+unsigned char library_prefetch(void){
+    unsigned char buffer[LIBRARY_BLOCK + 1];        // flash_read() reads one dummy byte first
+    unsigned char count = LIBRARY_RING - (unsigned char)(library_head - library_tail);
+    unsigned char i;
+
+    if(count > LIBRARY_BLOCK){
+        count = LIBRARY_BLOCK;
+    }
+    if(count > library_left){
+        count = library_left;
+    }
+    if(count == 0 || flash_busy()){
+        return 0;                                   // full, at the end or a recording is programmed
+    }
+    flash_read(library_address, count, buffer);
+    for(i = 0; i < count; i++){
+        library_ring[library_head++ & (LIBRARY_RING - 1)] = buffer[i + 1];
+    }
+    library_address += count;
+    library_left -= count;
+    return count;
+}
@@ -0,0 +1,107 @@
+/***************************************************************************//**
+ * @file    library.h
+ * @date    19.10.26
+ *
+ * @brief   Songs stored in the SPI flash, uploaded by the loader.
+ *
+ * Sectors 0 and 17 of the flash hold the two copies of the settings (see
+ * store.h), the leaderboards follow from sector 18 (see leader.h), the
+ * recordings of the plays are in sectors 26 and 27 (see recorder.h) and the
+ * copies of the leaderboards in sector 28. Sectors 1 - LIBRARY_SLOTS hold
+ * one song each (a sector is 64 KB, the smallest part to erase):
+ *
+ *      0x000       LibraryHeader, magic is written last by the loader,
+ *                  so an unfinished upload never counts as song
+ *      0x100       the packed chart (see chart.h), header.size bytes
+ *
+ * The open chart is read ahead into a small RAM ring by library_prefetch(),
+ * which the game calls from the scheduler, so decoding a slot takes the
+ * bytes from RAM and never waits for the SPI.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_LIBRARY_H_
+#define LIBS_LIBRARY_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include "./chart.h"
+#include "./songs.h"
+#include <stdint.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define LIBRARY_SLOTS           16          // songs in the flash, sectors 1 - 16
+#define LIBRARY_MAGIC           0x4643      // "CF", marks a complete song
+#define LIBRARY_NAME            12          // chars of a song name, not 0 terminated if full
+#define LIBRARY_CHART           0x100       // offset of the chart in the sector
+#define LIBRARY_MAX_SIZE        0xFF00      // longest chart in bytes
+
+#define LIBRARY_RING            8           // bytes read ahead of the decoder, power of 2
+#define LIBRARY_BLOCK           8           // most bytes read from the flash at once
+
+#define LIBRARY_ADDRESS(slot)   ((long int)((slot) + 1) << 16)
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+// Start of a song sector, all numbers little endian like the MSP430.
+// Fields are 16 bit wide where int is wider too (host build), the layout is
+// the one tools/chart_upload.py packs.
+typedef struct{
+    uint16_t magic;                 // LIBRARY_MAGIC
+    uint16_t size;                  // bytes of the chart
+    uint16_t notes;                 // number of notes of the chart
+    uint16_t period;                // ms per slot on Expert, Normal is twice as long
+    uint16_t tone[4];               // value for playNotes() for lane 1 - 4
+    char name[LIBRARY_NAME];        // shown in the menu
+}LibraryHeader;
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Looks which slots hold a complete song. The flash has to be selected.
+ * Returns the slots as mask, bit n is slot n.
+ */
+unsigned int library_scan(void);
+
+/**
+ * Reads the header of <slot>. Returns 1 if the slot holds a song, 0 else.
+ */
+unsigned char library_header(unsigned char slot, LibraryHeader *header);
+
+/**
+ * Reads the name of the song in <slot> to name + 1, <name> needs
+ * LIBRARY_NAME + 1 bytes since flash_read() reads one dummy byte first.
+ */
+void library_name(unsigned char slot, unsigned char *name);
+
+/**
+ * Fills <song> from <header>, the scores are calculated like SONG_SCORES().
+ * The chart of the song has to be opened with library_open().
+ */
+void library_song(const LibraryHeader *header, Song *song);
+
+/**
+ * Start decoding the chart of <size> bytes in <slot> with <r>, the ring
+ * is filled first. The flash has to be idle and stay selected while
+ * decoding. If the ring runs empty while the flash is busy, the source
+ * gives CHART_WAIT instead of waiting for it.
+ */
+void library_open(ChartReader *r, unsigned char slot, unsigned int size);
+
+/**
+ * Read the next block of the open chart into the ring if there is room.
+ * Returns the number of bytes read, 0 if the ring is full, the whole
+ * chart was read or the flash is busy programming a recording.
+ */
+unsigned char library_prefetch(void);
+
+#endif /* LIBS_LIBRARY_H_ */
@@ -0,0 +1,313 @@
+/***************************************************************************//**
+ * @file    loader.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the chart upload.
+ *
+ * The RX interrupt parses the frames straight into one of two buffers,
+ * loader_poll() checks their CRC outside of it. When a data frame is
+ * complete, loader_poll() starts programming it and
+ * switches the interrupt to the other buffer before acknowledging, so the
+ * next frame arrives while the flash is busy. Data frames are at most
+ * LOADER_CHUNK bytes and start at multiples of it, so a frame never crosses
+ * a 256 byte flash page. Two small buffers instead of a whole page keep
+ * the RAM free for the game.
+ ******************************************************************************/
+
+#include "./loader.h"
+#include "./shared.h"
+#include "./flash.h"
+#include "./telemetry.h"
+#include "./trace.h"
+#include <stddef.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define BEGIN_LENGTH            (1 + sizeof(LibraryHeader) - 2) // slot and header without magic
+
+enum RxState{
+    rxSync,
+    rxType,
+    rxLength,
+    rxPayload,
+    rxCrc,
+};
+
+enum FrameState{
+    frameNone,
+    frameReceived,                          // CRC not checked yet
+};
+
+const unsigned char loader_magic[2] = {LIBRARY_MAGIC & 0xFF, LIBRARY_MAGIC >> 8};
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+#define loader_buffer           (shared.loader.buffer)  // RAM of the mode
+#define loader_rx               (shared.loader.rx)
+#define loader_rxState          (shared.loader.rxState)
+#define loader_rxType           (shared.loader.rxType)
+#define loader_rxLength         (shared.loader.rxLength)
+#define loader_rxCount          (shared.loader.rxCount)
+#define loader_rxCrc            (shared.loader.rxCrc)
+#define loader_frame            (shared.loader.frame)
+#define loader_type             (shared.loader.type)
+#define loader_length           (shared.loader.length)
+#define loader_target           (shared.loader.target)
+#define loader_total            (shared.loader.total)
+#define loader_next             (shared.loader.next)
+
+unsigned char loader_phase = loaderWaiting; // enum LoaderState, also read outside of an upload
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+void loader_receive(unsigned char byte);
+unsigned char loader_checked(void);
+void loader_ack(unsigned char status);
+unsigned char loader_begin(const unsigned char *payload);
+unsigned char loader_data(unsigned char *payload);
+unsigned char loader_end(void);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+/**
+ * UartReceiver, called from the RX interrupt. Bytes are ignored while a
+ * frame waits for loader_poll(), the host waits for its ack anyway.
+ */
+void loader_receive(unsigned char byte){
+    if(loader_frame != frameNone){
+        return;
+    }
+    switch(loader_rxState){
+        case rxSync:
+            if(byte == TELEMETRY_SYNC){
+                loader_rxState = rxType;
+            }
+            break;
+        case rxType:
+            loader_rxType = byte;
+            loader_rxState = rxLength;
+            break;
+        case rxLength:
+            loader_rxLength = byte;
+            loader_rxCount = 0;
+            loader_rxState = byte == 0 ? rxCrc : rxPayload;
+            if(byte > LOADER_PAYLOAD){
+                loader_rxState = rxSync;    // can't be one of ours
+            }
+            break;
+        case rxPayload:
+            loader_buffer[loader_rx][loader_rxCount++] = byte;
+            if(loader_rxCount == loader_rxLength){
+                loader_rxState = rxCrc;
+            }
+            break;
+        case rxCrc:
+            loader_type = loader_rxType;
+            loader_length = loader_rxLength;
+            loader_rxCrc = byte;
+            loader_frame = frameReceived;
+            loader_rxState = rxSync;
+            break;
+    }
+}
+
+/**
+ * Returns 1 if the frame in buffer[rx] has the CRC-8 it was sent with.
+ * Not done by the interrupt, which then only stores the bytes.
+ */
+unsigned char loader_checked(void){
+    const unsigned char *payload = loader_buffer[loader_rx];
+    unsigned char crc = uart_crc8(uart_crc8(0, loader_type), loader_length);
+    unsigned char i;
+
+    for(i = 0; i < loader_length; i++){
+        crc = uart_crc8(crc, payload[i]);
+    }
+    return crc == loader_rxCrc;
+}
+
+/**
+ * Answer the last frame with <status> and the next expected offset.
+ */
+void loader_ack(unsigned char status){
+    unsigned char payload[3];
+
+    if(status != loaderOk){
+        TRACE(traceLoader, status);
+    }
+    payload[0] = status;
+    payload[1] = loader_next & 0xFF;
+    payload[2] = loader_next >> 8;
+    telemetry_sendFrame(loaderAck, payload, 3);
+}
+
+/**
+ * Start a new upload, erase the sector of the slot.
+ * Returns 1 if the erase was started.
+ */
+unsigned char loader_begin(const unsigned char *payload){
+    unsigned char slot = payload[0];
+    unsigned int size = payload[1] | (payload[2] << 8);
+
+    if(loader_length != BEGIN_LENGTH || slot >= LIBRARY_SLOTS || size < 3 || size > LIBRARY_MAX_SIZE){
+        loader_phase = loaderWaiting;
+        loader_frame = frameNone;
+        loader_ack(loaderInvalid);
+        return 1;
+    }
+    if(flash_busy()){
+        return 0;                           // a page of the last upload is still programmed
+    }
+    loader_target = slot;
+    loader_total = size;
+    loader_next = 0;
+    flash_erase(LIBRARY_ADDRESS(slot));
+    loader_phase = loaderErasing;           // frame is kept for the header
+    return 1;
+}
+
+/**
+ * Program a data frame and receive the next one into the other buffer.
+ * Returns 1 if it was taken.
+ */
+unsigned char loader_data(unsigned char *payload){
+    unsigned int offset = payload[0] | (payload[1] << 8);
+    unsigned char count = loader_length - 2;
+
+    if(loader_phase == loaderReceiving && offset == 0 && count >= 2 &&
+       (payload[2] | (payload[3] << 8)) < CHART_MIN_SLOTS){
+        loader_phase = loaderWaiting;       // the header without magic leaves the slot empty
+        loader_frame = frameNone;
+        loader_ack(loaderInvalid);
+        return 0;
+    }
+
+    // only whole chunks in order, just the last one can be shorter
+    if(loader_phase != loaderReceiving || loader_length < 3 || offset != loader_next ||
+       offset + count > loader_total || (count != LOADER_CHUNK && offset + count != loader_total)){
+        loader_frame = frameNone;
+        loader_ack(loaderOrder);
+        return 0;
+    }
+    if(flash_busy()){
+        return 0;                           // the other buffer is still programmed, try again
+    }
+    flash_program(LIBRARY_ADDRESS(loader_target) + LIBRARY_CHART + offset, count, payload + 2);
+    loader_next += count;
+    loader_rx ^= 1;
+    loader_frame = frameNone;
+    loader_ack(loaderOk);
+    return 1;
+}
+
+/**
+ * Make the song valid by programming the magic of its header.
+ * Returns 1 if it was started.
+ */
+unsigned char loader_end(void){
+    if(loader_phase == loaderDone){
+        loader_frame = frameNone;
+        loader_ack(loaderOk);               // the ack of the first end got lost
+        return 0;
+    }
+    if(loader_phase != loaderReceiving || loader_next != loader_total){
+        loader_frame = frameNone;
+        loader_ack(loaderOrder);
+        return 0;
+    }
+    if(flash_busy()){
+        return 0;
+    }
+    flash_program(LIBRARY_ADDRESS(loader_target), 2, (unsigned char *)loader_magic);
+    loader_phase = loaderFinishing;
+    loader_frame = frameNone;
+    return 1;
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void loader_start(void){
+    loader_phase = loaderWaiting;
+    loader_target = 0;
+    loader_next = 0;
+    loader_total = 0;
+    loader_rx = 0;
+    loader_rxState = rxSync;
+    loader_frame = frameNone;
+    uart_receive(loader_receive);
+}
+
+void loader_stop(void){
+    uart_receive(NULL);
+}
+
+unsigned char loader_poll(void){
+    switch(loader_phase){
+        case loaderErasing:
+            if(flash_busy()){
+                return 0;
+            }
+            // header without magic from the loaderBegin frame
+            flash_program(LIBRARY_ADDRESS(loader_target) + 2, sizeof(LibraryHeader) - 2,
+                          &loader_buffer[loader_rx][1]);
+            loader_phase = loaderReceiving;
+            loader_frame = frameNone;
+            loader_ack(loaderOk);
+            return 1;
+        case loaderFinishing:
+            if(flash_busy()){
+                return 0;
+            }
+            loader_phase = loaderDone;
+            loader_ack(loaderOk);
+            return 1;
+    }
+
+    if(loader_frame == frameNone){
+        return 0;
+    }
+    if(!loader_checked()){
+        loader_frame = frameNone;
+        loader_ack(loaderCrc);
+        return 0;
+    }
+    switch(loader_type){
+        case loaderBegin:
+            return loader_begin(loader_buffer[loader_rx]);
+        case loaderData:
+            return loader_data(loader_buffer[loader_rx]);
+        case loaderEnd:
+            return loader_end();
+        case traceRequest:
+            trace_request();                // the UART belongs to the loader now
+            break;
+    }
+    loader_frame = frameNone;               // not for the loader
+    return 0;
+}
+
+unsigned char loader_state(void){
+    return loader_phase;
+}
+
+unsigned char loader_slot(void){
+    return loader_target;
+}
+
+unsigned int loader_received(void){
+    return loader_next;
+}
+
+unsigned int loader_size(void){
+    return loader_total;
+}
@@ -0,0 +1,125 @@
+/***************************************************************************//**
+ * @file    loader.h
+ * @date    19.10.26
+ *
+ * @brief   Upload of charts over the UART into the song library.
+ *
+ * Frames are the same as the telemetry frames (see telemetry.h):
+ * 0xA5, type, length, payload, CRC-8. The host sends
+ *
+ *      loaderBegin     slot (1), then the LibraryHeader without magic:
+ *                      size, notes, period, tone[4] (2 each), name (12)
+ *      loaderData      offset in the chart (2), 1 - LOADER_CHUNK bytes of it,
+ *                      the offset has to be a multiple of LOADER_CHUNK
+ *      loaderEnd       nothing, makes the song valid
+ *
+ * and waits for a loaderAck of the MSP after every frame:
+ *
+ *      loaderAck       enum LoaderStatus (1), offset of the next data (2)
+ *
+ * A rejected frame is answered with the offset the loader expects, the host
+ * continues from there. A chart of fewer than CHART_MIN_SLOTS slots is
+ * refused with loaderInvalid at its first data frame, which holds the
+ * length. A frame is acknowledged as soon as its programming
+ * started, so the next one is received while the flash is busy.
+ * tools/chart_upload.py is the sender for the PC.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_LOADER_H_
+#define LIBS_LOADER_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include "./library.h"
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define LOADER_CHUNK            32          // data bytes per frame, 8 frames fill one flash page
+#define LOADER_PAYLOAD          (2 + LOADER_CHUNK)  // longest payload, a data frame
+
+enum LoaderFrame{
+    loaderBegin = 0x10,
+    loaderData,
+    loaderEnd,
+    loaderAck = 0x20,
+};
+
+enum LoaderStatus{
+    loaderOk,                       // frame taken
+    loaderCrc,                      // frame damaged, send it again
+    loaderOrder,                    // unexpected frame or offset, continue at the offset of the ack
+    loaderInvalid,                  // slot, size or chart length not possible, upload stopped
+};
+
+enum LoaderState{
+    loaderWaiting,                  // for loaderBegin
+    loaderErasing,                  // sector of the slot
+    loaderReceiving,                // data frames
+    loaderFinishing,                // magic of the header is programmed
+    loaderDone,                     // song complete
+};
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+// RAM of an upload, only valid while it runs, see shared.h
+typedef struct{
+    unsigned char buffer[2][LOADER_PAYLOAD];    // the two frames
+    volatile unsigned char rx;                  // buffer the RX interrupt fills
+    unsigned char rxState;                      // enum RxState of the interrupt
+    unsigned char rxType;
+    unsigned char rxLength;
+    unsigned char rxCount;
+    unsigned char rxCrc;                        // CRC-8 the frame was sent with
+    volatile unsigned char frame;               // enum FrameState of the frame in buffer[rx]
+    unsigned char type;                         // type and length of that frame
+    unsigned char length;
+    unsigned char target;                       // slot of the upload
+    unsigned int total;                         // size of the chart
+    unsigned int next;                          // offset of the next data frame
+}LoaderRam;
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Start listening for an upload on the UART.
+ */
+void loader_start(void);
+
+/**
+ * Stop listening, an unfinished song stays invalid.
+ */
+void loader_stop(void);
+
+/**
+ * Handles received frames and the flash, call often (every few ms) while
+ * loading. The flash has to be selected.
+ * Returns 1 if the state or the progress changed, 0 else.
+ */
+unsigned char loader_poll(void);
+
+/**
+ * Returns the enum LoaderState.
+ */
+unsigned char loader_state(void);
+
+/**
+ * Returns the slot of the upload.
+ */
+unsigned char loader_slot(void);
+
+/**
+ * Returns the chart bytes received and the size of the chart.
+ */
+unsigned int loader_received(void);
+unsigned int loader_size(void);
+
+#endif /* LIBS_LOADER_H_ */
@@ -0,0 +1,62 @@
+/***************************************************************************//**
+ * @file    menu.c
+ * @date    19.10.26
+ *
+ * @brief   The menu graph and its navigation.
+ *
+ * Vertical moves stay in one column of the menu, right enters the column
+ * below a point and left goes back to it. tests/menu_test.c walks every
+ * edge and checks this.
+ ******************************************************************************/
+
+#include "./menu.h"
+#include "./leader.h"
+#include <stddef.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define N menuNone
+
+const MenuNode menu[menuCount] = {
+    //                      text             up                    down                 left              right
+    [chooseSong]         = {"Play a Song",  {N,                    chooseDifficulty,    N,                playSong1},           NULL,               NULL,           0, showText},
+    [playSong1]          = {"Song 1",       {N,                    playSong2,           chooseSong,       N},                   menu_play,          NULL,           0, showText},
+    [playSong2]          = {"Song 2",       {playSong1,            playSong3,           chooseSong,       N},                   menu_play,          NULL,           1, showText},
+    [playSong3]          = {"Song 3",       {playSong2,            playFlash,           chooseSong,       N},                   menu_play,          NULL,           2, showText},
+    [playFlash]          = {NULL,           {playSong3,            playEndless,         chooseSong,       N},                   menu_playFlash,     menu_browseFlash,0, showFlash},
+    [playEndless]        = {"Endless",      {playFlash,            N,                   chooseSong,       N},                   menu_playEndless,   NULL,           0, showText},
+    [chooseDifficulty]   = {"Difficulty",   {chooseSong,           chooseName,          N,                setDifficultyNormal}, NULL,               NULL,           0, showText},
+    [setDifficultyNormal]= {"Normal",       {N,                    setDifficultyHard,   chooseDifficulty, N},                   menu_setDifficulty, NULL,           0, showText},
+    [setDifficultyHard]  = {"Expert",       {setDifficultyNormal,  N,                   chooseDifficulty, N},                   menu_setDifficulty, NULL,           1, showText},
+    [chooseName]         = {"Player Name",  {chooseDifficulty,     chooseScore,         N,                setName},             NULL,               NULL,           0, showText},
+    [setName]            = {NULL,           {N,                    N,                   chooseName,       N},                   NULL,               menu_editName,  0, showName},
+    [chooseScore]        = {"Highscore",    {chooseName,           uploadSong,          N,                score1},              NULL,               NULL,           0, showText},
+    [score1]             = {"Song1",        {N,                    score2,              chooseScore,      N},                   NULL,               menu_browseBoard,0, showScore},
+    [score2]             = {"Song2",        {score1,               score3,              chooseScore,      N},                   NULL,               menu_browseBoard,1, showScore},
+    [score3]             = {"Song3",        {score2,               scoreEndless,        chooseScore,      N},                   NULL,               menu_browseBoard,2, showScore},
+    [scoreEndless]       = {"Endless",      {score3,               resetScore,          chooseScore,      N},                   NULL,               menu_browseBoard,LEADER_ENDLESS, showScore},
+    [resetScore]         = {"Reset?",       {scoreEndless,         N,                   chooseScore,      N},                   menu_resetScores,   NULL,           0, showText},
+    [uploadSong]         = {"Upload Song",  {chooseScore,          recordSong,          N,                N},                   menu_upload,        NULL,           0, showText},
+    [recordSong]         = {"Record Song",  {uploadSong,           N,                   N,                N},                   menu_record,        NULL,           0, showText},
+};
+
+#undef N
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+unsigned char menu_navigate(unsigned char *point, unsigned char direction){
+    const MenuNode *node = &menu[*point];
+
+    if(node->edit != NULL && node->edit(direction)){
+        return 1;
+    }
+    if(node->next[direction] == menuNone){
+        return 0;
+    }
+    *point = node->next[direction];
+    return 1;
+}
@@ -0,0 +1,156 @@
+/***************************************************************************//**
+ * @file    menu.h
+ * @date    19.10.26
+ *
+ * @brief   Menu graph, every menu point with its neighbours and actions.
+ *
+ * The whole menu is the const table menu[], indexed by enum MenuPoint.
+ * Each node holds the menu point reached for each joystick direction,
+ * the function called on a button press and what its second line shows,
+ * so navigating is one table lookup and the arrows on the display always
+ * match the possible moves.
+ *
+ * The actions are implemented by the game (main.c), the menu itself doesn't
+ * touch any hardware.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_MENU_H_
+#define LIBS_MENU_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+enum MenuPoint{
+    chooseSong,
+    playSong1,
+    playSong2,
+    playSong3,
+    playFlash,
+    playEndless,
+    chooseDifficulty,
+    setDifficultyNormal,
+    setDifficultyHard,
+    chooseName,
+    setName,
+    chooseScore,
+    score1,
+    score2,
+    score3,
+    scoreEndless,
+    resetScore,
+    uploadSong,
+    recordSong,
+    menuCount,                      // number of menu points
+    menuNone = 255,                 // no neighbour in this direction
+};
+
+// Joystick directions, index of MenuNode.next
+enum MenuDirection{
+    menuUp,
+    menuDown,
+    menuLeft,
+    menuRight,
+};
+
+// What is shown on the second line after the text
+enum MenuShow{
+    showText,                       // only the text
+    showScore,                      // the leaderboard of song <arg>, one rank at a time
+    showName,                       // the player name instead of the text
+    showFlash,                      // the name of the chosen flash song instead of the text
+};
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+typedef void (*MenuAction)(unsigned char arg);
+typedef unsigned char (*MenuEdit)(unsigned char direction);
+
+typedef struct{
+    const char *text;               // second line of the display
+    unsigned char next[4];          // menu point for each enum MenuDirection, menuNone if there is none
+    MenuAction press;               // called with arg on a button press, NULL if a press does nothing
+    MenuEdit edit;                  // gets the joystick first, NULL if the point can't be edited
+    unsigned char arg;              // song or difficulty of press, song of showScore
+    unsigned char show;             // enum MenuShow
+}MenuNode;
+
+extern const MenuNode menu[menuCount];
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Move from <*point> in <direction> (enum MenuDirection). The edit function
+ * of the point gets the direction first, if it doesn't use it the point
+ * changes to its neighbour.
+ * Returns 1 if the point or its content changed, 0 else.
+ */
+unsigned char menu_navigate(unsigned char *point, unsigned char direction);
+
+// Actions, implemented by the game.
+
+/**
+ * Start playing song <song> (index of songs[]).
+ */
+void menu_play(unsigned char song);
+
+/**
+ * Start playing the chosen song of the flash, if there is one.
+ */
+void menu_playFlash(unsigned char unused);
+
+/**
+ * Start the endless mode, see endless.h.
+ */
+void menu_playEndless(unsigned char unused);
+
+/**
+ * Choose a song of the flash with up and down. Returns 1 if the direction
+ * was used, 0 to leave the menu point.
+ */
+unsigned char menu_browseFlash(unsigned char direction);
+
+/**
+ * Go through the ranks of a leaderboard with right. Returns 1 if the
+ * direction was used, 0 to leave the menu point.
+ */
+unsigned char menu_browseBoard(unsigned char direction);
+
+/**
+ * Wait for a chart upload on the UART.
+ */
+void menu_upload(unsigned char unused);
+
+/**
+ * Record a new chart along with a metronome into a free slot of the flash.
+ */
+void menu_record(unsigned char unused);
+
+/**
+ * Set the difficulty, 0 Normal or 1 Expert.
+ */
+void menu_setDifficulty(unsigned char difficulty);
+
+/**
+ * Clear all leaderboards.
+ */
+void menu_resetScores(unsigned char unused);
+
+/**
+ * Change the player name with the joystick. Returns 1 if the direction
+ * was used, 0 to leave the menu point.
+ */
+unsigned char menu_editName(unsigned char direction);
+
+#endif /* LIBS_MENU_H_ */
@@ -0,0 +1,98 @@
+/***************************************************************************//**
+ * @file    power.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the LPM3 sleeps and the time accounting.
+ *
+ * The active time is the time Timer1_A ran minus the time in LPM0, which
+ * tick_sleepUntil() counts. The calibration waits in LPM0 as well, it adds
+ * its wait with tick_addSlept().
+ ******************************************************************************/
+
+#include "./power.h"
+#include "./tick.h"
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+unsigned int power_intervalMs = 683;    // length of one interval, 8192 / 12 kHz until calibrated
+unsigned long power_lpm3Ms = 0;         // time spent in power_sleep()
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+void wait_interval(unsigned int mode);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+/**
+ * Let Timer0_A count one interval of ACLK and sleep in <mode> until it
+ * ends. Other interrupts which end the sleep early put the CPU back to
+ * sleep. The buzzer gets Timer0_A back with the tone it had.
+ */
+void wait_interval(unsigned int mode){
+    unsigned int period = TA0CCR0;
+    unsigned int duty = TA0CCR2;
+
+    __disable_interrupt();
+    TA0CCTL2 = OUTMOD_0;                // buzzer pin low
+    TA0CCR0 = POWER_INTERVAL - 1;
+    TA0CCTL0 = CCIE;
+    TA0CTL = TASSEL_1 + MC_1 + TACLR;   // ACLK, up mode
+    while(TA0CCTL0 & CCIE){
+        __bis_SR_register(mode + GIE);  // Timer0_A0() clears CCIE and wakes up
+        __disable_interrupt();
+    }
+    TA0CTL = TASSEL_2 + MC_1 + TACLR;   // like pwm_init()
+    TA0CCR0 = period;
+    TA0CCR2 = duty;
+    TA0CCTL2 = OUTMOD_3;
+    __enable_interrupt();
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void power_init(void){
+    BCSCTL3 |= LFXT1S_2;                // ACLK from VLO, no crystal needed
+}
+
+unsigned int power_calibrate(void){
+    unsigned int start = tick_now();
+
+    wait_interval(LPM0_bits);           // the tick keeps running in LPM0
+    power_intervalMs = tick_now() - start;
+    tick_addSlept(power_intervalMs);
+    return power_intervalMs;
+}
+
+void power_sleep(void){
+    wait_interval(LPM3_bits);
+    power_lpm3Ms += power_intervalMs;
+}
+
+void power_stats(PowerStats *stats){
+    stats->lpm0 = tick_slept();
+    stats->active = tick_uptime() - stats->lpm0;
+    stats->lpm3 = power_lpm3Ms;
+}
+
+/******************************************************************************
+ * TIMER
+ *****************************************************************************/
+
+/**
+ * CCR0 of Timer0_A at the end of an interval, ends power_sleep() and
+ * power_calibrate().
+ */
+#pragma vector=TIMER0_A0_VECTOR
+__interrupt void Timer0_A0(void)
+{
+    TA0CCTL0 = 0;
+    __bic_SR_register_on_exit(LPM3_bits);
+}
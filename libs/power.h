@@ -0,0 +1,70 @@
+/***************************************************************************//**
+ * @file    power.h
+ * @date    19.10.26
+ *
+ * @brief   LPM3 sleeps on Timer0_A and time accounting.
+ *
+ * In LPM3 SMCLK is off, so Timer1_A (the tick) stops. For a sleep Timer0_A
+ * leaves the buzzer and counts ACLK, which comes from the VLO (about 12 kHz,
+ * but 4 - 20 kHz from part to part), and its CCR0 wakes the CPU after one
+ * interval. The length of an interval is measured against the tick by
+ * power_calibrate(), so the time in LPM3 can be counted in ms. The watchdog
+ * isn't used for it, it guards the scheduler (sched.h).
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_POWER_H_
+#define LIBS_POWER_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include <msp430g2553.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+// ACLK counts of one interval, about 0.7 s with the VLO. A quarter of the
+// watchdog of sched.h, which counts the same clock.
+#define POWER_INTERVAL          8192
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+// Where the time went since tick_init(), all in ms.
+typedef struct{
+    unsigned long active;           // CPU running
+    unsigned long lpm0;             // waiting for the tick in LPM0
+    unsigned long lpm3;             // sleeping in LPM3
+}PowerStats;
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Selects the VLO as source of ACLK. Call after initMSP().
+ */
+void power_init(void);
+
+/**
+ * Measures one interval in LPM0 against the tick and stores it for
+ * power_sleep(). Returns the length in ms.
+ */
+unsigned int power_calibrate(void);
+
+/**
+ * Sleeps in LPM3 for one interval. The tick doesn't advance in the
+ * meantime, the buzzer is silent.
+ */
+void power_sleep(void);
+
+/**
+ * Fills <stats> with the active and sleeping time since the start.
+ */
+void power_stats(PowerStats *stats);
+
+#endif /* LIBS_POWER_H_ */
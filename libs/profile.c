@@ -0,0 +1,61 @@
+/***************************************************************************//**
+ * @file    profile.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the region profiler.
+ *
+ * Nothing in here is built without PROFILE.
+ ******************************************************************************/
+
+#include "./profile.h"
+
+#ifdef PROFILE
+
+#include "./telemetry.h"
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+ProfileEntry profile_regions[profileCount];
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void profile_end(unsigned char region, unsigned int now){
+    ProfileEntry *entry = &profile_regions[region];
+    unsigned int counts = (now - entry->start) & 0xFFFF;   // TA1R wraps at 16 bit, int may be wider
+
+    if(entry->count == 0 || counts < entry->min){
+        entry->min = counts;
+    }
+    if(counts > entry->max){
+        entry->max = counts;
+    }
+    entry->total += counts;
+    entry->count++;
+}
+
+void profile_reset(void){
+    unsigned char i;
+
+    for(i = 0; i < profileCount; i++){
+        profile_regions[i].count = 0;
+        profile_regions[i].min = 0;
+        profile_regions[i].max = 0;
+        profile_regions[i].total = 0;
+    }
+}
+
+void profile_dump(void){
+    unsigned char i;
+
+    for(i = 0; i < profileCount; i++){
+        while(!telemetry_sendProfile(i)){   // wait for room, the UART interrupt makes it
+            __no_operation();
+        }
+    }
+}
+
+#endif /* PROFILE */
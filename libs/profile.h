@@ -0,0 +1,99 @@
+/***************************************************************************//**
+ * @file    profile.h
+ * @date    19.10.26
+ *
+ * @brief   Profiler for code regions, timed with the free-running Timer1_A.
+ *
+ * Put PROFILE_BEGIN(region) and PROFILE_END(region) around the code to
+ * measure, the region is one of enum ProfileRegion. For every region the
+ * number of runs and the shortest, longest and total time are collected
+ * in a RAM table, which profile_dump() sends as telemetry frames.
+ *
+ * Only active if PROFILE is defined for the build (e.g. as predefined
+ * symbol in CCS), else the macros are empty and nothing is left in the code.
+ *
+ * Times are taken from TA1R, one count is 8 CPU cycles (0.5 us) and a
+ * region must not take longer than 65535 counts (32 ms). A region can't
+ * be nested in itself.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_PROFILE_H_
+#define LIBS_PROFILE_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include <msp430g2553.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define PROFILE_CYCLES_PER_COUNT    8       // Timer1_A runs from SMCLK / 8
+
+// Measured regions, the number is sent in the telemetry frame.
+enum ProfileRegion{
+    profileButtons,                 // stateButton() in shift.c
+    profileAdac,                    // adac_read() in adac.c
+    profileLcdChar,                 // lcd_putChar() in LCD.c
+    profileLcdCursor,               // lcd_cursorSet() in LCD.c
+    profileLcdClear,                // lcd_clear() in LCD.c
+    profileDraw,                    // task_lcd() in main.c
+    profileStep,                    // one step of the song in task_game()
+    profilePress,                   // processPressGame() in main.c
+    profileCount,
+};
+
+#ifdef PROFILE
+#define PROFILE_BEGIN(region)       (profile_regions[region].start = TA1R)
+#define PROFILE_END(region)         profile_end(region, TA1R)
+#else
+#define PROFILE_BEGIN(region)
+#define PROFILE_END(region)
+#endif
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+#ifdef PROFILE
+
+typedef struct{
+    unsigned int start;             // TA1R at PROFILE_BEGIN
+    unsigned int count;             // number of runs
+    unsigned int min;               // shortest run in counts
+    unsigned int max;               // longest run in counts
+    unsigned long total;            // all runs in counts
+}ProfileEntry;
+
+extern ProfileEntry profile_regions[profileCount];
+
+#endif
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+#ifdef PROFILE
+
+/**
+ * Used by PROFILE_END, counts the run of <region> which ends at <now> (TA1R).
+ */
+void profile_end(unsigned char region, unsigned int now);
+
+/**
+ * Clears the table.
+ */
+void profile_reset(void);
+
+/**
+ * Sends one telemetryProfile frame per region on the UART.
+ * Waits for room if the UART is busy, but not until everything is sent.
+ */
+void profile_dump(void);
+
+#endif
+
+#endif /* LIBS_PROFILE_H_ */
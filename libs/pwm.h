@@ -1,39 +1,39 @@
-/***************************************************************************//**
- * @file    pwm.h
- * @author  Christopher Haas
- * @date    05.07.23
- *
- * @brief Control the buzzer with PWM signals
- *
- ******************************************************************************/
-
-#ifndef LIBS_PWM_H_
-#define LIBS_PWM_H_
-
-/******************************************************************************
- * INCLUDES
- *****************************************************************************/
-
-#include <msp430g2553.h>
-
-/******************************************************************************
- * CONSTANTS
- *****************************************************************************/
-
-
-
-/******************************************************************************
- * VARIABLES
- *****************************************************************************/
-
-
-
-/******************************************************************************
- * FUNCTION PROTOTYPES
- *****************************************************************************/
-
-void pwm_init(void);
-
-void playNotes(int freq);
-
-#endif /* LIBS_PWM_H_ */
+/***************************************************************************//**
+ * @file    pwm.h
+ * @author  Christopher Haas
+ * @date    05.07.23
+ *
+ * @brief Control the buzzer with PWM signals
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_PWM_H_
+#define LIBS_PWM_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include <msp430g2553.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+void pwm_init(void);
+
+void playNotes(int freq);
+
+#endif /* LIBS_PWM_H_ */
@@ -0,0 +1,390 @@
+/***************************************************************************//**
+ * @file    recorder.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the recordings and the ghost.
+ *
+ * recorder_press() puts the events into recorder_ring at recorder_head,
+ * recorder_poll() programs them from recorder_tail on. Both only count up
+ * from the start of a recording and are masked on access, so recorder_tail
+ * is also the offset of the next chunk in the events. Chunks are taken
+ * whole, the ring is a multiple of them and only the last one of a
+ * recording is shorter, so a chunk never wraps.
+ *
+ * The ghost reads its recording RECORDER_GHOST bytes at a time into a
+ * buffer of its own, only when the flash isn't busy with a chunk.
+ ******************************************************************************/
+
+#include "./recorder.h"
+#include "./replay.h"
+#include "./shared.h"
+#include "./flash.h"
+#include "./uart.h"
+#include "./telemetry.h"
+#include "./trace.h"
+#include <stddef.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+// The part of RecorderHeader programmed when a recording is complete, from
+// its length up to the spare byte; the start is only needed once
+typedef struct{
+    uint8_t length;
+    uint8_t crc;
+    uint8_t score[4];
+    uint8_t flags;
+}RecorderEnd;
+
+enum RecorderState{
+    recorderIdle,
+    recorderRecording,
+    recorderFinishing,                      // the rest of the events and the header are programmed
+};
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+unsigned int recorder_next = RECORDER_NONE; // next free slot, RECORDER_NONE until the log was looked for
+unsigned int recorder_sequence;             // sequence number of the next recording
+unsigned char recorder_erase = 0;           // 1 if the sector of recorder_next has to be erased first
+
+unsigned char recorder_state = recorderIdle;    // enum RecorderState
+unsigned int recorder_current = RECORDER_NONE;  // slot of the running or the last recording
+RecorderEnd recorder_end;                   // end of its header, length and crc count up while recording
+unsigned int recorder_tick;                 // tick of its last event
+#define recorder_ring           (shared.play.recorder)  // RAM of the mode
+unsigned char recorder_head;                // next byte written by recorder_press()
+unsigned char recorder_tail;                // next byte programmed by recorder_poll()
+unsigned char recorder_flashing = 0;        // 1 after an erase or program was started
+unsigned int recorder_sent = RECORDER_NONE; // next byte of the last recording to send
+
+#define ghost_buffer            (shared.play.ghost)
+unsigned char ghost_count = 0;              // bytes in ghost_buffer
+unsigned char ghost_taken = 0;              // bytes of it decoded
+unsigned char ghost_left = 0;               // bytes of the recording not read yet
+long int ghost_address;                     // next of them
+#define ghost_decoder           (shared.play.decoder)
+unsigned int ghost_tick;                    // tick of the event decoded last
+unsigned char ghost_ready = 0;              // 1 if it waits for its tick
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+long int recorder_address(unsigned int slot);
+unsigned int recorder_find(unsigned char sector);
+void recorder_locate(void);
+void recorder_claim(unsigned char board, unsigned int seed);
+unsigned char recorder_ghostNext(void);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+/**
+ * Returns the flash address of the page of <slot>.
+ */
+long int recorder_address(unsigned int slot){
+    return ((long int)RECORDER_SECTOR << 16) + ((long int)slot << 8);
+}
+
+/**
+ * Returns the first free page of <sector> (0 or 1) of the log,
+ * RECORDER_PAGES if it is full. Binary search on the claim bytes like
+ * leader_find().
+ */
+unsigned int recorder_find(unsigned char sector){
+    unsigned char claim[2];                 // flash_read() reads one dummy byte first
+    unsigned int low = 0;
+    unsigned int high = RECORDER_PAGES;
+    unsigned int middle;
+
+    while(low < high){
+        middle = (low + high) / 2;
+        flash_read(recorder_address(sector * RECORDER_PAGES + middle), 1, claim);
+        if(claim[1] == RECORDER_CLAIM){
+            low = middle + 1;
+        }
+        else{
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/**
+ * Find the end of the log: the sector whose last recording has the higher
+ * sequence number is the one written last. If it is full the log goes on
+ * in the other one.
+ */
+void recorder_locate(void){
+    unsigned char buffer[5];
+    unsigned int end[2];
+    unsigned int last[2] = {0, 0};          // sequence of the last recording of a sector
+    unsigned char sector;
+
+    for(sector = 0; sector < 2; sector++){
+        end[sector] = recorder_find(sector);
+        if(end[sector] > 0){
+            flash_read(recorder_address(sector * RECORDER_PAGES + end[sector] - 1), 4, buffer);
+            last[sector] = buffer[3] | (buffer[4] << 8);
+        }
+    }
+    sector = end[1] > 0 && (end[0] == 0 || (int)(last[1] - last[0]) > 0);
+    recorder_sequence = end[sector] > 0 ? last[sector] + 1 : 0;
+    if(end[sector] < RECORDER_PAGES){
+        recorder_next = sector * RECORDER_PAGES + end[sector];
+    }
+    else{
+        sector ^= 1;
+        recorder_next = sector * RECORDER_PAGES;
+        recorder_erase = end[sector] > 0;
+    }
+}
+
+/**
+ * Program the start of the header of recorder_current for <board> and
+ * <seed>, a frame of its own so it isn't on the stack while the log is
+ * looked for.
+ */
+void recorder_claim(unsigned char board, unsigned int seed){
+    RecorderHeader header;
+
+    header.claim = RECORDER_CLAIM;
+    header.board = board;
+    header.sequence = recorder_sequence;
+    header.seed = seed;
+    flash_program(recorder_address(recorder_current), offsetof(RecorderHeader, length), &header.claim);
+}
+
+/**
+ * Decode the next event of the ghost unless it waits already, reads the
+ * next bytes if the flash is idle. Returns 1 if an event waits.
+ */
+unsigned char recorder_ghostNext(void){
+    unsigned char buffer[RECORDER_GHOST + 1];
+    unsigned char i;
+
+    while(!ghost_ready){
+        if(ghost_taken == ghost_count){
+            ghost_count = ghost_left < RECORDER_GHOST ? ghost_left : RECORDER_GHOST;
+            ghost_taken = 0;
+            if(ghost_count == 0 || flash_busy()){
+                ghost_count = 0;
+                return 0;
+            }
+            flash_read(ghost_address, ghost_count, buffer);
+            for(i = 0; i < ghost_count; i++){
+                ghost_buffer[i] = buffer[i + 1];
+            }
+            ghost_address += ghost_count;
+            ghost_left -= ghost_count;
+        }
+        if(replay_decode(&ghost_decoder, ghost_buffer[ghost_taken++])){
+            ghost_tick += REPLAY_DELTA(&ghost_decoder);
+            ghost_ready = 1;
+        }
+    }
+    return 1;
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+unsigned char recorder_start(unsigned char board, unsigned int seed, unsigned int tick){
+    ghost_tick = tick;
+    recorder_state = recorderIdle;
+    recorder_current = RECORDER_NONE;
+    recorder_sent = RECORDER_NONE;
+    if(recorder_erase || recorder_flashing || flash_busy()){
+        return 0;                           // recorder_poll() or a commit of store.c isn't done yet
+    }
+    if(recorder_next == RECORDER_NONE){
+        recorder_locate();
+        if(recorder_erase){
+            return 0;
+        }
+    }
+    recorder_current = recorder_next;
+    recorder_end.length = 0;
+    recorder_end.crc = 0;
+    recorder_end.flags = 0;
+    recorder_tick = tick;
+    recorder_head = 0;
+    recorder_tail = 0;
+    recorder_claim(board, seed);
+    recorder_flashing = 1;
+    recorder_state = recorderRecording;
+    return 1;
+}
+
+void recorder_press(unsigned int tick, unsigned char mask){
+    unsigned char event[REPLAY_EVENT_MAX];
+    unsigned char count;
+    unsigned char i;
+
+    if(recorder_state != recorderRecording){
+        return;
+    }
+    count = replay_encode(event, (unsigned int)(tick - recorder_tick), mask);
+    if(recorder_end.length + count > RECORDER_EVENTS ||
+       (unsigned char)(recorder_head - recorder_tail) + count > RECORDER_BUFFER){
+        recorder_end.flags |= RECORDER_TRUNCATED;    // the delta of the next one covers it, but the play is incomplete
+        return;
+    }
+    for(i = 0; i < count; i++){
+        recorder_ring[recorder_head++ & (RECORDER_BUFFER - 1)] = event[i];
+        recorder_end.crc = uart_crc8(recorder_end.crc, event[i]);
+    }
+    recorder_end.length += count;
+    recorder_tick = tick;
+}
+
+void recorder_finish(unsigned long score){
+    unsigned char i;
+
+    ghost_ready = 0;                        // the ghost ends with the play
+    ghost_left = 0;
+    ghost_count = 0;
+    ghost_taken = 0;
+    if(recorder_state != recorderRecording){
+        return;
+    }
+    for(i = 0; i < 4; i++){
+        recorder_end.score[i] = score >> (8 * i);
+    }
+    recorder_state = recorderFinishing;
+}
+
+unsigned int recorder_slot(void){
+    return recorder_current;
+}
+
+unsigned char recorder_poll(void){
+    unsigned char count = recorder_head - recorder_tail;
+
+    if(recorder_flashing){
+        if(flash_busy()){
+            return 1;
+        }
+        recorder_flashing = 0;
+    }
+    if(recorder_erase){
+        flash_erase(recorder_address(recorder_next));
+        recorder_erase = 0;
+        recorder_flashing = 1;
+        return 1;
+    }
+    if(count >= RECORDER_CHUNK || (recorder_state == recorderFinishing && count > 0)){
+        if(count > RECORDER_CHUNK){
+            count = RECORDER_CHUNK;
+        }
+        flash_program(recorder_address(recorder_current) + sizeof(RecorderHeader) + recorder_tail, count,
+                      &recorder_ring[recorder_tail & (RECORDER_BUFFER - 1)]);
+        recorder_tail += count;
+        recorder_flashing = 1;
+        return 1;
+    }
+    if(recorder_state == recorderFinishing){
+        // length, crc, score and flags in one go, the recording is complete with them
+        flash_program(recorder_address(recorder_current) + offsetof(RecorderHeader, length),
+                      sizeof(RecorderEnd), &recorder_end.length);
+        recorder_flashing = 1;
+        recorder_state = recorderIdle;
+        recorder_sent = 0;
+        recorder_sequence++;
+        recorder_next = (recorder_current + 1) % RECORDER_SLOTS;
+        recorder_erase = recorder_next % RECORDER_PAGES == 0;   // the oldest sector of the log
+        TRACE(traceRecorder, recorder_end.length);
+        return 1;
+    }
+    return 0;
+}
+
+unsigned char recorder_pending(void){
+    return recorder_flashing || recorder_erase || recorder_state == recorderFinishing ||
+           (unsigned char)(recorder_head - recorder_tail) >= RECORDER_CHUNK;
+}
+
+unsigned char recorder_ghost(unsigned int slot, unsigned char board, unsigned int seed, unsigned long score){
+    unsigned char buffer[sizeof(RecorderHeader) + 1];
+    const unsigned char *header = &buffer[1];
+    long int address = recorder_address(slot) + sizeof(RecorderHeader);
+    unsigned char length, sum, crc = 0, done, count, i;
+
+    ghost_ready = 0;
+    ghost_left = 0;
+    ghost_count = 0;
+    ghost_taken = 0;
+    if(slot >= RECORDER_SLOTS){
+        return 0;
+    }
+    flash_read(recorder_address(slot), sizeof(RecorderHeader), buffer);
+    length = header[offsetof(RecorderHeader, length)];
+    sum = header[offsetof(RecorderHeader, crc)];
+    if(header[offsetof(RecorderHeader, claim)] != RECORDER_CLAIM || header[offsetof(RecorderHeader, board)] != board ||
+       length > RECORDER_EVENTS || (header[offsetof(RecorderHeader, flags)] & RECORDER_TRUNCATED)){
+        return 0;                           // overwritten by a newer recording, never completed or incomplete
+    }
+    if((header[offsetof(RecorderHeader, seed)] | header[offsetof(RecorderHeader, seed) + 1] << 8) != seed){
+        return 0;
+    }
+    for(i = 0; i < 4; i++){
+        if(header[offsetof(RecorderHeader, score) + i] != (unsigned char)(score >> (8 * i))){
+            return 0;
+        }
+    }
+
+    // the events, in blocks through the same buffer
+    for(done = 0; done < length; done += count){
+        count = length - done < sizeof(RecorderHeader) ? length - done : sizeof(RecorderHeader);
+        flash_read(address + done, count, buffer);
+        for(i = 0; i < count; i++){
+            crc = uart_crc8(crc, buffer[i + 1]);
+        }
+    }
+    if(crc != sum){
+        return 0;                           // a power cut while the end of it was programmed
+    }
+    ghost_address = address;
+    ghost_left = length;
+    replay_start(&ghost_decoder);
+    return 1;
+}
+
+unsigned char recorder_ghostDue(unsigned int tick){
+    unsigned char lanes = 0;
+
+    while(recorder_ghostNext() && (int)(tick - ghost_tick) >= 0){
+        lanes |= REPLAY_MASK(&ghost_decoder);
+        ghost_ready = 0;
+    }
+    return lanes;
+}
+
+unsigned char recorder_sending(void){
+    return recorder_sent < sizeof(RecorderHeader) + recorder_end.length;
+}
+
+unsigned char recorder_send(void){
+    unsigned char buffer[RECORDER_FRAME + 1];
+    unsigned int end = sizeof(RecorderHeader) + recorder_end.length;
+    unsigned char count;
+
+    while(recorder_sent < end){
+        if(recorder_state != recorderIdle || flash_busy()){
+            return 1;
+        }
+        count = end - recorder_sent > RECORDER_FRAME ? RECORDER_FRAME : end - recorder_sent;
+        flash_read(recorder_address(recorder_current) + recorder_sent, count, buffer);
+        if(!telemetry_sendReplay(recorder_current, recorder_sent, &buffer[1], count)){
+            return 1;                       // the UART is full, again on the next call
+        }
+        recorder_sent += count;
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+/***************************************************************************//**
+ * @file    recorder.h
+ * @date    19.10.26
+ *
+ * @brief   Recording of every play into the SPI flash, the best ones are
+ *          played back as ghost.
+ *
+ * The presses of a play are encoded like replay.h describes into a small
+ * RAM ring and programmed to the flash in chunks of RECORDER_CHUNK bytes
+ * by recorder_poll(), which the game runs in the background. Nothing of it
+ * waits for the flash, so the tick is never held up.
+ *
+ * The recordings are a log in the two sectors from RECORDER_SECTOR on, one
+ * page per recording:
+ *
+ *      0x00        RecorderHeader, claim, board, sequence and seed
+ *                  are programmed at the start, the rest at the end
+ *      0x0E        the events, header.length bytes
+ *
+ * Once a sector is full the log goes on in the other one, which is erased
+ * first, so the last 256 - 511 recordings are kept. A recording is
+ * complete if its length is programmed and the CRC matches. If presses had
+ * to be left out because the page or the ring was full, it is marked with
+ * RECORDER_TRUNCATED: it still counts for the log, but it isn't played
+ * back as ghost or taken as replay.
+ *
+ * After a recording the page is sent as telemetryReplay frames by
+ * recorder_send(), tools/replay_decode.py decodes them or a flash image.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_RECORDER_H_
+#define LIBS_RECORDER_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define RECORDER_SECTOR         26          // first sector of the log, after the leaderboards
+#define RECORDER_PAGES          256         // recordings per sector
+#define RECORDER_SLOTS          (2 * RECORDER_PAGES)
+#define RECORDER_CLAIM          0x52        // "R", the page holds a recording
+#define RECORDER_EVENTS         242         // bytes of events of a recording, the rest of its page
+#define RECORDER_BUFFER         16          // RAM ring of encoded events, power of 2
+#define RECORDER_CHUNK          8           // bytes programmed at once
+#define RECORDER_GHOST          4           // bytes of the ghost read at once
+#define RECORDER_FRAME          16          // bytes of the page per telemetryReplay frame
+#define RECORDER_NONE           0xFFFF      // no recording
+
+#define RECORDER_TRUNCATED      0x01        // flag of RecorderHeader: presses were left out
+
+// Board of a song of the flash, <slot> of library.h on <difficulty>. The
+// songs of the MCU have the ones of leader.h.
+#define RECORDER_FLASH_BOARD(slot, difficulty)  (0x80 | (slot) << 1 | (difficulty))
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+// Start of a recording, only 8 bit fields and 16 bit ones at even
+// offsets, so the layout is the same on the PC
+typedef struct{
+    uint8_t claim;                  // RECORDER_CLAIM
+    uint8_t board;                  // LEADER_BOARD() or RECORDER_FLASH_BOARD() of the song
+    uint16_t sequence;              // counts the recordings, the log goes on after the highest
+    uint16_t seed;                  // of the chart of the endless mode (endless.h), 0 for the other songs
+    uint8_t length;                 // bytes of events, 0xFF while recording
+    uint8_t crc;                    // CRC-8 of the events
+    uint8_t score[4];               // score of the play, little endian
+    uint8_t flags;                  // RECORDER_TRUNCATED
+    uint8_t spare;                  // keeps the size even, not programmed
+}RecorderHeader;
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Start recording a play of <board> on the chart of <seed>, which started
+ * at tick <tick>, and the ghost of recorder_ghost(). The end of the log is
+ * looked for on the first call. The flash has to be selected.
+ * Returns 1 if it records, 0 if the flash is busy, e.g. erasing the next
+ * sector of the log, the play isn't recorded then.
+ */
+unsigned char recorder_start(unsigned char board, unsigned int seed, unsigned int tick);
+
+/**
+ * Record a new press of the lanes <mask> at tick <tick>. If the page or
+ * the ring is full the press is left out and the recording is marked as
+ * truncated.
+ */
+void recorder_press(unsigned int tick, unsigned char mask);
+
+/**
+ * End the recording with the score <score>, the rest is written by
+ * recorder_poll().
+ */
+void recorder_finish(unsigned long score);
+
+/**
+ * Returns the slot of the running or the last recording, RECORDER_NONE if
+ * the play wasn't recorded.
+ */
+unsigned int recorder_slot(void);
+
+/**
+ * Write one chunk of the recording, its end or erase the next sector,
+ * never waits for the flash. The flash has to be selected.
+ * Returns 1 while there is more to do than the running recording has
+ * collected yet.
+ */
+unsigned char recorder_poll(void);
+
+/**
+ * Returns 1 if recorder_poll() has something to do.
+ */
+unsigned char recorder_pending(void);
+
+/**
+ * Play the recording in <slot> back as ghost in the next play, if it is a
+ * complete one of <board> on the chart of <seed> with <score>, its CRC
+ * matches and it isn't truncated. Call it right before recorder_start(),
+ * the ghost starts with the play and ends with recorder_finish(). The
+ * flash has to be selected and idle.
+ * Returns 1 if there is a ghost.
+ */
+unsigned char recorder_ghost(unsigned int slot, unsigned char board, unsigned int seed, unsigned long score);
+
+/**
+ * Returns the lanes the ghost pressed up to tick <tick> since the last
+ * call, 0 for none. Reads the recording ahead from the flash when it is
+ * idle.
+ */
+unsigned char recorder_ghostDue(unsigned int tick);
+
+/**
+ * Returns 1 while the last recording isn't sent completely.
+ */
+unsigned char recorder_sending(void);
+
+/**
+ * Send the next telemetryReplay frames of the last recording, as many as
+ * the UART has room for.
+ * The flash has to be selected.
+ * Returns 1 while there are frames to send.
+ */
+unsigned char recorder_send(void);
+
+#endif /* LIBS_RECORDER_H_ */
@@ -0,0 +1,50 @@
+/***************************************************************************//**
+ * @file    replay.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the replay encoding.
+ ******************************************************************************/
+
+#include "./replay.h"
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+unsigned char replay_encode(unsigned char *out, unsigned long delta, unsigned char mask){
+    unsigned long value;
+    unsigned char count = 0;
+
+    if(delta > REPLAY_DELTA_MAX){
+        delta = REPLAY_DELTA_MAX;
+    }
+    value = delta << 4 | (mask & 0x0F);
+    while(value > 0x7F){
+        out[count++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    out[count++] = value;
+    return count;
+}
+
+void replay_start(ReplayDecoder *d){
+    d->value = 0;
+    d->shift = 0;
+}
+
+unsigned char replay_decode(ReplayDecoder *d, unsigned char byte){
+    if(d->shift == 0){
+        d->value = 0;                       // a new event, the last one is done
+    }
+    if(d->shift < 7 * REPLAY_EVENT_MAX){   // the bits of a broken stream beyond are dropped
+        d->value |= (unsigned long)(byte & 0x7F) << d->shift;
+    }
+    if(byte & 0x80){
+        if(d->shift <= 7 * REPLAY_EVENT_MAX){
+            d->shift += 7;                  // stops past the event, a broken stream can't wrap it
+        }
+        return 0;
+    }
+    d->shift = 0;
+    return 1;
+}
@@ -0,0 +1,73 @@
+/***************************************************************************//**
+ * @file    replay.h
+ * @date    19.10.26
+ *
+ * @brief   Compact encoding of the presses of a play.
+ *
+ * A play is a stream of events, one per new press: the ms since the last
+ * event (since the start of the song for the first one) and the mask of
+ * the lanes pressed, bit n for lane n + 1. An event is the number
+ *
+ *      delta * 16 + mask
+ *
+ * as varint, 7 bits per byte with the low ones first and bit 7 set on all
+ * but the last byte. Presses up to 1 s apart take 2 bytes, up to 2 min 3
+ * and the longest delta, REPLAY_DELTA_MAX (4.6 h), 4 bytes.
+ *
+ * The encoding has no hardware access, recorder.c writes the events of
+ * the game to the flash and tools/replay_decode.py reads them on the PC.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_REPLAY_H_
+#define LIBS_REPLAY_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define REPLAY_EVENT_MAX        4               // bytes of an event at most
+#define REPLAY_DELTA_MAX        0xFFFFFFUL      // longer deltas are cut to this
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+typedef struct{
+    unsigned long value;            // bits of the event collected so far, the whole one once it is complete
+    unsigned char shift;            // where the next 7 bits go, 0 before the first byte of an event
+}ReplayDecoder;
+
+// Delta in ms and lane mask of the event replay_decode() completed last
+#define REPLAY_DELTA(d)         ((d)->value >> 4)
+#define REPLAY_MASK(d)          ((unsigned char)((d)->value & 0x0F))
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Write the event of <delta> ms and lane mask <mask> (0 - 15) to <out>,
+ * which has room for REPLAY_EVENT_MAX bytes. Returns the bytes written.
+ */
+unsigned char replay_encode(unsigned char *out, unsigned long delta, unsigned char mask);
+
+/**
+ * Start decoding a new stream with <d>.
+ */
+void replay_start(ReplayDecoder *d);
+
+/**
+ * Feed the next <byte> of the stream to <d>. Returns 1 if it completed an
+ * event, which is then in REPLAY_DELTA(d) and REPLAY_MASK(d) until the
+ * next byte.
+ */
+unsigned char replay_decode(ReplayDecoder *d, unsigned char byte);
+
+#endif /* LIBS_REPLAY_H_ */
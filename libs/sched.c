@@ -0,0 +1,137 @@
+/***************************************************************************//**
+ * @file    sched.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the cooperative task scheduler.
+ *
+ * Every call of sched_dispatch() runs at most one task to completion, then
+ * the table is searched again from the top. So a task never waits longer than
+ * the longest single task run, whatever the lower priority tasks are doing.
+ * The watchdog is cleared on every call, its reset leaves the trace ring for
+ * a post-mortem dump (trace.h).
+ ******************************************************************************/
+
+#include "./sched.h"
+#include "./trace.h"
+#include <stddef.h>
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+const Task *sched_tasks;            // task table, set in sched_init()
+TaskState *sched_states;            // states of the periodic tasks at its start
+unsigned char sched_count = 0;      // number of tasks in the table
+unsigned char sched_periodic = 0;   // number of them with a state
+unsigned int sched_pending = 0;     // bit n: sched_trigger() was called for task n since its last run
+
+#ifdef PROFILE
+unsigned int sched_wcets[SCHED_MAX_TASKS];  // longest run of each task so far in us (worst-case execution time)
+#endif
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void sched_init(const Task *tasks, unsigned char count, TaskState *states, unsigned char periodic){
+    unsigned char i;
+
+    sched_tasks = tasks;
+    sched_states = states;
+    sched_count = count;
+    sched_periodic = periodic;
+    sched_pending = 0;
+    for(i = 0; i < periodic; i++){
+        states[i].period = tasks[i].period;
+        states[i].next = tick_now() + tasks[i].period;
+    }
+    sched_resetWcet();
+    WDTCTL = SCHED_WATCHDOG;
+}
+
+void sched_dispatch(void){
+    unsigned int now = tick_now();
+    unsigned int wake = now + SCHED_MAX_SLEEP;
+    unsigned char i;
+    TaskState *t;
+#ifdef PROFILE
+    unsigned int took;
+    TickStamp start;
+#endif
+
+    WDTCTL = SCHED_WATCHDOG;        // a task which never returns resets the MCU
+    for(i = 0; i < sched_count; i++){
+        t = i < sched_periodic ? &sched_states[i] : NULL;
+
+        if(sched_pending & 1 << i || (t && t->period && (int)(now - t->next) >= 0)){
+            // fixed rate, but don't try to catch up if more than a period late
+            if(t && t->period && (int)(now - t->next) >= 0){
+                t->next += t->period;
+                if((int)(now - t->next) >= 0){
+                    t->next = now + t->period;
+                    TRACE(traceLate, i);
+                }
+            }
+            sched_pending &= ~(1 << i);
+
+#ifdef PROFILE
+            tick_stamp(&start);
+            sched_tasks[i].run();
+            took = tick_elapsedUs(&start);
+            if(took > sched_wcets[i]){
+                sched_wcets[i] = took;
+            }
+#else
+            sched_tasks[i].run();
+#endif
+            return;
+        }
+
+        // remember the earliest deadline for sleeping
+        if(t && t->period && (int)(t->next - wake) < 0){
+            wake = t->next;
+        }
+    }
+
+    // nothing to do; triggers only come from tasks, so none can get lost here
+    tick_sleepUntil(wake);
+}
+
+void sched_trigger(unsigned char id){
+    sched_pending |= 1 << id;
+}
+
+void sched_setPeriod(unsigned char id, unsigned int period){
+    sched_states[id].period = period;
+    sched_states[id].next = tick_now() + period;
+}
+
+unsigned int sched_wcet(unsigned char id){
+#ifdef PROFILE
+    return sched_wcets[id];
+#else
+    return 0;
+#endif
+}
+
+void sched_resetWcet(void){
+#ifdef PROFILE
+    unsigned char i;
+
+    for(i = 0; i < sched_count; i++){
+        sched_wcets[i] = 0;
+    }
+#endif
+}
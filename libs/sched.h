@@ -0,0 +1,92 @@
+/***************************************************************************//**
+ * @file    sched.h
+ * @date    19.10.26
+ *
+ * @brief   Small cooperative run-to-completion task scheduler.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_SCHED_H_
+#define LIBS_SCHED_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include "./tick.h"
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define SCHED_MAX_SLEEP         1000    // longest sleep in ms if no periodic task is due
+
+// Watchdog from ACLK (the VLO, see power_init()) divided by 32768, 1.6 - 8 s.
+// Every sched_dispatch() clears it, so it only resets the MCU if a task or
+// a wait hangs. Longer than SCHED_MAX_SLEEP even with the fastest VLO.
+#define SCHED_WATCHDOG          (WDTPW + WDTCNTCL + WDTSSEL)
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+typedef void (*Task_run)(void);
+
+#define SCHED_MAX_TASKS         16      // bits of the pending mask
+
+// One entry of the task table, which can be const. The position in the
+// table is the priority, the first task is the highest.
+typedef struct{
+    Task_run run;               // function which is called when the task is due
+    unsigned int period;        // ms between two runs at the start, 0 if the task only runs on sched_trigger()
+}Task;
+
+// What the scheduler keeps of a periodic task in RAM. Tasks which only run
+// on sched_trigger() come last in the table and have none.
+typedef struct{
+    unsigned int period;        // ms between two runs, 0 while the task only runs on sched_trigger()
+    unsigned int next;          // tick of the next periodic run
+}TaskState;
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Sets the task table of <count> (at most SCHED_MAX_TASKS) tasks and the
+ * RAM for the states of the first <periodic> of them, only those can be
+ * given a period. All periodic tasks are first due one period from now.
+ * Starts the watchdog, ACLK has to run from the VLO.
+ */
+void sched_init(const Task *tasks, unsigned char count, TaskState *states, unsigned char periodic);
+
+/**
+ * Clears the watchdog and runs the due task with the highest priority.
+ * If no task is due the CPU sleeps until the next periodic task is.
+ * Call this from the main loop forever.
+ */
+void sched_dispatch(void);
+
+/**
+ * Lets task <id> run once as soon as possible.
+ */
+void sched_trigger(unsigned char id);
+
+/**
+ * Changes the period of task <id> (one of the periodic ones), the next run
+ * is one period from now. A period of 0 stops the periodic runs.
+ */
+void sched_setPeriod(unsigned char id, unsigned int period);
+
+/**
+ * Returns the worst-case execution time of task <id> in us. Only measured
+ * if PROFILE is defined for the build (see profile.h), else 0.
+ */
+unsigned int sched_wcet(unsigned char id);
+
+/**
+ * Clears the worst-case execution times of all tasks.
+ */
+void sched_resetWcet(void);
+
+#endif /* LIBS_SCHED_H_ */
@@ -0,0 +1,124 @@
+/***************************************************************************//**
+ * @file    score.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the scoring.
+ *
+ * Everything is only counted up in score_event(), the accuracy is
+ * calculated when it is asked for, so an event never needs a division.
+ ******************************************************************************/
+
+#include "./score.h"
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+// Points per judgement before the multiplier, first row Normal, second Expert.
+const unsigned char score_points[2][3] = {
+    // Perfect,              Great, Good
+    {SCORE_PERFECT_NORMAL,   1,     1},
+    {SCORE_PERFECT_EXPERT,   4,     2},
+};
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+unsigned char score_difficulty = 0;         // row of score_points
+unsigned long score_sum = 0;                // total score
+unsigned int score_streak = 0;              // hits in a row
+unsigned int score_longest = 0;             // longest streak of the song
+unsigned char score_mult;                   // current multiplier, set by score_reset()
+unsigned int score_counts[4];               // number of each enum Judgement
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void score_reset(unsigned char difficulty){
+    unsigned char i;
+
+    score_difficulty = difficulty;
+    score_sum = 0;
+    score_streak = 0;
+    score_longest = 0;
+    score_mult = 1;
+    for(i = 0; i < 4; i++){
+        score_counts[i] = 0;
+    }
+}
+
+unsigned int score_event(unsigned char judgement){
+    unsigned int points;
+
+    score_counts[judgement]++;
+
+    if(judgement == judgeMiss){
+        score_streak = 0;
+        score_mult = 1;
+        if(score_sum > 0){
+            score_sum--;
+        }
+        return 0;
+    }
+
+    points = score_points[score_difficulty][judgement] * score_mult;
+    score_sum += points;
+
+    // the multiplier goes up every SCORE_COMBO_STEP hits in a row
+    score_streak++;
+    if(score_streak > score_longest){
+        score_longest = score_streak;
+    }
+    if(score_mult < SCORE_MAX_MULTIPLIER && score_streak == score_mult * SCORE_COMBO_STEP){
+        score_mult++;
+    }
+    return points;
+}
+
+unsigned long score_total(void){
+    return score_sum;
+}
+
+unsigned int score_combo(void){
+    return score_streak;
+}
+
+unsigned int score_maxCombo(void){
+    return score_longest;
+}
+
+unsigned char score_multiplier(void){
+    return score_mult;
+}
+
+unsigned int score_count(unsigned char judgement){
+    return score_counts[judgement];
+}
+
+unsigned char score_accuracy(void){
+    unsigned long weighted;
+    unsigned long all;
+
+    all = (unsigned long)score_counts[judgePerfect] + score_counts[judgeGreat] +
+          score_counts[judgeGood] + score_counts[judgeMiss];
+    if(all == 0){
+        return 100;
+    }
+    weighted = 100UL * score_counts[judgePerfect] + 75UL * score_counts[judgeGreat] +
+               50UL * score_counts[judgeGood];
+    return weighted / all;
+}
@@ -0,0 +1,93 @@
+/***************************************************************************//**
+ * @file    score.h
+ * @date    19.10.26
+ *
+ * @brief   Score of the running song with combos, multipliers and stats.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_SCORE_H_
+#define LIBS_SCORE_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include "./judge.h"
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+// Points of a Perfect before the multiplier, Great and Good give less,
+// see score_points in score.c.
+#define SCORE_PERFECT_NORMAL    2
+#define SCORE_PERFECT_EXPERT    5
+
+// The multiplier is 1 + combo / SCORE_COMBO_STEP, but at most SCORE_MAX_MULTIPLIER.
+// The combo counts the hits in a row before the current one.
+#define SCORE_COMBO_STEP        10
+#define SCORE_MAX_MULTIPLIER    4
+
+// Sum of the multipliers of <notes> hits in a row, known at build time if
+// <notes> is. Times the points of a Perfect this is the perfect score.
+#define SCORE_OVER(notes, n)    ((notes) > (n) ? (notes) - (n) : 0)
+#define SCORE_MULTIPLIED(notes) ((unsigned long)(notes) +                                  \
+                                 SCORE_OVER(notes, 1 * SCORE_COMBO_STEP) +                 \
+                                 SCORE_OVER(notes, 2 * SCORE_COMBO_STEP) +                 \
+                                 SCORE_OVER(notes, 3 * SCORE_COMBO_STEP))
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Start a new song on the given difficulty (0 Normal, 1 Expert).
+ */
+void score_reset(unsigned char difficulty);
+
+/**
+ * Count one enum Judgement, a hit adds its points times the multiplier,
+ * a miss resets the combo and costs one point. O(1).
+ * Returns the points added, 0 for a miss.
+ */
+unsigned int score_event(unsigned char judgement);
+
+/**
+ * Returns the total score of the song.
+ */
+unsigned long score_total(void);
+
+/**
+ * Returns the number of hits in a row.
+ */
+unsigned int score_combo(void);
+
+/**
+ * Returns the longest combo of the song.
+ */
+unsigned int score_maxCombo(void);
+
+/**
+ * Returns the current multiplier, 1 - SCORE_MAX_MULTIPLIER.
+ */
+unsigned char score_multiplier(void);
+
+/**
+ * Returns how often the enum Judgement <judgement> was counted.
+ */
+unsigned int score_count(unsigned char judgement);
+
+/**
+ * Returns the accuracy in percent, a Perfect counts 100 %, a Great 75 %,
+ * a Good 50 % and a Miss 0 %. 100 if nothing was counted yet.
+ */
+unsigned char score_accuracy(void);
+
+#endif /* LIBS_SCORE_H_ */
@@ -0,0 +1,14 @@
+/***************************************************************************//**
+ * @file    shared.c
+ * @date    19.10.26
+ *
+ * @brief   The RAM of the modes, see shared.h.
+ ******************************************************************************/
+
+#include "./shared.h"
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+SharedRam shared;
@@ -0,0 +1,68 @@
+/***************************************************************************//**
+ * @file    shared.h
+ * @date    19.10.26
+ *
+ * @brief   RAM of the modes of the game, which never run at the same time.
+ *
+ * A song is played, a chart is uploaded (loader.h) or a chart is recorded
+ * (composer.h), one after the other, and the menu shows a leaderboard
+ * (leader.h) in between. Their buffers and state are members of one union
+ * instead of variables of their own, so the RAM of the MCU only has to hold
+ * the largest of them. The chart of a played song comes either from the
+ * flash or from the generator of the endless mode, so those two share their
+ * RAM as well.
+ *
+ * The member of a mode is only valid while it runs: main.c doesn't start a
+ * mode before the flash clients of the last one have programmed what they
+ * still held (task_storage()), and every module sets its member up again in
+ * its *_start() or *_open(). The board is forgotten when a mode starts
+ * (leader_forget()) and only loaded again in the menu, once the recording
+ * of the last song is programmed.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_SHARED_H_
+#define LIBS_SHARED_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include "./game.h"
+#include "./endless.h"
+#include "./leader.h"
+#include "./loader.h"
+#include "./composer.h"
+#include "./recorder.h"
+#include "./replay.h"
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+typedef union{
+    struct{                                             // a song is played
+        Game game;                                      // main.c
+        union{                                          // where the chart comes from
+            struct{
+                Song song;                              // main.c, a song of the flash
+                unsigned char library[LIBRARY_RING];    // library.c, its chart read ahead
+            }flash;
+            EndlessRam endless;                         // endless.c, the generated chart
+        }chart;
+        unsigned char recorder[RECORDER_BUFFER];        // recorder.c, events not programmed yet
+        unsigned char ghost[RECORDER_GHOST];            // recorder.c, the ghost read ahead
+        ReplayDecoder decoder;                          // recorder.c, of the ghost
+    }play;
+    LoaderRam loader;                                   // loader.c, a chart is uploaded
+    struct{                                             // a chart is recorded
+        ComposerRam composer;                           // composer.c
+        unsigned char lane;                             // main.c, lane of its last note, 0 for none yet
+        unsigned char stop;                             // main.c, 1 once the joystick was moved, it ends when let go
+    }compose;
+    LeaderBoard leader;                                 // leader.c, the board of the menu
+}SharedRam;
+
+extern SharedRam shared;
+
+#endif /* LIBS_SHARED_H_ */
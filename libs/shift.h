@@ -1,41 +1,41 @@
-/***************************************************************************//**
- * @file    shift.h
- * @author  Christopher Haas
- * @date    05.07.23
- *
- * @brief A few functions to control the buttons PB1 - PB4 and LCDs with shift register
- *
- ******************************************************************************/
-
-#ifndef LIBS_SHIFT_H_
-#define LIBS_SHIFT_H_
-
-/******************************************************************************
- * INCLUDES
- *****************************************************************************/
-
-#include <msp430g2553.h>
-
-/******************************************************************************
- * CONSTANTS
- *****************************************************************************/
-
-
-
-/******************************************************************************
- * VARIABLES
- *****************************************************************************/
-
-
-
-/******************************************************************************
- * FUNCTION PROTOTYPES
- *****************************************************************************/
-
-void shift_init(void);
-
-void stateLED(unsigned char i);
-
-unsigned char stateButton(void);
-
-#endif /* LIBS_SHIFT_H_ */
+/***************************************************************************//**
+ * @file    shift.h
+ * @author  Christopher Haas
+ * @date    05.07.23
+ *
+ * @brief A few functions to control the buttons PB1 - PB4 and LCDs with shift register
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_SHIFT_H_
+#define LIBS_SHIFT_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include <msp430g2553.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+void shift_init(void);
+
+void stateLED(unsigned char i);
+
+unsigned char stateButton(void);
+
+#endif /* LIBS_SHIFT_H_ */
@@ -0,0 +1,91 @@
+/***************************************************************************//**
+ * @file    songs.c
+ * @date    19.10.26
+ *
+ * @brief   The charts and the song table.
+ *
+ * To add a song write its chart and add one entry to songs[] with
+ * SONG_SCORES(), which derives the scores from the chart at build time.
+ ******************************************************************************/
+
+#include "./songs.h"
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+// Size, notes, perfect and good scores of a chart on Normal and Expert, all
+// taken from the chart by the compiler. The perfect score is every note a
+// Perfect with the full combo (see score.h).
+// Scores have to be above 4/5 of the perfect score to count as good.
+#define SONG_SCORES(chart)                                                              \
+    .size    = sizeof(chart),                                                           \
+    .notes   = CHART_NOTES(chart),                                                      \
+    .perfect = {SCORE_MULTIPLIED(CHART_NOTES(chart)) * SCORE_PERFECT_NORMAL,            \
+                SCORE_MULTIPLIED(CHART_NOTES(chart)) * SCORE_PERFECT_EXPERT},           \
+    .good    = {SCORE_MULTIPLIED(CHART_NOTES(chart)) * SCORE_PERFECT_NORMAL * 4 / 5,    \
+                SCORE_MULTIPLIED(CHART_NOTES(chart)) * SCORE_PERFECT_EXPERT * 4 / 5}
+
+/**
+ * Charts of the three songs in the packed format of chart.h,
+ * lanes 1 - 4 correspond to the button that shall be pressed.
+ * One line per 4 notes.
+ */ 
+const unsigned char chart1[] = {CHART_LENGTH(120),
+                                CHART_NOTE(16, 1), CHART_NOTE( 4, 4), CHART_NOTE( 4, 2), CHART_NOTE( 4, 3),
+                                CHART_NOTE( 4, 3), CHART_NOTE( 2, 3), CHART_NOTE( 4, 1), CHART_NOTE( 4, 4),
+                                CHART_NOTE( 4, 2), CHART_NOTE( 4, 3), CHART_NOTE( 3, 3), CHART_NOTE( 2, 1),
+                                CHART_NOTE( 4, 1), CHART_NOTE( 3, 4), CHART_NOTE( 4, 2), CHART_NOTE( 4, 3),
+                                CHART_NOTE( 4, 3), CHART_NOTE( 2, 3), CHART_NOTE( 4, 1), CHART_NOTE( 4, 2),
+                                CHART_NOTE( 4, 3), CHART_NOTE( 4, 4), CHART_NOTE( 2, 4), CHART_NOTE( 4, 1),
+                                CHART_END};
+
+const unsigned char chart2[] = {CHART_LENGTH(144),
+                                CHART_NOTE(16, 1), CHART_NOTE( 4, 4), CHART_NOTE( 4, 1), CHART_NOTE( 4, 4),
+                                CHART_NOTE( 4, 1), CHART_NOTE( 4, 4), CHART_NOTE( 4, 1), CHART_NOTE( 4, 3),
+                                CHART_NOTE( 4, 1), CHART_NOTE( 3, 2), CHART_NOTE( 3, 3), CHART_NOTE( 3, 4),
+                                CHART_NOTE( 5, 2), CHART_NOTE( 3, 3), CHART_NOTE( 3, 2), CHART_NOTE( 3, 3),
+                                CHART_NOTE( 3, 2), CHART_NOTE( 3, 3), CHART_NOTE( 3, 2), CHART_NOTE( 3, 3),
+                                CHART_NOTE( 5, 1), CHART_NOTE( 3, 2), CHART_NOTE( 3, 3), CHART_NOTE( 3, 4),
+                                CHART_NOTE( 5, 4), CHART_NOTE( 3, 3), CHART_NOTE( 3, 2), CHART_NOTE( 3, 1),
+                                CHART_NOTE( 5, 3), CHART_NOTE( 3, 1), CHART_NOTE( 3, 2), CHART_NOTE( 3, 1),
+                                CHART_END};
+
+const unsigned char chart3[] = {CHART_LENGTH(96),
+                                CHART_NOTE(16, 1), CHART_NOTE( 2, 4), CHART_NOTE( 2, 2), CHART_NOTE( 2, 3),
+                                CHART_NOTE( 2, 1), CHART_NOTE( 2, 4), CHART_NOTE( 2, 3), CHART_NOTE( 2, 2),
+                                CHART_NOTE( 2, 1), CHART_NOTE( 2, 2), CHART_NOTE( 2, 3), CHART_NOTE( 2, 4),
+                                CHART_NOTE( 2, 4), CHART_NOTE( 2, 2), CHART_NOTE( 2, 3), CHART_NOTE( 2, 1),
+                                CHART_NOTE( 2, 1), CHART_NOTE( 2, 4), CHART_NOTE( 2, 2), CHART_NOTE( 2, 3),
+                                CHART_NOTE( 2, 1), CHART_NOTE( 2, 3), CHART_NOTE( 2, 2), CHART_NOTE( 2, 4),
+                                CHART_NOTE( 2, 1), CHART_NOTE( 2, 2), CHART_NOTE( 2, 3), CHART_NOTE( 2, 4),
+                                CHART_NOTE( 2, 4), CHART_NOTE( 2, 1), CHART_NOTE( 2, 4), CHART_NOTE( 2, 1),
+                                CHART_END};
+
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+// Tones are C4, F4, G4, C5 for song 1, C4, D4, E4, F4 for song 2
+// and C5, D5, E5, F5 for song 3.
+const Song songs[SONG_COUNT] = {
+    {
+        .chart = chart1,
+        .tone = {262, 349, 392, 523},
+        .period = 125,
+        SONG_SCORES(chart1),
+    },
+    {
+        .chart = chart2,
+        .tone = {262, 294, 330, 349},
+        .period = 150,
+        SONG_SCORES(chart2),
+    },
+    {
+        .chart = chart3,
+        .tone = {523, 587, 659, 698},
+        .period = 225,
+        SONG_SCORES(chart3),
+    },
+};
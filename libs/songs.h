@@ -0,0 +1,55 @@
+/***************************************************************************//**
+ * @file    songs.h
+ * @date    19.10.26
+ *
+ * @brief   Table of all songs with their charts, tones, tempo and scores.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_SONGS_H_
+#define LIBS_SONGS_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include "./chart.h"
+#include "./score.h"
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define SONG_COUNT              3       // number of entries in songs[]
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+// Returns the ms per slot on Expert from slot <slot> on, for songs whose
+// tempo changes while they are played.
+typedef unsigned int (*SongTempo)(unsigned int slot);
+
+// Everything the game needs to know about one song.
+// Scores are indexed by difficulty, [0] is Normal and [1] is Expert.
+typedef struct{
+    const unsigned char *chart;     // packed chart, see chart.h
+    unsigned int size;              // size of the chart in bytes
+    unsigned int notes;             // number of notes of the chart, 0 if not known before the end
+    unsigned int tone[4];           // value for playNotes() for lane 1 - 4
+    unsigned int period;            // ms per slot on Expert, Normal is twice as long
+    unsigned long perfect[2];       // score if every note was a Perfect
+    unsigned long good[2];          // scores above this are "Very Good!"
+    SongTempo tempo;                // asked at every slot, NULL if period stays
+    unsigned char lives;            // misses until the song ends, 0 if only its chart ends it
+}Song;
+
+extern const Song songs[SONG_COUNT];
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+
+
+#endif /* LIBS_SONGS_H_ */
@@ -0,0 +1,36 @@
+/***************************************************************************//**
+ * @file    stack.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the stack painting.
+ ******************************************************************************/
+
+#include "./stack.h"
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void stack_paint(void){
+    unsigned char *p = STACK_LOW;
+    unsigned char *sp = STACK_POINTER();
+
+    // everything below the stack pointer is free, the return address of
+    // this call is the last thing pushed
+    while(p < sp){
+        *p++ = STACK_PAINT;
+    }
+}
+
+unsigned int stack_used(void){
+    const unsigned char *p = STACK_LOW;
+
+    while(p < STACK_HIGH && *p == STACK_PAINT){
+        p++;
+    }
+    return STACK_HIGH - p;
+}
+
+unsigned int stack_size(void){
+    return STACK_HIGH - STACK_LOW;
+}
@@ -0,0 +1,73 @@
+/***************************************************************************//**
+ * @file    stack.h
+ * @date    19.10.26
+ *
+ * @brief   High-water mark of the stack by painting it at the start.
+ *
+ * stack_paint() fills the free part of the stack section with STACK_PAINT,
+ * stack_used() later looks for the lowest byte which was overwritten. The
+ * stack section is the one of the linker command file, its size is set
+ * with --stack_size in CCS. If stack_used() returns the whole size, the
+ * stack has grown into the variables below it.
+ *
+ * A pushed byte which happens to be STACK_PAINT at the very bottom is
+ * missed, so the mark can be a byte or two low.
+ *
+ * tools/ram_budget.py finds the worst case before running: from the linker
+ * map and the stack usage of every function it adds up the RAM of all
+ * modules and the deepest call chain.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_STACK_H_
+#define LIBS_STACK_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include <msp430g2553.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define STACK_PAINT             0x5A
+
+// Bounds of the stack section, from the linker of CCS. The host simulation
+// has its own in sim/msp430g2553.h.
+#ifndef STACK_LOW
+extern unsigned char _stack;            // lowest address of the stack section
+extern unsigned char __STACK_END;       // one above the highest
+#define STACK_LOW               (&_stack)
+#define STACK_HIGH              (&__STACK_END)
+#define STACK_POINTER()         ((unsigned char *)__get_SP_register())
+#endif
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Paints the stack below the current stack pointer, call it first in main()
+ * while interrupts are still off.
+ */
+void stack_paint(void);
+
+/**
+ * Returns the most bytes of the stack used since stack_paint().
+ */
+unsigned int stack_used(void);
+
+/**
+ * Returns the size of the stack section in bytes.
+ */
+unsigned int stack_size(void);
+
+#endif /* LIBS_STACK_H_ */
@@ -0,0 +1,178 @@
+/***************************************************************************//**
+ * @file    store.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the record in the SPI flash.
+ *
+ * store_copy is the copy of the last complete commit, a commit writes the
+ * other one with the next sequence number. A copy counts if its header has
+ * STORE_MAGIC and the size of the record and the CRC of its record matches.
+ ******************************************************************************/
+
+#include "./store.h"
+#include "./flash.h"
+#include "./uart.h"
+#include "./trace.h"
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define STORE_BLOCK             16          // bytes read from the flash at once
+
+enum StoreState{
+    storeIdle,
+    storeErasing,                           // the older copy is erased
+    storeRecord,                            // its record is programmed
+    storeHeader,                            // its header is programmed
+};
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+unsigned char *store_data;                  // the record in RAM
+unsigned char store_size = 0;
+unsigned char store_copy = 1;               // copy of the last commit, the first goes to A
+unsigned int store_sequence;                // sequence number of the last commit
+unsigned char store_crc;                    // CRC of the record of the running commit
+unsigned char store_state = storeIdle;      // enum StoreState
+unsigned char store_dirty = 0;              // 1 if the record changed since the last commit started programming
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+long int store_address(unsigned char copy);
+unsigned char store_check(unsigned char copy, const StoreHeader *header);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+/**
+ * Returns the flash address of copy <copy>, 0 is A and 1 is B.
+ */
+long int store_address(unsigned char copy){
+    return (long int)(copy ? STORE_SECTOR_B : STORE_SECTOR_A) << 16;
+}
+
+/**
+ * Read the record of <copy> into store_data in blocks. Returns 1 if it
+ * matches the CRC of <header>.
+ */
+unsigned char store_check(unsigned char copy, const StoreHeader *header){
+    unsigned char buffer[STORE_BLOCK + 1];  // flash_read() reads one dummy byte first
+    long int address = store_address(copy) + sizeof(StoreHeader);
+    unsigned char done = 0;
+    unsigned char count, i;
+    unsigned char crc = 0;
+
+    while(done < store_size){
+        count = store_size - done < STORE_BLOCK ? store_size - done : STORE_BLOCK;
+        flash_read(address + done, count, buffer);
+        for(i = 0; i < count; i++){
+            store_data[done + i] = buffer[i + 1];
+            crc = uart_crc8(crc, buffer[i + 1]);
+        }
+        done += count;
+    }
+    return crc == header->crc;
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+unsigned char store_load(unsigned char *data, unsigned char size){
+    unsigned char buffer[sizeof(StoreHeader) + 1];
+    StoreHeader headers[2];
+    unsigned char *bytes;
+    unsigned char valid[2];
+    unsigned char copy, first, i;
+
+    store_data = data;
+    store_size = size;
+    for(copy = 0; copy < 2; copy++){
+        flash_read(store_address(copy), sizeof(StoreHeader), buffer);
+        bytes = (unsigned char *)&headers[copy];
+        for(i = 0; i < sizeof(StoreHeader); i++){
+            bytes[i] = buffer[i + 1];
+        }
+        valid[copy] = headers[copy].magic == STORE_MAGIC && headers[copy].size == size;
+    }
+
+    // the newer copy first, the other one if the newer is broken
+    first = valid[1] && (!valid[0] || (int16_t)(headers[1].sequence - headers[0].sequence) > 0);
+    for(i = 0; i < 2; i++){
+        copy = first ^ i;
+        if(valid[copy] && store_check(copy, &headers[copy])){
+            store_copy = copy;
+            store_sequence = headers[copy].sequence;
+            return 1;
+        }
+    }
+    store_copy = 1;
+    store_sequence = 0;
+    return 0;
+}
+
+void store_mark(void){
+    store_dirty = 1;
+}
+
+unsigned char store_commit(void){
+    if(!store_dirty || store_state != storeIdle || store_size == 0){
+        return 0;
+    }
+    flash_erase(store_address(!store_copy));
+    store_state = storeErasing;
+    return 1;
+}
+
+unsigned char store_poll(void){
+    StoreHeader header;
+    unsigned char i;
+
+    if(store_state == storeIdle){
+        return 0;
+    }
+    if(flash_busy()){
+        return 1;
+    }
+    switch(store_state){
+        case storeErasing:
+            // the record as it is now, later changes need the next commit
+            store_dirty = 0;
+            store_crc = 0;
+            for(i = 0; i < store_size; i++){
+                store_crc = uart_crc8(store_crc, store_data[i]);
+            }
+            flash_program(store_address(!store_copy) + sizeof(StoreHeader), store_size, store_data);
+            store_state = storeRecord;
+            break;
+        case storeRecord:
+            header.magic = STORE_MAGIC;
+            header.sequence = store_sequence + 1;
+            header.size = store_size;
+            header.crc = store_crc;
+            flash_program(store_address(!store_copy), sizeof(StoreHeader), (unsigned char *)&header);
+            store_state = storeHeader;
+            break;
+        case storeHeader:
+            store_copy = !store_copy;           // the new copy is complete
+            store_sequence++;
+            store_state = storeIdle;
+            TRACE(traceStorage, store_copy);
+            return 0;
+    }
+    return 1;
+}
+
+unsigned char store_busy(void){
+    return store_state != storeIdle;
+}
+
+unsigned char store_pending(void){
+    return store_dirty || store_state != storeIdle;
+}
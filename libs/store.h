@@ -0,0 +1,98 @@
+/***************************************************************************//**
+ * @file    store.h
+ * @date    19.10.26
+ *
+ * @brief   Record of the game kept in the SPI flash, written in the background.
+ *
+ * The record (the settings, defined by the game) lives in RAM.
+ * Changing it only marks it with store_mark(). The game starts the commit
+ * with store_commit() when it suits it, store_poll() then steps through
+ * erase and program without ever waiting for the flash. Changes made while
+ * a commit runs are written by the next one, so many changes give one
+ * write.
+ *
+ * There are two copies of the record, A in sector STORE_SECTOR_A and B in
+ * sector STORE_SECTOR_B. A commit always overwrites the older copy:
+ *
+ *      0x00        StoreHeader, programmed last
+ *      0x06        the record, header.size bytes
+ *
+ * If the power fails while a copy is erased or programmed, its header is
+ * missing or its CRC doesn't match and store_load() takes the other one,
+ * so the record of the last complete commit is never lost.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_STORE_H_
+#define LIBS_STORE_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include <stdint.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define STORE_MAGIC             0x5653      // "SV", marks a complete copy
+#define STORE_SECTOR_A          0           // before the songs of library.h
+#define STORE_SECTOR_B          17          // after them
+#define STORE_MAX               250         // bytes of a record, header and record fit into one page
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+// Start of a copy, fields are 16 bit wide where int is wider too (host build)
+typedef struct{
+    uint16_t magic;                 // STORE_MAGIC
+    uint16_t sequence;              // counts the commits, the higher copy is newer
+    uint8_t size;                   // bytes of the record
+    uint8_t crc;                    // CRC-8 of the record, see uart_crc8()
+}StoreHeader;
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Read the newest complete copy into the record <data> of <size> bytes,
+ * which is also the one committed later. The flash has to be selected.
+ * Returns 1 if a copy was found, 0 if <data> has to be filled with defaults.
+ */
+unsigned char store_load(unsigned char *data, unsigned char size);
+
+/**
+ * Mark the record as changed, it is written by the next commit.
+ */
+void store_mark(void);
+
+/**
+ * Start writing the record if it changed, by erasing the older copy.
+ * The flash has to be selected.
+ * Returns 1 if a commit was started, 0 if there is nothing to write or one
+ * is running.
+ */
+unsigned char store_commit(void);
+
+/**
+ * Step a running commit: once the flash is done with the last step the
+ * record, then the header are programmed. The record is taken as it is
+ * when it is programmed. The flash has to be selected.
+ * Returns 1 while the commit runs, 0 once it is done.
+ */
+unsigned char store_poll(void);
+
+/**
+ * Returns 1 while a commit runs.
+ */
+unsigned char store_busy(void);
+
+/**
+ * Returns 1 if the record changed since the last commit or a commit runs.
+ */
+unsigned char store_pending(void);
+
+#endif /* LIBS_STORE_H_ */
@@ -0,0 +1,207 @@
+/***************************************************************************//**
+ * @file    telemetry.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the telemetry frames.
+ *
+ * Frames are written straight into the UART ring buffer, the CRC is
+ * calculated while the bytes are put in.
+ ******************************************************************************/
+
+#include "./telemetry.h"
+#include "./score.h"
+#include "./sched.h"
+#include "./power.h"
+#include "./profile.h"
+#include "./trace.h"
+#include "./stack.h"
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+unsigned int telemetry_lost = 0;        // frames dropped for lack of room
+unsigned char telemetry_crc;            // CRC of the frame being built
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+unsigned char frame_begin(unsigned char type, unsigned char length);
+void frame_put8(unsigned char value);
+void frame_put16(unsigned int value);
+void frame_put32(unsigned long value);
+unsigned char frame_end(void);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+/**
+ * Start a frame, returns 0 and counts it as dropped if it doesn't fit.
+ */
+unsigned char frame_begin(unsigned char type, unsigned char length){
+    if(!uart_reserve(length + 4)){
+        telemetry_lost++;
+        TRACE(traceDropped, type);
+        return 0;
+    }
+    uart_put(TELEMETRY_SYNC);
+    telemetry_crc = 0;
+    frame_put8(type);
+    frame_put8(length);
+    return 1;
+}
+
+void frame_put8(unsigned char value){
+    uart_put(value);
+    telemetry_crc = uart_crc8(telemetry_crc, value);
+}
+
+void frame_put16(unsigned int value){
+    frame_put8(value & 0xFF);
+    frame_put8(value >> 8);
+}
+
+void frame_put32(unsigned long value){
+    frame_put16(value & 0xFFFF);
+    frame_put16(value >> 16);
+}
+
+/**
+ * Add the CRC and send the frame.
+ */
+unsigned char frame_end(void){
+    uart_put(telemetry_crc);
+    uart_commit();
+    return 1;
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+unsigned char telemetry_sendFrame(unsigned char type, const unsigned char *payload, unsigned char length){
+    if(!frame_begin(type, length)){
+        return 0;
+    }
+    while(length--){
+        frame_put8(*payload++);
+    }
+    return frame_end();
+}
+
+unsigned char telemetry_sendScore(unsigned char song, unsigned char difficulty){
+    unsigned char j;
+
+    if(!frame_begin(telemetryScore, 17)){
+        return 0;
+    }
+    frame_put8(song);
+    frame_put8(difficulty);
+    frame_put32(score_total());
+    frame_put16(score_maxCombo());
+    for(j = judgePerfect; j <= judgeMiss; j++){
+        frame_put16(score_count(j));
+    }
+    frame_put8(score_accuracy());
+    return frame_end();
+}
+
+unsigned char telemetry_sendTasks(unsigned char count){
+    unsigned char i;
+
+#ifndef PROFILE
+    count = 0;                              // no times measured, the short frame fits the UART ring
+#endif
+    if(!frame_begin(telemetryTasks, 3 + 2 * count)){
+        return 0;
+    }
+    frame_put16(telemetry_lost);
+    frame_put8(count);
+    for(i = 0; i < count; i++){
+        frame_put16(sched_wcet(i));
+    }
+    return frame_end();
+}
+
+unsigned char telemetry_sendPower(void){
+    PowerStats stats;
+
+    if(!frame_begin(telemetryPower, 12)){
+        return 0;
+    }
+    power_stats(&stats);
+    frame_put32(stats.active);
+    frame_put32(stats.lpm0);
+    frame_put32(stats.lpm3);
+    return frame_end();
+}
+
+unsigned char telemetry_sendProfile(unsigned char region){
+#ifdef PROFILE
+    const ProfileEntry *entry = &profile_regions[region];
+
+    if(!frame_begin(telemetryProfile, 11)){
+        return 0;
+    }
+    frame_put8(region);
+    frame_put16(entry->count);
+    frame_put16(entry->min);
+    frame_put16(entry->max);
+    frame_put32(entry->total);
+    return frame_end();
+#else
+    return 0;
+#endif
+}
+
+unsigned char telemetry_sendBoot(unsigned int ms, unsigned int waited){
+    if(!frame_begin(telemetryBoot, 4)){
+        return 0;
+    }
+    frame_put16(ms);
+    frame_put16(waited);
+    return frame_end();
+}
+
+unsigned char telemetry_sendStack(void){
+    if(!frame_begin(telemetryStack, 4)){
+        return 0;
+    }
+    frame_put16(stack_used());
+    frame_put16(stack_size());
+    return frame_end();
+}
+
+unsigned char telemetry_sendTrace(unsigned int first, unsigned char count){
+    const TraceRecord *record;
+
+    if(!frame_begin(telemetryTrace, 2 + 4 * count)){
+        return 0;
+    }
+    frame_put16(first);
+    while(count--){
+        record = &trace_ring[first++ & (TRACE_SIZE - 1)];
+        frame_put16(record->tick);
+        frame_put8(record->event);
+        frame_put8(record->arg);
+    }
+    return frame_end();
+}
+
+unsigned char telemetry_sendReplay(unsigned int slot, unsigned char offset, const unsigned char *data, unsigned char count){
+    if(!frame_begin(telemetryReplay, 3 + count)){
+        return 0;
+    }
+    frame_put16(slot);
+    frame_put8(offset);
+    while(count--){
+        frame_put8(*data++);
+    }
+    return frame_end();
+}
+
+unsigned int telemetry_dropped(void){
+    return telemetry_lost;
+}
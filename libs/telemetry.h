@@ -0,0 +1,129 @@
+/***************************************************************************//**
+ * @file    telemetry.h
+ * @date    19.10.26
+ *
+ * @brief   Framed binary diagnostics on the UART.
+ *
+ * Every frame is
+ *
+ *      0xA5        sync
+ *      type        enum TelemetryType
+ *      length      number of payload bytes
+ *      payload     numbers little endian (low byte first)
+ *      crc         CRC-8 (polynomial 0x07, start 0) of type, length and payload
+ *
+ * Payloads:
+ *
+ *      telemetryScore      song, difficulty (1 byte each), total (4), max combo (2),
+ *                          Perfect, Great, Good, Miss counts (2 each), accuracy % (1)
+ *      telemetryTasks      dropped frames (2), task count n (1), n times WCET in us (2),
+ *                          n is 0 without PROFILE
+ *      telemetryPower      active, LPM0, LPM3 time in ms (4 each)
+ *      telemetryProfile    region (1), runs (2), min, max (2 each), total (4),
+ *                          all times in Timer1_A counts of 8 cycles
+ *      telemetryTrace      sequence number (2), n times tick (2), event, arg
+ *                          (1 each), see trace.h
+ *      telemetryStack      most bytes of the stack used, size of the stack
+ *                          section (2 each), see stack.h
+ *      telemetryBoot       ms from the start of the tick to the first menu,
+ *                          ms of it waited for the LCD (2 each), sent once
+ *      telemetryReplay     slot (2), offset (1), up to RECORDER_FRAME bytes of the
+ *                          page of a recording from offset on, see recorder.h
+ *
+ * A frame is sent whole or not at all, if the UART is still busy with older
+ * frames it is dropped and counted, so sending never holds up the game.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_TELEMETRY_H_
+#define LIBS_TELEMETRY_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include "./uart.h"
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define TELEMETRY_SYNC          0xA5
+
+enum TelemetryType{
+    telemetryScore = 1,
+    telemetryTasks,
+    telemetryPower,
+    telemetryProfile,
+    telemetryTrace,
+    telemetryStack,
+    telemetryBoot,
+    telemetryReplay,
+};
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Sends a frame of <type> with <length> bytes of <payload>, for frames
+ * of other modules (e.g. the loader).
+ * Returns 1 if the frame was queued, 0 if it was dropped.
+ */
+unsigned char telemetry_sendFrame(unsigned char type, const unsigned char *payload, unsigned char length);
+
+/**
+ * Sends the score of the song just played on difficulty (0 Normal, 1 Expert).
+ * Returns 1 if the frame was queued, 0 if it was dropped.
+ */
+unsigned char telemetry_sendScore(unsigned char song, unsigned char difficulty);
+
+/**
+ * Sends the worst case execution time of the first <count> scheduler tasks,
+ * without PROFILE the frame holds none.
+ */
+unsigned char telemetry_sendTasks(unsigned char count);
+
+/**
+ * Sends the active and sleeping time of power_stats().
+ */
+unsigned char telemetry_sendPower(void);
+
+/**
+ * Sends the profiler counters of <region>, only with PROFILE.
+ */
+unsigned char telemetry_sendProfile(unsigned char region);
+
+/**
+ * Sends the time it took to show the first menu, <ms> of which <waited>
+ * were spent waiting for the LCD.
+ */
+unsigned char telemetry_sendBoot(unsigned int ms, unsigned int waited);
+
+/**
+ * Sends the high-water mark of the stack.
+ */
+unsigned char telemetry_sendStack(void);
+
+/**
+ * Sends <count> records of the trace ring from sequence number <first> on.
+ */
+unsigned char telemetry_sendTrace(unsigned int first, unsigned char count);
+
+/**
+ * Sends <count> bytes <data> of the page of recording <slot> from <offset> on.
+ */
+unsigned char telemetry_sendReplay(unsigned int slot, unsigned char offset, const unsigned char *data, unsigned char count);
+
+/**
+ * Returns the number of frames dropped so far.
+ */
+unsigned int telemetry_dropped(void);
+
+#endif /* LIBS_TELEMETRY_H_ */
@@ -0,0 +1,144 @@
+/***************************************************************************//**
+ * @file    tick.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the 1 ms system tick.
+ *
+ * Timer1_A runs in continuous mode and CCR0 is moved forward by one ms on
+ * every compare interrupt. The counter itself is never reset, so TA1R can
+ * also be used as a free-running time base.
+ ******************************************************************************/
+
+#include "./tick.h"
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+volatile unsigned int tick_ms = 0;          // incremented every ms in the ISR
+volatile unsigned int tick_deadline = 0;    // tick at which a sleeping tick_sleepUntil() has to wake up
+volatile unsigned char tick_sleeping = 0;   // 1 while tick_sleepUntil() waits in LPM0
+volatile unsigned int tick_wraps = 0;       // high word of tick_uptime(), counts overflows of tick_ms
+unsigned long tick_sleptMs = 0;             // time spent in LPM0, see tick_slept()
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void tick_init(void){
+    TA1CTL = TASSEL_2 + ID_3 + MC_2 + TACLR;    // SMCLK / 8, continuous mode
+    TA1CCR0 = TICK_COUNTS_PER_MS;               // first compare after 1 ms
+    TA1CCTL0 = CCIE;                            // enable compare interrupt
+}
+
+unsigned int tick_now(void){
+    return tick_ms;
+}
+
+unsigned long tick_uptime(void){
+    unsigned int ms;
+    unsigned int wraps;
+
+    // read again if the tick ISR ran in between
+    do{
+        ms = tick_ms;
+        wraps = tick_wraps;
+    }while(ms != tick_ms);
+    return ((unsigned long)wraps << 16) | ms;
+}
+
+unsigned long tick_slept(void){
+    return tick_sleptMs;
+}
+
+void tick_addSlept(unsigned int ms){
+    tick_sleptMs += ms;
+}
+
+void tick_stamp(TickStamp *s){
+    // read again if the tick ISR ran in between
+    do{
+        s->ms = tick_ms;
+        s->counts = (TA1R - (TA1CCR0 - TICK_COUNTS_PER_MS)) & 0xFFFF;  // 16 bit even where int is wider
+    }while(s->ms != tick_ms);
+}
+
+unsigned int tick_elapsedUs(const TickStamp *start){
+    TickStamp now;
+    unsigned long counts;
+
+    tick_stamp(&now);
+    counts = (unsigned long)(now.ms - start->ms) * TICK_COUNTS_PER_MS + now.counts - start->counts;
+    counts >>= 1;                               // two counts per us
+    if(counts > 0xFFFF){
+        return 0xFFFF;
+    }
+    return counts;
+}
+
+void tick_sleepUntil(unsigned int deadline){
+    // interrupts are off while checking, so the ISR can't fire between
+    // the check and going to sleep and the wakeup can't get lost
+    unsigned int start;
+
+    __disable_interrupt();
+    tick_deadline = deadline;
+    start = tick_ms;
+    while((int)(tick_ms - deadline) < 0){
+        tick_sleeping = 1;
+        __bis_SR_register(LPM0_bits + GIE);     // sleep, ISR clears LPM0 on exit
+        __disable_interrupt();
+    }
+    tick_sleeping = 0;
+    tick_sleptMs += tick_ms - start;
+    __enable_interrupt();
+}
+
+void tick_periodStart(TickPeriod *p, unsigned int period){
+    p->period = period;
+    p->next = tick_now() + period;
+}
+
+void tick_periodWait(TickPeriod *p){
+    tick_sleepUntil(p->next);
+    p->next += p->period;
+
+    // if the loop body took longer than a whole period don't try to catch up,
+    // just start counting again from now
+    if((int)(tick_now() - p->next) >= 0){
+        p->next = tick_now() + p->period;
+    }
+}
+
+/******************************************************************************
+ * TIMER
+ *****************************************************************************/
+
+/**
+ * Tick interrupt, CCR0 of Timer1_A.
+ * Wakes up tick_sleepUntil() once its deadline is reached.
+ */
+#pragma vector=TIMER1_A0_VECTOR
+__interrupt void Timer1_A0(void)
+{
+    TA1CCR0 += TICK_COUNTS_PER_MS;
+    if(++tick_ms == 0){
+        tick_wraps++;
+    }
+    if(tick_sleeping && (int)(tick_ms - tick_deadline) >= 0){
+        tick_sleeping = 0;
+        __bic_SR_register_on_exit(LPM0_bits);
+    }
+}
@@ -0,0 +1,105 @@
+/***************************************************************************//**
+ * @file    tick.h
+ * @date    19.10.26
+ *
+ * @brief   Fixed 1 ms system tick on Timer1_A and sleeping waits on it.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_TICK_H_
+#define LIBS_TICK_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include <msp430g2553.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+// Timer1_A runs from SMCLK (16 MHz) divided by 8, so one count is 0.5 us
+// and one tick of 1 ms is 2000 counts.
+#define TICK_COUNTS_PER_MS      2000
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+// State of a fixed-rate loop, see tick_periodStart() and tick_periodWait().
+typedef struct{
+    unsigned int period;        // length of one period in ms
+    unsigned int next;          // tick at which the current period ends
+}TickPeriod;
+
+// Timestamp with sub-ms resolution, see tick_stamp() and tick_elapsedUs().
+typedef struct{
+    unsigned int ms;            // tick in ms
+    unsigned int counts;        // Timer1_A counts since the start of that tick
+}TickStamp;
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Starts Timer1_A in continuous mode and enables the 1 ms compare interrupt.
+ * Timer0_A stays free for the buzzer PWM.
+ */
+void tick_init(void);
+
+/**
+ * Returns the current tick in ms. Wraps after 65.5 s, so always compare two
+ * ticks by their (signed) difference.
+ */
+unsigned int tick_now(void);
+
+/**
+ * Returns the ms Timer1_A ran since tick_init() as 32 bit number, the time
+ * in LPM3 (SMCLK off) is not counted.
+ */
+unsigned long tick_uptime(void);
+
+/**
+ * Returns the ms spent in LPM0 since tick_init(), by tick_sleepUntil() and
+ * the ones given to tick_addSlept().
+ */
+unsigned long tick_slept(void);
+
+/**
+ * Counts <ms> which another wait in LPM0 took, while the tick kept
+ * running, in tick_slept().
+ */
+void tick_addSlept(unsigned int ms);
+
+/**
+ * Takes a timestamp with a resolution of one Timer1_A count (0.5 us).
+ */
+void tick_stamp(TickStamp *s);
+
+/**
+ * Returns the time in us passed since <start>, saturates at 65535 us.
+ */
+unsigned int tick_elapsedUs(const TickStamp *start);
+
+/**
+ * Puts the CPU into LPM0 until tick <deadline> is reached.
+ * Returns immediately if the deadline already passed.
+ */
+void tick_sleepUntil(unsigned int deadline);
+
+/**
+ * Starts a fixed-rate loop with the given period in ms.
+ * The first period ends <period> ms from now.
+ */
+void tick_periodStart(TickPeriod *p, unsigned int period);
+
+/**
+ * Sleeps until the end of the current period and starts the next one.
+ * Periods are counted from the previous deadline, not from the time of the
+ * call, so the work done inside the loop does not add to the period.
+ */
+void tick_periodWait(TickPeriod *p);
+
+#endif /* LIBS_TICK_H_ */
@@ -0,0 +1,140 @@
+/***************************************************************************//**
+ * @file    trace.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the trace ring.
+ *
+ * trace_count numbers the records, the record n is stored at
+ * trace_ring[n % TRACE_SIZE]. A dump always starts TRACE_SIZE records back,
+ * records which were never written have the event 0 and are left out by
+ * the PC. The records of a dump are never overwritten before they are
+ * sent: after a reset the boot logs more events than the ring holds before
+ * the UART has sent the first frame.
+ ******************************************************************************/
+
+#include "./trace.h"
+#include "./tick.h"
+#include "./telemetry.h"
+#include <stddef.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define TRACE_MASK              (TRACE_SIZE - 1)
+#define RESET_FLAGS             (WDTIFG | RSTIFG | PORIFG)
+
+// Dump request of the PC, the CRC-8 is the one of traceRequest and 0
+const unsigned char trace_requestFrame[4] = {TELEMETRY_SYNC, traceRequest, 0, 0xF9};
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+// Not cleared by the startup code, so they survive a reset, see trace_init()
+#pragma NOINIT(trace_ring)
+TraceRecord trace_ring[TRACE_SIZE];
+#pragma NOINIT(trace_count)
+unsigned int trace_count;                   // sequence number of the next record
+#pragma NOINIT(trace_magic)
+unsigned int trace_magic;                   // TRACE_MAGIC if the ring is valid
+
+unsigned int trace_sent;                    // sequence number of the next record to dump
+unsigned int trace_end;                     // trace_count when the dump was requested, a dump runs while not trace_sent
+volatile unsigned char trace_matched = 0;   // bytes of trace_requestFrame received, all of them until trace_poll() starts the dump
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+void trace_receive(unsigned char byte);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+/**
+ * Look for a dump request in the received bytes, called from the RX
+ * interrupt. The dump itself is started by trace_poll().
+ */
+void trace_receive(unsigned char byte){
+    if(trace_matched == sizeof(trace_requestFrame)){
+        return;                             // the request waits for trace_poll()
+    }
+    if(byte == trace_requestFrame[trace_matched]){
+        trace_matched++;
+    }
+    else{
+        trace_matched = byte == TELEMETRY_SYNC;
+    }
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void trace_init(void){
+    unsigned char flags = IFG1 & RESET_FLAGS;
+    unsigned char i;
+
+    IFG1 &= ~RESET_FLAGS;
+    trace_sent = 0;
+    trace_end = 0;
+    trace_matched = 0;
+    if(!(flags & WDTIFG) || trace_magic != TRACE_MAGIC){
+        for(i = 0; i < TRACE_SIZE; i++){
+            trace_ring[i].event = 0;
+        }
+        trace_count = 0;
+        trace_magic = TRACE_MAGIC;
+    }
+    TRACE(traceReset, flags);
+    if(flags & WDTIFG){
+        TRACE(traceDump, 1);
+        trace_request();
+    }
+}
+
+void trace_log(unsigned char event, unsigned char arg){
+    TraceRecord *record;
+
+    if(trace_sent != trace_end && trace_count - trace_sent >= TRACE_SIZE){
+        return;                             // the dump still has to send the record it would overwrite
+    }
+    record = &trace_ring[trace_count++ & TRACE_MASK];
+    record->tick = tick_now();
+    record->event = event;
+    record->arg = arg;
+}
+
+void trace_listen(void){
+    trace_matched = 0;
+    uart_receive(trace_receive);
+}
+
+void trace_request(void){
+    trace_end = trace_count;
+    trace_sent = trace_end - TRACE_SIZE;
+}
+
+unsigned char trace_poll(void){
+    unsigned int count;
+
+    if(trace_matched == sizeof(trace_requestFrame)){
+        trace_matched = 0;
+        TRACE(traceDump, 0);
+        trace_request();
+    }
+
+    count = trace_end - trace_sent;
+    if(count == 0){
+        return 0;
+    }
+    if(count > TRACE_FRAME){
+        count = TRACE_FRAME;
+    }
+    if(uart_room() >= 6 + 4 * count && telemetry_sendTrace(trace_sent, count)){
+        trace_sent += count;
+    }
+    return 1;
+}
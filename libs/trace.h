@@ -0,0 +1,119 @@
+/***************************************************************************//**
+ * @file    trace.h
+ * @date    19.10.26
+ *
+ * @brief   Ring of the last events of drivers and game for post-mortem dumps.
+ *
+ * TRACE(event, arg) stores a record of 4 bytes: the tick in ms, the event
+ * (enum TraceEvent) and one byte of argument. The oldest record is
+ * overwritten, so the ring always holds the last TRACE_SIZE events. It is
+ * cheap enough to stay in every build, a record costs a call and four
+ * stores. TRACE() must only be used from the main loop, not from interrupts.
+ *
+ * The ring isn't cleared by the startup code. After a reset by the watchdog,
+ * which the scheduler clears (sched.h), it still holds the events before
+ * the hang and is dumped as soon as the UART runs. A dump can also be requested from the PC with the frame
+ *
+ *      0xA5, traceRequest, 0, CRC-8
+ *
+ * in the menu or in "Upload Song". The MSP answers with telemetryTrace frames
+ * (see telemetry.h), each holds the sequence number of its first record (2)
+ * and up to TRACE_FRAME records: tick (2), event (1), arg (1). While a
+ * dump runs, events which would overwrite a record it hasn't sent yet are
+ * dropped. tools/trace_dump.py requests and prints a dump.
+ *
+ * The ring holds 4 records, 16 bytes, instead of a few hundred bytes: the
+ * G2553 has 512 bytes of RAM and with the deepest stack less than 32 of them
+ * are left (make model, tests/golden/budget.txt), each record more takes 4.
+ * Four records still show what led to a watchdog reset. A build for a part
+ * with more RAM can set TRACE_SIZE to a larger power of 2.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_TRACE_H_
+#define LIBS_TRACE_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include <msp430g2553.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#ifndef TRACE_SIZE
+#define TRACE_SIZE              4           // records, power of 2, can be set for the build
+#endif
+#define TRACE_FRAME             4           // records per telemetryTrace frame, fits the UART buffer
+#define TRACE_MAGIC             0x5452      // "TR", the ring survived a reset
+
+#define traceRequest            0x30        // frame type of a dump request from the PC
+
+#define TRACE(event, arg)       trace_log(event, arg)
+
+enum TraceEvent{
+    traceReset = 1,             // start of the firmware, arg IFG1 (WDTIFG, RSTIFG, PORIFG)
+    traceState,                 // arg enum GameState of main.c
+    traceSong,                  // song started, arg its index in the menu
+    tracePress,                 // arg buttons of a new press
+    traceIdle,                  // arg 1 into LPM3, 0 out of it
+    traceLate,                  // task more than a period late, arg its id
+    traceI2cNack,               // write not acknowledged, arg slave address
+    traceFlashErase,            // arg sector (64 KB) of the address
+    traceFlashProgram,          // arg sector (64 KB) of the page
+    traceStorage,               // settings record written, arg the copy (0 A, 1 B)
+    traceDropped,               // telemetry frame dropped, arg its type
+    traceLoader,                // upload frame rejected, arg enum LoaderStatus
+    traceDump,                  // dump started, arg 1 after a watchdog reset
+    traceLeader,                // leaderboard appended to its log, arg the board
+    traceRecorder,              // recording complete, arg bytes of its events
+    traceComposer,              // recorded chart complete, arg its library slot
+};
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+typedef struct{
+    unsigned int tick;          // tick_now() of the event
+    unsigned char event;        // enum TraceEvent
+    unsigned char arg;
+}TraceRecord;
+
+extern TraceRecord trace_ring[TRACE_SIZE];
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Keeps the ring if the reset was done by the watchdog and starts its dump,
+ * else clears it. Records traceReset, call it right after initMSP().
+ */
+void trace_init(void);
+
+/**
+ * Stores a record of <event> with <arg>, use TRACE().
+ */
+void trace_log(unsigned char event, unsigned char arg);
+
+/**
+ * Listens on the UART for a dump request. The loader takes the UART over
+ * while uploading and passes the request on.
+ */
+void trace_listen(void);
+
+/**
+ * Starts a dump of the ring.
+ */
+void trace_request(void);
+
+/**
+ * Sends the next frames of a running dump as far as the UART has room.
+ * Returns 1 while the dump isn't complete.
+ */
+unsigned char trace_poll(void);
+
+#endif /* LIBS_TRACE_H_ */
@@ -0,0 +1,129 @@
+/***************************************************************************//**
+ * @file    uart.c
+ * @date    19.10.26
+ *
+ * @brief   Implementation of the interrupt driven UART.
+ *
+ * uart_head is only moved by the writer and uart_tail only by the TX
+ * interrupt, so the ring needs no locking. Bytes from uart_put() are
+ * written behind uart_head and only seen by the interrupt on uart_commit().
+ ******************************************************************************/
+
+#include "./uart.h"
+#include "./hal.h"
+#include <stddef.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+// Position after <index> in the ring, which isn't a power of 2
+#define TX_NEXT(index)          ((index) == UART_TX_SIZE - 1 ? 0 : (index) + 1)
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+unsigned char uart_tx[UART_TX_SIZE];
+volatile unsigned char uart_head = 0;       // next byte to be queued
+volatile unsigned char uart_tail = 0;       // next byte to be sent
+unsigned char uart_fill = 0;                // next byte of uart_put()
+UartReceiver uart_receiver = NULL;          // gets the received bytes
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void uart_txIsr(void){
+    if(uart_tail == uart_head){
+        IE2 &= ~UCA0TXIE;
+        return;
+    }
+    UCA0TXBUF = uart_tx[uart_tail];
+    uart_tail = TX_NEXT(uart_tail);
+}
+
+void uart_rxIsr(void){
+    unsigned char byte = UCA0RXBUF;         // reading clears UCA0RXIFG
+
+    if(uart_receiver != NULL){
+        uart_receiver(byte);
+    }
+}
+
+void uart_init(void){
+    UCA0CTL1 |= UCSWRST;
+    uart_head = 0;                          // the simulation keeps the RAM over a reset
+    uart_tail = 0;
+    HAL_SECONDARY(BOARD_UART_PINS);         // P1.1 = RXD, P1.2 = TXD
+    UCA0CTL1 |= UCSSEL_2;                   // SMCLK
+    UCA0BR0 = UART_DIVIDER & 0xFF;
+    UCA0BR1 = UART_DIVIDER >> 8;
+    UCA0MCTL = UART_MODULATION << 1;        // UCBRSx
+    UCA0CTL1 &= ~UCSWRST;
+}
+
+unsigned char uart_room(void){
+    unsigned char tail = uart_tail;
+
+    return tail > uart_head ? tail - uart_head - 1 : UART_TX_SIZE - 1 - (uart_head - tail);
+}
+
+unsigned char uart_busy(void){
+    return uart_head != uart_tail || (UCA0STAT & UCBUSY);
+}
+
+void uart_drain(void){
+    // interrupts are off while checking, like in tick_sleepUntil()
+    __disable_interrupt();
+    while(uart_head != uart_tail){
+        __bis_SR_register(LPM0_bits + GIE); // the empty ring wakes up, see USCIAB0TX_ISR()
+        __disable_interrupt();
+    }
+    __enable_interrupt();
+    while(UCA0STAT & UCBUSY);               // one byte at most
+}
+
+unsigned char uart_write(const unsigned char *data, unsigned char length){
+    if(!uart_reserve(length)){
+        return 0;
+    }
+    while(length--){
+        uart_put(*data++);
+    }
+    uart_commit();
+    return 1;
+}
+
+unsigned char uart_reserve(unsigned char length){
+    uart_fill = uart_head;
+    return length <= uart_room();
+}
+
+void uart_put(unsigned char byte){
+    uart_tx[uart_fill] = byte;
+    uart_fill = TX_NEXT(uart_fill);
+}
+
+void uart_commit(void){
+    uart_head = uart_fill;
+    IE2 |= UCA0TXIE;                        // UCA0TXIFG is set while idle, so this starts sending
+}
+
+void uart_receive(UartReceiver receiver){
+    IE2 &= ~UCA0RXIE;
+    uart_receiver = receiver;
+    if(receiver != NULL){
+        IE2 |= UCA0RXIE;
+    }
+}
+
+unsigned char uart_crc8(unsigned char crc, unsigned char byte){
+    unsigned char i;
+
+    crc ^= byte;
+    for(i = 0; i < 8; i++){
+        crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+    return crc;
+}
@@ -0,0 +1,132 @@
+/***************************************************************************//**
+ * @file    uart.h
+ * @date    19.10.26
+ *
+ * @brief   Interrupt driven UART on USCI_A0 (P1.1 RXD, P1.2 TXD).
+ *
+ * Bytes to send are put into a ring buffer and the TX interrupt sends them
+ * in the background, so writing never waits for the line. If there is no
+ * room for a write nothing of it is queued, the caller decides to drop it.
+ *
+ * A write can also be built in place: uart_reserve() makes room,
+ * uart_put() fills it and uart_commit() hands it to the interrupt.
+ *
+ * Received bytes are handed one by one to a receiver function, called
+ * from the RX interrupt, see uart_receive().
+ *
+ * Replaces the blocking UART of templateEMP, which stays disabled.
+ *
+ ******************************************************************************/
+
+#ifndef LIBS_UART_H_
+#define LIBS_UART_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include <msp430g2553.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#ifndef UART_BAUD
+#define UART_BAUD               115200UL        // can be set for the build
+#endif
+
+#define UART_CLOCK              16000000UL      // SMCLK, set by initMSP()
+
+// Divider and modulation for UCA0BR and UCBRSx, see the family guide 15.3.10
+#define UART_DIVIDER            (UART_CLOCK / UART_BAUD)
+#define UART_MODULATION         ((UART_CLOCK * 8 + UART_BAUD / 2) / UART_BAUD - UART_DIVIDER * 8)
+
+// Ring buffer size, holds the longest frame whole: telemetryReplay with 4
+// bytes of framing, 3 of header and RECORDER_FRAME (16) of the page is 23,
+// with PROFILE telemetryTasks with the times of the 10 tasks of main.c is
+// 27. A larger ring would only queue more frames, each byte of it is RAM
+// the modes need (see shared.h), at 115200 baud it empties in 2 ms.
+#ifdef PROFILE
+#define UART_TX_SIZE            32
+#else
+#define UART_TX_SIZE            24
+#endif
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+typedef void (*UartReceiver)(unsigned char byte);
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+/**
+ * Sets up USCI_A0 with UART_BAUD, 8N1.
+ */
+void uart_init(void);
+
+/**
+ * TX interrupt, sends the next byte or stops when the ring is empty.
+ * Called by USCIAB0TX_ISR() of common_isr.c for UCA0TXIFG.
+ */
+void uart_txIsr(void);
+
+/**
+ * RX interrupt, hands the byte to the receiver. Called by USCIAB0RX_ISR()
+ * of common_isr.c for UCA0RXIFG.
+ */
+void uart_rxIsr(void);
+
+/**
+ * Returns how many bytes can be queued right now.
+ */
+unsigned char uart_room(void);
+
+/**
+ * Returns 1 while bytes are queued or still being sent, 0 else.
+ */
+unsigned char uart_busy(void);
+
+/**
+ * Sleeps in LPM0 until the TX interrupt sent the queued bytes, then waits
+ * for the last one to leave the shift register. Call before a sleep which
+ * stops SMCLK.
+ */
+void uart_drain(void);
+
+/**
+ * Queues <length> bytes of <data>. Returns 1, or 0 if there was no room,
+ * then nothing was queued.
+ */
+unsigned char uart_write(const unsigned char *data, unsigned char length);
+
+/**
+ * Makes room for <length> bytes to be filled by uart_put().
+ * Returns 1, or 0 if there is not enough room.
+ */
+unsigned char uart_reserve(unsigned char length);
+
+/**
+ * Puts one byte into the room made by uart_reserve().
+ */
+void uart_put(unsigned char byte);
+
+/**
+ * Starts sending the bytes given to uart_put().
+ */
+void uart_commit(void);
+
+/**
+ * Calls <receiver> from the RX interrupt for every received byte,
+ * NULL turns receiving off.
+ */
+void uart_receive(UartReceiver receiver);
+
+/**
+ * Adds <byte> to the CRC-8 (polynomial 0x07) <crc>, start with 0.
+ */
+unsigned char uart_crc8(unsigned char crc, unsigned char byte);
+
+#endif /* LIBS_UART_H_ */
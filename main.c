@@ -1,664 +1,1407 @@
-/***************************************************************************//**
- * @file    main.c
- * @author  Christopher Haas
- * @date    04.07.23
- *
- * @brief   Exercise 5 - Project
- *
- *
- * Pin connections (all are the same as from previous exercises, only Buzzer and Shift reg. new):
- *
- *          LCD related:
- *                          RS <-> P3.0, R/W <-> P3.1, E <-> P3.2
- *                          D4 <-> P2.0, D5 <-> P2.1, D6 <-> P2.2, D7 <-> P2.3
- *                          Also set JP1, (JP2,) JP3 to left side (arrow).
- *
- *          I2C + ADAC related:
- *                          P1.6 <-> XSCL, P1.7 <-> XSDA, P1.3 <-> I2C_/SPI
- *
- *          SPI + Flash related:
- *                          P1.5 <-> CC_CLK, CC_SO <-> F_SO, CC_SI <-> F_SI, CC_CLK <-> F_CLK
- *                          P3.4 <-> F_/CS, P3.3 <-> F_/HOLD, P3.5 <-> F_/WP
- *
- *          Buzzer related:
- *                          P3.6 <-> BUZZER, JP5 to VFO
- *
- *          Shift register related:
- *                          Set jumpers on Port 2 for P2.7 to P2.2
- *
- *
- * For detailed description of the project refer to the video.
- *
- * @note    The project was exported using CCS 8.0.0.
- *
- ******************************************************************************/
-
-#include "libs/templateEMP.h"   // UART disabled, see @note!
-#include "libs/lcd.h"
-#include "libs/adac.h"
-#include "libs/flash.h"
-#include "libs/shift.h"
-#include "libs/pwm.h"
-#include <stddef.h>
-
-
-/******************************************************************************
- * CONSTANTS or GAMEPARAMETERS
- *****************************************************************************/
-
-#define delay_gameover         48000000     // how long game over screen is held, 3 real-time seconds
-#define delay_menu              3200000     // how fast menu gets updated, 0.2 real-time seconds
-#define delay_tone               800000     // how long tone is played when button pressed in game, 50ms real time
-#define delay_song1             2000000     // how fast notes move in game for song 1
-#define delay_song2             2400000     // how fast notes move in game for song 2
-#define delay_song3             3600000     // how fast notes move in game for song 3
-
-#define song1_note1                 262     // frequency of tone 1 of song 1, C4
-#define song1_note2                 349     // frequency of tone 2 of song 1, F4
-#define song1_note3                 392     // frequency of tone 3 of song 1, G4
-#define song1_note4                 523     // frequency of tone 4 of song 1, C5
-
-#define song2_note1                 262     // frequency of tone 1 of song 2, C4
-#define song2_note2                 294     // frequency of tone 2 of song 2, D4
-#define song2_note3                 330     // frequency of tone 3 of song 2, E4
-#define song2_note4                 349     // frequency of tone 4 of song 2, F4
-
-#define song3_note1                 523     // frequency of tone 1 of song 3, C5
-#define song3_note2                 587     // frequency of tone 2 of song 3, D5
-#define song3_note3                 659     // frequency of tone 3 of song 3, E5
-#define song3_note4                 698     // frequency of tone 4 of song 3, F5
-
-/**
- * Arrays for storing which chars will be displayed.
- * 1 - 4 in this will correspond to the button that shall
- * be pressed. There are three songs in total.
- */ 
-const unsigned char notes1[] = {' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
-                                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
-                                '1', ' ', ' ', ' ', '4', ' ', ' ', ' ',
-                                '2', ' ', ' ', ' ', '3', ' ', ' ', ' ',
-                                '3', ' ', '3', ' ', ' ', ' ', '1', ' ',
-                                ' ', ' ', '4', ' ', ' ', ' ', '2', ' ',
-                                ' ', ' ', '3', ' ', ' ', '3', ' ', '1',
-                                ' ', ' ', ' ', '1', ' ', ' ', '4', ' ',
-                                ' ', ' ', '2', ' ', ' ', ' ', '3', ' ',
-                                ' ', ' ', '3', ' ', '3', ' ', ' ', ' ',
-                                '1', ' ', ' ', ' ', '2', ' ', ' ', ' ',
-                                '3', ' ', ' ', ' ', '4', ' ', '4', ' ',
-                                ' ', ' ', '1', ' ', ' ', ' ', ' ', ' ',
-                                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
-                                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',};
-
-const unsigned char notes2[] = {' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
-                                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
-                                '1', ' ', ' ', ' ', '4', ' ', ' ', ' ',
-                                '1', ' ', ' ', ' ', '4', ' ', ' ', ' ',
-                                '1', ' ', ' ', ' ', '4', ' ', ' ', ' ',
-                                '1', ' ', ' ', ' ', '3', ' ', ' ', ' ',
-                                '1', ' ', ' ', '2', ' ', ' ', '3', ' ',
-                                ' ', '4', ' ', ' ', ' ', ' ', '2', ' ',
-                                ' ', '3', ' ', ' ', '2', ' ', ' ', '3',
-                                ' ', ' ', '2', ' ', ' ', '3', ' ', ' ',
-                                '2', ' ', ' ', '3', ' ', ' ', ' ', ' ',
-                                '1', ' ', ' ', '2', ' ', ' ', '3', ' ',
-                                ' ', '4', ' ', ' ', ' ', ' ', '4', ' ',
-                                ' ', '3', ' ', ' ', '2', ' ', ' ', '1',
-                                ' ', ' ', ' ', ' ', '3', ' ', ' ', '1',
-                                ' ', ' ', '2', ' ', ' ', '1', ' ', ' ',
-                                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
-                                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',};
-
-const unsigned char notes3[] = {' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
-                                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
-                                '1', ' ', '4', ' ', '2', ' ', '3', ' ',
-                                '1', ' ', '4', ' ', '3', ' ', '2', ' ',
-                                '1', ' ', '2', ' ', '3', ' ', '4', ' ',
-                                '4', ' ', '2', ' ', '3', ' ', '1', ' ',
-                                '1', ' ', '4', ' ', '2', ' ', '3', ' ',
-                                '1', ' ', '3', ' ', '2', ' ', '4', ' ',
-                                '1', ' ', '2', ' ', '3', ' ', '4', ' ',
-                                '4', ' ', '1', ' ', '4', ' ', '1', ' ',
-                                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
-                                ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',};
-
-
-/******************************************************************************
- * VARIABLES
- *****************************************************************************/
-
-enum GameState{
-    menus,
-    ingame,
-    gameover,
-};
-
-enum MenuPoint{
-    chooseSong,
-    playSong1,
-    playSong2,
-    playSong3,
-    chooseDifficulty,
-    setDifficultyNormal,
-    setDifficultyHard,
-    resetScore,
-    chooseName,
-    setName,
-    chooseScore,
-    score1,
-    score2,
-    score3,
-};
-
-typedef struct{
-    const char* text;                         // name to be displayed
-    unsigned char up, down, left, right, bt;  // flags for symbols shown
-    unsigned char scores;                     // 255: no score, else index of it
-    unsigned char customName;                 // 1 to show the custom name, 0 else
-}MenuEntry;
-
-enum Difficulty{
-    normal,
-    hard,
-};
-
-enum SongChoice{
-    song1,
-    song2,
-    song3,
-};
-
-enum GameState game_state = menus;
-enum MenuPoint menu_point = chooseSong;
-enum Difficulty difficulty = normal;
-enum SongChoice song_choice = song1;
-
-// Init the Lookup table for menupoints elements, used in drawMenu function
-const MenuEntry menuEntries[] = {
-    [chooseSong]         = {"Play a Song",    0,1,0,1,0,  255, 0},
-    [playSong1]          = {"Song 1",         0,1,1,0,1,  255, 0},
-    [playSong2]          = {"Song 2",         1,1,0,0,1,  255, 0},
-    [playSong3]          = {"Song 3",         1,0,0,0,1,  255, 0},
-    [chooseDifficulty]   = {"Difficulty",     1,1,0,1,0,  255, 0},
-    [setDifficultyNormal]= {"Normal",         0,1,1,0,1,  255, 0},
-    [setDifficultyHard]  = {"Expert",         1,0,0,0,1,  255, 0},
-    [resetScore]         = {"Reset?",         1,0,0,0,1,  255, 0},
-    [chooseName]         = {"Player Name",    1,1,0,1,0,  255, 0},
-    [setName]            = {NULL,             0,1,1,0,0,  255, 1},
-    [chooseScore]        = {"Highscore",      1,0,0,1,0,  255, 0},
-    [score1]             = {"Score Song1:",   0,1,1,0,0,  0,   0},
-    [score2]             = {"Score Song2:",   0,1,1,0,0,  1,   0},
-    [score3]             = {"Score Song3:",   0,1,1,0,0,  2,   0},
-};
-
-unsigned char score;                            // variable to store the current score
-unsigned char bestScores[3];                    // stored values of best scores of all time for three songs
-
-unsigned char note_count = 0;                   // used as control variable to play the songs (and display them)
-                                                // can be interpreted as follows:
-                                                // note_count is @0, then notesX[0], ..., notesX[15] will be displayed
-                                                // note_count is @1, then notesX[1], ..., notesX[16] will be displayed etc.
-
-unsigned char cursor_position = 0;              // used to keep track where we are when in naming menu
-unsigned char joystick[2];                      // ADAC value from joystick is stored
-                                                // first entry is horizontal position, second is vertical
-
-unsigned char name[4] = {'a', 'a', 'a', 'a'};   // Array to store the chosen name, limited to 4 chars, could be more if wanted
-unsigned char scoresW[3] = {0, 0, 0};           // Only needed if you want to reset the highscore
-unsigned char scoresR[4] = {};                  // Array to read out the highscore values from the flash on init
-
-
-/******************************************************************************
- * GAME FUNCTIONS
- *****************************************************************************/
-
-/**
- * Init all necessary functions.
- * Also access the stored highscores on the flash.
- */
-void init_all(void){
-    initMSP();                                            
-    flash_init(); flash_read(0, 4, scoresR);              // read the stored scores values on the flash
-    bestScores[0] = scoresR[1];                           // best scores for first song
-    bestScores[1] = scoresR[2];                           // best scores for second song
-    bestScores[2] = scoresR[3];                           // best scores for third song
-    shift_init(); lcd_init(); adac_init(); pwm_init();    // init used modules, see lib files
-    create_custom_char_one(); create_custom_char_two(); 
-    create_custom_char_three();                           // for the custom chars displayed
-}
-
-
-/**
- * Used to change the name in the respective submenu (menu_point == setName).
- * Function uses the read-out joystick values and then chooses the action.
- */
-void modifyName(void){
-    if(joystick[1] == 0) name[cursor_position]++;                             // joystick up, increment char on display
-    else if(joystick[1] == 255) name[cursor_position]--;                      // joystick down, decrement char on display
-    if((joystick[0] == 0) && (cursor_position < 3)) cursor_position++;        // joystick to right, increment cursor
-    else if((joystick[0] == 255) && (cursor_position > 0)) cursor_position--; // joystick to left, decrement cursor
-}
-
-
-/**
- * Function to draw the current menu view.
- * First line is always the fixed gametitle,
- * second line depends on which menu_point we
- * are currently in.
- */
-void drawMenu(){
-    lcd_clear();
-    const MenuEntry *entry = &menuEntries[menu_point];
-
-    // First line drawn, always the same
-    lcd_putChar(0x00); lcd_putChar(0x00);
-    lcd_putChar(' '); lcd_putText("Synth Hero"); lcd_putChar(' ');
-    lcd_putChar(0x00); lcd_putChar(0x00);
-    
-    // Second line drawn, depends on menu_point
-    lcd_cursorSet(0, 1);
-    
-    // First check in which menu we are and draw the strings
-    if(entry->customName){
-        for(unsigned char i = 0; i < 4; i++){
-            lcd_putChar(name[i]);
-        }
-    }
-    else if(entry->scores != 255){
-        lcd_putText(entry->text);
-        lcd_putNumber(bestScores[entry->scores]);
-    }
-    else{
-        lcd_putText(entry->text);
-    }
-    
-    // Now draw arrow and button elements to indicate where we can navigate
-    if(entry->up) {
-        lcd_cursorSet(15, 1);
-        lcd_putChar(0x04);
-    }
-    if(entry->down) {
-        lcd_cursorSet(14, 1);
-        lcd_putChar(0x02);
-    }
-    if(entry->left) {
-        lcd_cursorSet(12, 1);
-        lcd_putChar(0x7F);
-    }
-    if(entry->right) {
-        lcd_cursorSet(13, 1);
-        lcd_putChar(0x7E);
-    }
-    if(entry->bt) {
-        lcd_cursorSet(11, 1);
-        lcd_putChar(0x6F);
-    }
-    
-    // This is needed to set the cursor to the right position
-    // in naming menu, where cursor show is on to allow the user
-    // to enter a name and then also turn it on
-    if(menu_point == setName){
-        lcd_cursorSet(cursor_position, 1);
-        lcd_cursorShow(1);
-    }
-}
-
-
-/**
- * Function to navigate up, down, left, right in the menu.
- * Depending on joystick value which are global,
- * global variable menu_point gets modified.
- * Function returns 1 if something changed, 0 else (so that we
- * only draw when a change is registered).
- */
-unsigned char navigateMenu(){
-    const MenuEntry *entry = &menuEntries[menu_point];
-    
-    // joystick up
-    if(joystick[1] == 0){
-        if(entry->up){
-            menu_point = mappingUp[menu_point];
-            return 1;    
-        }
-    }
-    // joystick down
-    else if(joystick[1] == 255){
-        if(entry->down){
-            menu_point = mappingDown[menu_point];
-            return 1;  
-        }
-    }
-    // joystick right
-    if(joystick[0] == 0){
-        if(entry->right){
-            menu_point = mappingRight[menu_point];
-            return 1;   
-        }
-    }
-    // joystick left
-    else if(joystick[0] == 255){
-        if(entry->left){
-            menu_point = mappingLeft[menu_point];
-            return 1;  
-        }
-    }
-    
-    // special case in the naming menu
-    if(menu_point == setName){
-        if(cursor_position == 0 && joystick[0] == 255){
-            menu_point = chooseName;
-            lcd_cursorShow(0);
-            return 1;
-        }
-        if(joystick[0] == 0 || joystick[0] == 255 || 
-           joystick[1] == 0 || joystick[1] == 255) {
-            modifyName();
-            return 1;
-           }
-    }
-    return 0;
-}
-
-
-/**
- * Function to process pressed button in menu_points which allow to.
- * Can be used while in menu_point playSongX and setDifficultyX.
- * This function switches the game_state from menu_point to ingame.
- */
-void processPressMenu(void){
-    switch(menu_point){
-        case playSong1:
-            song_choice = song1;
-            game_state = ingame;
-            break;
-        case playSong2:
-            song_choice = song2;
-            game_state = ingame;
-            break;
-        case playSong3:
-            song_choice = song3;
-            game_state = ingame;
-            break;
-        case setDifficultyNormal:
-            difficulty = normal;
-            menu_point = chooseSong;
-            drawMenu();
-            break;
-        case setDifficultyHard:
-            difficulty = hard;
-            menu_point = chooseSong;
-            drawMenu();
-            break;
-        case resetScore:
-            bestScores[0] = 0;
-            bestScores[1] = 0;
-            bestScores[2] = 0;
-            flash_init();
-            flash_write(0, 3, bestScores);
-            adac_init(); // need this, because flash and adac are not compatible and only one can be active
-            menu_point = chooseScore;
-            drawMenu();
-    }
-}
-
-
-/**
- * Function to update the score and play a short tone with given frequency.
- * The score gets updated depending on which difficulty we play in.
- * This function gets called in processPressGame.
- */
-void processNote(unsigned char correct, unsigned int frequency){
-    lcd_cursorSet(0, 0);  
-    if(correct){
-        switch(difficulty){
-            case normal:
-                lcd_putText("+2");
-                score += 2;
-                break;
-            case hard:
-                lcd_putText("+5");
-                score += 5;
-                break;
-        }
-    }
-    else{
-        lcd_putText("-1");
-        if(score > 0){
-            score --;
-        }
-    }
-    playNotes(frequency);
-    __delay_cycles(delay_tone);
-    playNotes(0);
-}
-
-
-/**
- * Function to register and process all button presses during a song ingame.
- * Depending on the pressed button a tone the helper function processNote() gets
- * called which updates the score and plays tone with certain frequency.
- */
-void processPressGame(unsigned char press){
-    const unsigned char *notes = NULL;
-    unsigned int frequency = 0;
-    
-    // determine correct notes and frequencies dependend on song_choice and press
-    switch(song_choice){
-        case song1: 
-            notes = notes1;
-            frequency = (press == 1) ? song1_note1 :
-                        (press == 2) ? song1_note2 :
-                        (press == 3) ? song1_note3 : 
-                                       song1_note4;
-            break;
-        case song2:
-            notes = notes2;
-            frequency = (press == 1) ? song2_note1 :
-                        (press == 2) ? song2_note2 :
-                        (press == 3) ? song2_note3 : 
-                                       song2_note4;
-            break;
-        case song3:
-            notes = notes3;
-            frequency = (press == 1) ? song3_note1 :
-                        (press == 2) ? song3_note2 :
-                        (press == 3) ? song3_note3 : 
-                                       song3_note4;
-            break;
-    }
-    
-    // define variable to check if correct button is pressed for the note
-    unsigned char expectedNote = '1' + (press - 1);
-    
-    // check if note matches current position +- 1
-    if((notes[note_count] == expectedNote) ||           // this would be the precise case when the note is exactly at the left side of screen and should be pressed
-       (notes[note_count + 1] == expectedNote) ||       // also include buffer that it counts for +1
-       (notes[note_count - 1] == expectedNote)) {       // and -1 such that the gameplay feels a bit smoother
-        processNote(1, frequency);
-    }
-    else {
-        processNote(0, frequency);
-    }
-}
-
-
-/**
- * Function to play the current song_choice.
- * This prints out all the values from notesX on the screen,
- * depending on the current position note_count.
- * Also this changes the program to gameover state if all
- * content from notesX are played.
- */
-void playSong(){
-    const unsigned char *notes = NULL;
-    size_t notesSize = 0;
-    
-    // get needed notes and determine size of notebook
-    switch(song_choice){
-        case song1: notes = notes1; notesSize = sizeof(notes1); break;
-        case song2: notes = notes2; notesSize = sizeof(notes2); break;
-        case song3: notes = notes3; notesSize = sizeof(notes3); break;
-    }
-    
-    // always draw 16 elements of the song and go through it sequentally
-    lcd_cursorSet(0, 1);
-    for(unsigned char i = note_count; i < note_count + 16; i++){
-        lcd_putChar(notes[i]);
-    }
-    
-    // gameover condition when all elements of the respective notes are drawn once
-    if(note_count >= notesSize - 16){
-        game_state = gameover;
-    }
-}
-
-
-/**
- * This function sets the speed with which the song is played.
- * Define the delay depending on song_choice and difficulty.
- * Difficulty hard is always twice as fast as normal.
- */
-void delay(void){
-    switch(song_choice){
-        case song1:
-            if(difficulty == normal){
-                __delay_cycles(delay_song1);
-            }
-            __delay_cycles(delay_song1);
-            break;
-        case song2:
-            if(difficulty == normal){
-                __delay_cycles(delay_song2);
-            }
-            __delay_cycles(delay_song2);
-            break;
-        case song3:
-            if(difficulty == normal){
-                __delay_cycles(delay_song3);
-            }
-            __delay_cycles(delay_song3);
-            break;
-    }
-}
-
-
-/**
- * Draw the gameover menu view.
- * First line is the score, second line a message depending on the score.
- */
-void drawGameOver(void){
-    // first line
-    lcd_clear();
-    lcd_putText("Score: ");
-    lcd_putNumber(score);
-    lcd_cursorSet(0, 1);
-    // second line
-    unsigned char perfectScore = 0;
-    unsigned char goodScore = 0;
-    // determine tresholds for displayed message depending on difficulty
-    switch(song_choice){
-        case song1: 
-            perfectScore = (difficulty == normal) ? 48 : 120;
-            goodScore = (difficulty == normal) ? 40 : 99;
-            break;
-        case song2:
-        case song3:
-            perfectScore = (difficulty == normal) ? 64 : 160;
-            goodScore = (difficulty == normal) ? 50 : 134;
-            break;
-    }
-    if(score == perfectScore){
-        lcd_putText("Perfect!");
-    }
-    else if(score > goodScore){
-        lcd_putText("Very Good!");
-    }
-    else{
-        lcd_putText("Practice more!");
-    }
-}
-
-
-/**
- * Function to reset important game variables.
- * Also saves new best score on the flash if necessary.
- */
-void resetGame(void){
-    game_state = menus;
-    menu_point = chooseSong;
-
-    // if necessary update highscore
-    if(score > bestScores[song_choice]){
-        bestScores[song_choice] = score;
-        flash_init();
-        flash_write(0, 3, bestScores);
-        adac_init();
-    }
-    score = 0;
-    note_count = 0;
-}
-
-
-/******************************************************************************
- * GAME LOOP
- *****************************************************************************/
-
-
-int main(void) {
-    init_all();
-
-    unsigned char change = 0;
-    unsigned char press;
-
-    while(1){
-        switch(game_state){
-            case menus:
-                drawMenu();
-                while(game_state == menus){
-                    adac_read(joystick);        // read out joystick
-                    change = navigateMenu();    // check if some input was registered
-                    if(change){
-                        drawMenu();             // only draw if input was registered
-                    }
-                    press = stateButton();      // check if button was pressed
-                    if(press){
-                        processPressMenu();     // execute possible button press actions
-                    }
-                    __delay_cycles(delay_menu);
-                }
-                break;
-            case ingame:
-                while(game_state == ingame){
-                    lcd_clear();
-                    lcd_cursorShow(0);                      // turn off before drawing game related stuff
-                    playSong();                             // draw the notes of the current note_count position
-                    press = stateButton();                  // check if (and if yes which) button (1-4) was pressed
-                    processPressGame(press);                // process pressed button either increase score or decrease
-                    note_count++;                           // increment to iterate through notesX (1 or 2 or 3)
-                    lcd_cursorSet(0, 1);
-                    lcd_cursorShow(1);                      // turn on cursor for little help when to press
-                    delay();                                // defines speed of song based on difficulty
-                }
-                lcd_cursorShow(0);
-                break;
-            case gameover:
-                drawGameOver();
-                resetGame();
-                __delay_cycles(delay_gameover);
-                break;
-        }
-    }
-}
-
-
-/******************************************************************************
- * TIMER
- *****************************************************************************/
-
-/**
- * Timer only used for playing PWM signals with Buzzer
- */
-#pragma vector=TIMER0_A1_VECTOR
-__interrupt void Timer_A1(void)
-{
-    TACTL &= ~TAIFG;
-}
+/***************************************************************************//**
+ * @file    main.c
+ * @author  Christopher Haas
+ * @date    04.07.23
+ *
+ * @brief   Exercise 5 - Project
+ *
+ *
+ * Pin connections (all are the same as from previous exercises, only Buzzer and Shift reg. new):
+ *
+ *          LCD related:
+ *                          RS <-> P3.0, R/W <-> P3.1, E <-> P3.2
+ *                          D4 <-> P2.0, D5 <-> P2.1, D6 <-> P2.2, D7 <-> P2.3
+ *                          Also set JP1, (JP2,) JP3 to left side (arrow).
+ *
+ *          I2C + ADAC related:
+ *                          P1.6 <-> XSCL, P1.7 <-> XSDA, P1.3 <-> I2C_/SPI
+ *
+ *          SPI + Flash related:
+ *                          P1.5 <-> CC_CLK, CC_SO <-> F_SO, CC_SI <-> F_SI, CC_CLK <-> F_CLK
+ *                          P3.4 <-> F_/CS, P3.3 <-> F_/HOLD, P3.5 <-> F_/WP
+ *
+ *          Buzzer related:
+ *                          P3.6 <-> BUZZER, JP5 to VFO
+ *
+ *          Shift register related:
+ *                          Set jumpers on Port 2 for P2.7 to P2.2
+ *
+ * Timers: Timer0_A drives the buzzer PWM, Timer1_A is the 1 ms system tick (tick.c)
+ * which paces the menu and the songs. The CPU sleeps in LPM0 between ticks.
+ * After delay_idle without input in the menu it sleeps in LPM3 instead and
+ * only wakes up when Timer0_A counted an interval of ACLK (power.c) to look
+ * for input. The watchdog resets the MCU if the scheduler stops (sched.h).
+ *
+ * The UART (P1.1 / P1.2, UART_BAUD) sends binary telemetry frames (telemetry.h)
+ * from its TX interrupt, so diagnostics never hold up the game. The last events
+ * are kept in a trace ring (trace.h) which is dumped on request or after a reset
+ * by the watchdog.
+ *
+ * All work is split into tasks (see TASKS below) which are run by the cooperative
+ * scheduler in sched.c. Input has the highest priority and is never blocked by
+ * more than one running task, the flash is written in the background.
+ *
+ * Every play is recorded into the flash (recorder.h), the best run of a song
+ * plays along as ghost, its lane is shown next to the judgement.
+ *
+ * "Record Song" records a new chart live (composer.h): the buttons are
+ * pressed along with a metronome on the buzzer and the song is written to a
+ * free slot of the flash, letting go of the joystick ends it.
+ *
+ * "Endless" plays a chart which is generated while it scrolls (endless.h),
+ * it gets denser and faster until the player missed too often. Each run
+ * gets its own seed, kept with the recording and the leaderboard entry, so
+ * the best run plays along as ghost on its own chart again.
+ *
+ * The rules of a song are in the game core (game.h) without any hardware
+ * access, main.c steps it from the tasks and executes its commands.
+ *
+ *
+ * For detailed description of the project refer to the video.
+ *
+ * @note    The project was exported using CCS 8.0.0.
+ *
+ ******************************************************************************/
+
+#include "libs/templateEMP.h"   // template UART disabled, see uart.c
+#include "libs/LCD.h"
+#include "libs/adac.h"
+#include "libs/flash.h"
+#include "libs/shift.h"
+#include "libs/pwm.h"
+#include "libs/sched.h"
+#include "libs/power.h"
+#include "libs/profile.h"
+#include "libs/telemetry.h"
+#include "libs/loader.h"
+#include "libs/trace.h"
+#include "libs/stack.h"
+#include "libs/store.h"
+#include "libs/leader.h"
+#include "libs/recorder.h"
+#include "libs/composer.h"
+#include "libs/songs.h"
+#include "libs/endless.h"
+#include "libs/menu.h"
+#include "libs/score.h"
+#include "libs/game.h"
+#include "libs/shared.h"
+#include <stddef.h>
+
+
+/******************************************************************************
+ * CONSTANTS or GAMEPARAMETERS
+ *****************************************************************************/
+
+// All delays are in ms, i.e. ticks of the system tick in tick.c
+
+#define delay_menu                  200     // how fast menu gets updated, 0.2 real-time seconds
+#define delay_tone                   50     // how long tone is played when button pressed in game, 50ms real time
+#define delay_input                   5     // how often the buttons are scanned
+#define delay_storage                50     // how often a running flash write is polled
+#define delay_commit               1000     // menu time without input before changes are written to the flash
+#define delay_idle                10000     // menu goes to LPM3 after 10 real-time seconds without input
+#define delay_telemetry            1000     // how often task times and power stats are sent on the UART
+#define delay_loader                  2     // how often received upload frames are handled
+#define delay_prefetch               20     // how often the chart of a flash song and the ghost are read ahead, the ring lasts many slots
+#define delay_click                  20     // how long a click of the metronome sounds
+
+#define song_endless     (SONG_COUNT + LIBRARY_SLOTS)   // song_choice of the endless mode, after the songs of the flash
+
+#define tone_bar                   1047     // playNotes() value of the first click of a bar, C6
+#define tone_beat                   784     // and of the other ones, G5
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+enum GameState{
+    menus,
+    ingame,
+    gameover,
+    loading,
+    composing,
+};
+
+enum Difficulty{
+    normal,
+    hard,
+};
+
+unsigned char game_state = menus;               // enum GameState
+unsigned char game_waiting = menus;             // enum GameState which waits for the flash in task_storage(), menus if none
+unsigned char menu_point = chooseSong;          // enum MenuPoint, node of menu[] shown
+unsigned char song_choice = 0;                  // index of the current song in songs[], SONG_COUNT + slot for the flash,
+                                                // song_endless for the endless mode
+const Song *song = &songs[0];                   // the current song
+#define flash_song              (shared.play.chart.flash.song)  // song of the flash while it is played
+
+unsigned int library_present = 0;               // slots of the flash which hold a song, see library_scan()
+unsigned char flash_choice = 0;                 // slot chosen in the menu, its name is read for every draw
+
+unsigned char compose_slot;                     // slot of the flash a chart is recorded to
+#define compose_lane            (shared.compose.lane)   // of the recording, see shared.h
+#define compose_stop            (shared.compose.stop)
+unsigned char compose_done = 0;                 // 1 while the end of a recorded chart is programmed
+
+// Settings of the player, kept in the flash by store.c. The menu changes
+// them right here. The scores are on the leaderboards of leader.c.
+typedef struct{
+    unsigned char difficulty;                   // enum Difficulty chosen last
+    unsigned char name[4];                      // player name, limited to 4 chars
+}SettingsRecord;
+
+SettingsRecord settings;
+unsigned char board_rank = 0;                   // rank of the leaderboard shown in the menu
+unsigned char score_board = LEADER_NONE;        // leaderboard the score of the last song waits for
+
+#define game                    (shared.play.game)      // the song being played, see game.h
+unsigned int game_tick = 0;                     // tick of the last game_step()
+
+unsigned char ghost = 0;                        // 1 if the best run of the song plays along
+unsigned int run_seed = 0;                      // of the endless chart, 0 for the songs
+unsigned char ghost_lanes = 0;                  // lanes the ghost pressed last, shown for delay_tone
+unsigned int ghost_shown;                       // tick they were shown
+
+unsigned char cursor_position = 0;              // used to keep track where we are when in naming menu
+
+unsigned char last_press = 0;                   // button state of the last input scan, to only react on new presses
+unsigned int last_activity = 0;                 // tick of the last press or joystick move, to find out when to idle
+
+enum Bus{                                       // USCI_B0 is shared, either I2C to the ADAC or SPI to the flash
+    busNone,
+    busAdac,
+    busFlash,
+};
+unsigned char bus = busNone;                    // enum Bus
+
+// Tasks run by the scheduler, the order is the priority (first is highest).
+// The table itself is defined at the end, after the task functions.
+enum TaskId{
+    taskInput,
+    taskAudio,
+    taskGame,
+    taskPrefetch,
+    taskJoystick,
+    taskStorage,
+    taskLoader,
+    taskTelemetry,
+    taskLcd,                                    // this and the rest only run on sched_trigger()
+    taskIdle,
+    taskCount,
+};
+
+#define task_periodic               taskLcd     // tasks with a TaskState, the ones before
+
+
+/******************************************************************************
+ * GAME FUNCTIONS
+ *****************************************************************************/
+
+/**
+ * Switch USCI_B0 to I2C for the ADAC (joystick) if it isn't already.
+ */
+void useAdac(void){
+    if(bus != busAdac){
+        adac_init();
+        bus = busAdac;
+    }
+}
+
+
+/**
+ * Switch USCI_B0 to SPI for the flash if it isn't already.
+ */
+void useFlash(void){
+    if(bus != busFlash){
+        flash_init();
+        bus = busFlash;
+    }
+}
+
+
+/**
+ * Read the settings from the flash, see store.h. If there is no valid
+ * record, e.g. the flash is empty or holds an older layout, start with
+ * the defaults. The leaderboards are only read when they are needed.
+ * A change in the menu only marks the record with store_mark(), it is
+ * written to the flash by task_storage() once the menu is left alone.
+ */
+void loadSettings(void){
+    useFlash();
+    if(!store_load((unsigned char *)&settings, sizeof(SettingsRecord))){
+        settings.difficulty = normal;
+        for(unsigned char i = 0; i < 4; i++){
+            settings.name[i] = 'a';
+        }
+    }
+    if(settings.difficulty != hard){
+        settings.difficulty = normal;
+    }
+}
+
+
+/**
+ * Returns 1 while a commit of the settings, a leaderboard, a recording or
+ * a recorded chart still has something to program. The flash can't be
+ * used for anything else until then.
+ */
+unsigned char storageBusy(void){
+    return store_busy() || leader_pending() || recorder_pending() || composer_pending();
+}
+
+
+/**
+ * Switch to <state> (ingame, loading or composing) once the flash is done
+ * with what the last mode left, see task_storage(). A commit only starts
+ * after delay_commit without input and a leaderboard takes a few ms, so
+ * this normally starts it on the next run of the scheduler.
+ */
+void startMode(enum GameState state){
+    game_waiting = state;
+    sched_trigger(taskStorage);
+}
+
+
+/**
+ * Load the leaderboard of song <index> on the current difficulty, unless
+ * the flash is busy with a commit, the recording of the last song or a
+ * recorded chart, whose rings share the RAM of the board (shared.h).
+ * Returns 1 if it is in RAM.
+ */
+unsigned char loadBoard(unsigned char index){
+    unsigned char board = LEADER_BOARD(index, settings.difficulty);
+
+    if(leader_board() == board){
+        return 1;
+    }
+    if(store_busy() || recorder_pending() || composer_pending()){
+        return 0;                           // task_storage() draws again once it is done
+    }
+    useFlash();
+    board_rank = 0;
+    return leader_load(board);
+}
+
+
+/**
+ * Returns the leaderboard of the current song and difficulty, LEADER_NONE
+ * for a song of the flash.
+ */
+unsigned char songBoard(void){
+    if(song_choice < SONG_COUNT){
+        return LEADER_BOARD(song_choice, settings.difficulty);
+    }
+    if(song_choice == song_endless){
+        return LEADER_BOARD(LEADER_ENDLESS, settings.difficulty);
+    }
+    return LEADER_NONE;
+}
+
+
+/**
+ * Put the score of the song just played on leaderboard score_board, with
+ * the player name and the accuracy. Runs from task_storage() back in the
+ * menu once the recording of the song is programmed, the board takes the
+ * RAM of the song (shared.h).
+ */
+void recordScore(void){
+    LeaderEntry entry;
+
+    entry.score = score_total();
+    entry.accuracy = score_accuracy();
+    entry.replay = recorder_slot();         // the ghost of the song if it gets the first rank
+    entry.seed = run_seed;
+    for(unsigned char i = 0; i < 4; i++){
+        entry.name[i] = settings.name[i];
+    }
+    useFlash();
+    if(leader_load(score_board)){
+        leader_insert(&entry);              // appended to its log by task_storage()
+    }
+    score_board = LEADER_NONE;
+}
+
+
+/**
+ * Look which songs the flash holds and choose the first one.
+ */
+void scanLibrary(void){
+    useFlash();
+    library_present = library_scan();
+    flash_choice = 0;
+    while(flash_choice < LIBRARY_SLOTS - 1 && !(library_present & (1 << flash_choice))){
+        flash_choice++;
+    }
+}
+
+
+/**
+ * Init all necessary functions.
+ * Also access the stored settings on the flash.
+ * The steps overlap the power-up time of the LCD: its pins are set first,
+ * then the flash is read and the other modules are set up while the LCD
+ * gets ready, only what is left of LCD_POWER_UP_MS is slept.
+ * Returns the ms that were left.
+ */
+unsigned int init_all(void){
+    unsigned int lcd_ready;
+    unsigned int left;
+
+    initMSP();                                            
+    trace_init();                                         // before anything clears the reset flags
+    tick_init();                                          // system tick used for all game timing
+    power_init();                                         // ACLK from VLO for the LPM3 idle
+    uart_init();                                          // telemetry, sent in the background
+    trace_listen();                                       // dump requests of the PC
+
+    lcd_powerUp();                                        // the power-up time of the LCD starts
+    lcd_ready = tick_now() + LCD_POWER_UP_MS + 1;         // + 1, the current tick is partly over
+    loadSettings();                                       // read the stored difficulty and name on the flash
+    scanLibrary();                                        // songs uploaded to the flash
+    shift_init(); useAdac(); pwm_init();                  // init used modules, see lib files
+
+    left = (int)(lcd_ready - tick_now()) > 0 ? lcd_ready - tick_now() : 0;
+    tick_sleepUntil(lcd_ready);
+    lcd_configure();
+    lcd_loadGlyphs();                                     // for the custom chars displayed, in one go
+    return left;
+}
+
+
+/**
+ * Used to change the name in the respective submenu (menu_point == setName).
+ * Up and down change the char at the cursor, right and left move the cursor.
+ * Left on the first char isn't used, so it leaves the menu point.
+ */
+unsigned char menu_editName(unsigned char direction){
+    switch(direction){
+        case menuUp:
+            settings.name[cursor_position]++;       // increment char on display
+            store_mark();
+            return 1;
+        case menuDown:
+            settings.name[cursor_position]--;       // decrement char on display
+            store_mark();
+            return 1;
+        case menuRight:
+            if(cursor_position < 3) cursor_position++;
+            return 1;
+        default:
+            if(cursor_position == 0) return 0;      // back to chooseName
+            cursor_position--;
+            return 1;
+    }
+}
+
+
+/**
+ * Show the next rank of a leaderboard with right, after the last one the
+ * first again. The other directions leave the menu point.
+ */
+unsigned char menu_browseBoard(unsigned char direction){
+    if(direction != menuRight){
+        return 0;
+    }
+    board_rank = (board_rank + 1) % LEADER_SIZE;
+    return 1;
+}
+
+
+/**
+ * Draw rank board_rank of the leaderboard of song <index> on the first
+ * line: rank, name, accuracy and N or E for the difficulty, e.g.
+ * "1. abcd 98%    N". An empty rank, or one of a board task_lcd()
+ * couldn't load yet, shows "----". The line is built in the buffer
+ * <line> of drawMenu(). Returns its score, 0 if it is empty.
+ */
+unsigned long drawRank(unsigned char index, char *line){
+    const LeaderEntry *entry = NULL;
+    unsigned char x = 0;
+
+    if(leader_board() == LEADER_BOARD(index, settings.difficulty)){
+        entry = leader_entry(board_rank);
+    }
+    line[x++] = '1' + board_rank;
+    line[x++] = '.';
+    line[x++] = ' ';
+    for(unsigned char i = 0; i < 4; i++){
+        line[x++] = entry != NULL ? entry->name[i] : '-';
+    }
+    line[x++] = ' ';
+    if(entry != NULL){
+        x += lcd_formatLong(&line[x], entry->accuracy);
+        line[x++] = '%';
+    }
+    while(x < LCD_COLUMNS - 1){
+        line[x++] = ' ';
+    }
+    line[x] = settings.difficulty == hard ? 'E' : 'N';
+    lcd_updateLine(0, line);
+    return entry != NULL ? entry->score : 0;
+}
+
+
+/**
+ * Write the name of the chosen song of the flash to <line>, up to column
+ * 11. It is read for every draw instead of being kept in RAM. Returns the
+ * number of chars, 0 while the flash is busy, task_storage() draws again
+ * once it is done.
+ */
+unsigned char drawFlashName(char *line){
+    unsigned char name[LIBRARY_NAME + 1];   // flash_read() reads one dummy byte first
+    unsigned char x;
+
+    useFlash();
+    if(flash_busy()){
+        return 0;
+    }
+    library_name(flash_choice, name);
+    for(x = 0; x < LIBRARY_NAME && x < 11 && name[x + 1]; x++){
+        line[x] = name[x + 1];
+    }
+    return x;
+}
+
+
+/**
+ * Function to draw the current menu view.
+ * First line is the fixed gametitle, on a leaderboard its current rank,
+ * second line depends on which menu_point we
+ * are currently in.
+ * Both lines are built in RAM and given to lcd_updateLine(), so the title
+ * is only written once and a move only rewrites the cells that changed,
+ * including blanks for the leftovers of a longer text.
+ */
+void drawMenu(){
+    const MenuNode *node = &menu[menu_point];
+    char line[LCD_COLUMNS];
+    unsigned char x = 0;                    // text ends before the symbols at column 11
+    const char *text;
+    unsigned char count, i;
+    unsigned long score = 0;
+
+    // First line, the title unless a leaderboard is shown
+    if(node->show == showScore){
+        score = drawRank(node->arg, line);
+    }
+    else{
+        lcd_updateLine(0, "\0\0 Synth Hero \0\0");
+    }
+    
+    // Second line, depends on menu_point
+    // First check what the menu point shows and write the strings
+    if(node->show == showName){
+        for(; x < 4; x++){
+            line[x] = settings.name[x];
+        }
+    }
+    else if(node->show == showFlash){
+        if(library_present){
+            x = drawFlashName(line);
+        }
+        else{
+            for(text = "No songs"; *text; text++){
+                line[x++] = *text;
+            }
+        }
+    }
+    else if(node->show == showScore){
+        // the score right aligned up to column 10, the name gets the rest,
+        // formatted at the start of the line and moved from the back
+        count = lcd_formatLong(line, score);
+        for(i = count; i > 0; i--){
+            line[10 - count + i] = line[i - 1];
+        }
+        for(text = node->text; *text && x + count < 10; text++){
+            line[x++] = *text;
+        }
+        while(x + count < 11){
+            line[x++] = ' ';
+        }
+        x += count;
+    }
+    else{
+        for(text = node->text; *text && x < 11; text++){
+            line[x++] = *text;
+        }
+    }
+    while(x < LCD_COLUMNS){
+        line[x++] = ' ';
+    }
+    
+    // Now add arrow and button elements to indicate where we can navigate,
+    // taken from the graph itself so they can't differ from the moves
+    if(node->press != NULL) line[11] = 0x6F;
+    if(node->next[menuLeft] != menuNone) line[12] = 0x7F;
+    if(node->next[menuRight] != menuNone) line[13] = 0x7E;
+    if(node->next[menuDown] != menuNone) line[14] = 0x02;
+    if(node->next[menuUp] != menuNone) line[15] = 0x04;
+    lcd_updateLine(1, line);
+    
+    // This is needed to set the cursor to the right position
+    // in naming menu, where cursor show is on to allow the user
+    // to enter a name and then also turn it on, off everywhere else
+    if(node->edit != NULL){
+        lcd_cursorSet(cursor_position, 1);
+        lcd_cursorShow(1);
+    }
+    else{
+        lcd_cursorShow(0);
+    }
+}
+
+
+/**
+ * Draw the state of a chart upload.
+ * First line is the menu point, second line what the loader does.
+ */
+void drawLoading(void){
+    char line[LCD_COLUMNS];
+    unsigned char x = 0;
+    const char *text = NULL;
+
+    lcd_cursorShow(0);
+    lcd_updateLine(0, "Upload Song     ");
+
+    switch(loader_state()){
+        case loaderWaiting:
+            text = "Waiting...";
+            break;
+        case loaderErasing:
+            text = "Erasing...";
+            break;
+        case loaderDone:
+            text = "Done, slot ";
+            break;
+    }
+    if(text != NULL){
+        while(*text){
+            line[x++] = *text++;
+        }
+        if(loader_state() == loaderDone){
+            x += lcd_formatLong(&line[x], loader_slot() + 1);
+        }
+    }
+    else{
+        // bytes received so far of the whole chart
+        x += lcd_formatLong(&line[x], loader_received());
+        line[x++] = '/';
+        x += lcd_formatLong(&line[x], loader_size());
+    }
+    while(x < LCD_COLUMNS){
+        line[x++] = ' ';
+    }
+    lcd_updateLine(1, line);
+}
+
+
+/**
+ * Draw the recording of a chart: the count-in or bar and beat of the
+ * metronome on the first line, the notes so far and the lane of the last
+ * one on the second.
+ */
+void drawCompose(void){
+    char line[LCD_COLUMNS];
+    unsigned char x = 0;
+    int slot = composer_slot();
+    const char *text = slot < 0 ? "Count in " : "Recording ";
+
+    lcd_cursorShow(0);
+    while(*text){
+        line[x++] = *text++;
+    }
+    if(slot < 0){
+        line[x++] = '0' + (COMPOSER_BEAT - 1 - slot) / COMPOSER_BEAT;
+    }
+    else{
+        x += lcd_formatLong(&line[x], slot / (COMPOSER_BEAT * COMPOSER_BAR) + 1);
+        line[x++] = '.';
+        line[x++] = '1' + slot / COMPOSER_BEAT % COMPOSER_BAR;
+    }
+    while(x < LCD_COLUMNS){
+        line[x++] = ' ';
+    }
+    lcd_updateLine(0, line);
+
+    x = 0;
+    for(text = "Notes: "; *text; text++){
+        line[x++] = *text;
+    }
+    x += lcd_formatLong(&line[x], composer_notes());
+    while(x < LCD_COLUMNS){
+        line[x++] = ' ';
+    }
+    if(compose_lane){
+        line[LCD_COLUMNS - 1] = '0' + compose_lane;     // like the notes of the songs
+    }
+    lcd_updateLine(1, line);
+}
+
+
+/**
+ * Function to navigate up, down, left, right in the menu.
+ * Depending on the ADAC values of the <joystick> (horizontal, vertical),
+ * global variable menu_point gets modified.
+ * Vertical moves are tried first, then horizontal ones.
+ * Function returns 1 if something changed, 0 else (so that we
+ * only draw when a change is registered).
+ */
+unsigned char navigateMenu(const unsigned char *joystick){
+    if(joystick[1] == 0 && menu_navigate(&menu_point, menuUp)) return 1;
+    if(joystick[1] == 255 && menu_navigate(&menu_point, menuDown)) return 1;
+    if(joystick[0] == 0 && menu_navigate(&menu_point, menuRight)) return 1;
+    if(joystick[0] == 255 && menu_navigate(&menu_point, menuLeft)) return 1;
+    return 0;
+}
+
+
+/**
+ * Returns 1 if the <joystick> (horizontal, vertical) is pushed in any
+ * direction, 0 else.
+ */
+unsigned char joystickMoved(const unsigned char *joystick){
+    return joystick[0] == 0 || joystick[0] == 255 ||
+           joystick[1] == 0 || joystick[1] == 255;
+}
+
+
+/**
+ * Stop polling the input at full rate and let task_idle() sleep in LPM3
+ * instead. The interval of the sleeps is measured first, so the sleeping
+ * time can be counted (see power_stats()).
+ */
+void enterIdle(void){
+    TRACE(traceIdle, 1);
+    sched_setPeriod(taskInput, 0);
+    sched_setPeriod(taskJoystick, 0);
+    power_calibrate();
+    sched_trigger(taskIdle);
+}
+
+
+/**
+ * Go back to polling the input at full rate.
+ */
+void leaveIdle(void){
+    TRACE(traceIdle, 0);
+    last_activity = tick_now();
+    sched_setPeriod(taskInput, delay_input);
+    sched_setPeriod(taskJoystick, delay_menu);
+}
+
+
+/**
+ * Let the best run of the leaderboard of song_choice play along as ghost.
+ * An endless run then gets the chart of that run, so the ghost presses fit
+ * it, otherwise a new one seeded with the uptime. startMode() let the flash
+ * finish everything else first.
+ */
+void loadGhost(void){
+    const LeaderEntry *best;
+    unsigned char board = songBoard();
+    unsigned int seed;
+
+    ghost = 0;
+    ghost_lanes = 0;
+    run_seed = 0;
+    if(song_choice == song_endless){
+        run_seed = (unsigned int)tick_uptime() & 0xFFFF; // ms since the boot, 16 bits like the LFSR
+    }
+    useFlash();
+    if(board != LEADER_NONE && !flash_busy() && leader_load(board) && (best = leader_entry(0)) != NULL){
+        seed = best->seed;                          // the ghost is read into the RAM of the board
+        ghost = recorder_ghost(best->replay, board, seed, best->score);
+        if(ghost){
+            run_seed = seed;
+        }
+    }
+}
+
+
+/**
+ * Record the song just started, with the seed of its chart.
+ */
+void startRecording(void){
+    unsigned char board = songBoard();
+
+    if(board == LEADER_NONE){
+        board = RECORDER_FLASH_BOARD(song_choice - SONG_COUNT, settings.difficulty);
+    }
+    recorder_start(board, run_seed, game_tick);
+}
+
+
+/**
+ * Sound the metronome for enum ComposerClick <click>, task_audio() stops it.
+ */
+void playClick(unsigned char click){
+    if(click != composerSilent){
+        playNotes(click == composerBar ? tone_bar : tone_beat);
+        sched_setPeriod(taskAudio, delay_click);
+    }
+}
+
+
+/**
+ * Read the header of the song of the flash chosen in the menu into
+ * flash_song and open its chart.
+ */
+void openFlashSong(void){
+    LibraryHeader header;
+
+    useFlash();                             // stays selected while playing, the chart is read from it
+    library_header(song_choice - SONG_COUNT, &header);
+    library_song(&header, &flash_song);
+    song = &flash_song;
+    library_open(&game.chart, song_choice - SONG_COUNT, song->size);
+}
+
+
+/**
+ * Start the song of song_choice. A chart of the flash and the endless one
+ * are opened here, the ones of the MCU by game_start().
+ */
+void startSong(void){
+    loadGhost();
+    if(song_choice == song_endless){
+        endless_open(&game.chart, run_seed);
+    }
+    else if(song_choice >= SONG_COUNT){
+        openFlashSong();
+    }
+    game_start(&game, song, settings.difficulty);
+    game_tick = tick_now();
+    startRecording();
+    TRACE(traceSong, song_choice);
+}
+
+
+/**
+ * Function to switch the game_state. Sets the periods of the tasks
+ * which depend on the state and requests a redraw.
+ */
+void changeState(enum GameState state){
+    game_state = state;
+    TRACE(traceState, state);
+    switch(state){
+        case menus:
+            menu_point = chooseSong;
+            last_activity = tick_now();                     // idle time starts counting from here
+            loader_stop();
+            trace_listen();                                 // the UART is back from the loader
+            sched_setPeriod(taskGame, 0);                   // nothing to step in the menu
+            sched_setPeriod(taskPrefetch, 0);
+            sched_setPeriod(taskJoystick, delay_menu);
+            sched_setPeriod(taskLoader, 0);
+            sched_setPeriod(taskTelemetry, delay_telemetry);
+            break;
+        case ingame:                                        // after startSong()
+            sched_setPeriod(taskGame, game_next(&game));    // one step of the song per period
+            sched_setPeriod(taskPrefetch, song == &flash_song || ghost ? delay_prefetch : 0);
+            sched_setPeriod(taskJoystick, 0);               // joystick not used while playing
+            break;
+        case gameover:
+            recorder_finish(score_total());                 // written by task_storage()
+            ghost_lanes = 0;
+            sched_setPeriod(taskGame, game_next(&game));    // next game step ends the score screen
+            sched_setPeriod(taskPrefetch, 0);
+            break;
+        case loading:
+            loader_start();
+            sched_setPeriod(taskJoystick, 0);
+            sched_setPeriod(taskTelemetry, 0);              // leave the UART to the acks
+            sched_setPeriod(taskLoader, delay_loader);
+            break;
+        case composing:
+            compose_lane = 0;
+            compose_stop = 0;
+            useFlash();
+            composer_start(compose_slot, settings.difficulty == hard ? COMPOSER_PERIOD : 2 * COMPOSER_PERIOD, tick_now());
+            playClick(composerBar);                         // the count-in starts
+            sched_setPeriod(taskGame, settings.difficulty == hard ? COMPOSER_PERIOD : 2 * COMPOSER_PERIOD);
+            break;
+    }
+    sched_trigger(taskLcd);
+}
+
+
+/**
+ * Start song <song> from its menu point.
+ */
+void menu_play(unsigned char index){
+    song_choice = index;
+    song = &songs[index];
+    startMode(ingame);
+}
+
+
+/**
+ * Start the song of the flash chosen in the menu, its header is read by
+ * startSong().
+ */
+void menu_playFlash(unsigned char unused){
+    if(!(library_present & (1 << flash_choice))){
+        return;                             // no songs in the flash
+    }
+    song_choice = SONG_COUNT + flash_choice;
+    startMode(ingame);
+}
+
+
+/**
+ * Start the endless mode, its chart is generated while it is played.
+ */
+void menu_playEndless(unsigned char unused){
+    song_choice = song_endless;
+    song = &endless_song;
+    startMode(ingame);
+}
+
+
+/**
+ * Go through the songs of the flash with up and down. Up on the first one
+ * isn't used, so it goes back to the songs of the game.
+ */
+unsigned char menu_browseFlash(unsigned char direction){
+    signed char step;
+    signed char slot = flash_choice;
+
+    if(direction == menuUp) step = -1;
+    else if(direction == menuDown) step = 1;
+    else return 0;
+
+    for(slot += step; slot >= 0 && slot < LIBRARY_SLOTS; slot += step){
+        if(library_present & (1 << slot)){
+            flash_choice = slot;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+/**
+ * Wait for a chart upload, see loader.h.
+ */
+void menu_upload(unsigned char unused){
+    startMode(loading);
+}
+
+
+/**
+ * Record a new chart into the first free slot of the flash, see composer.h.
+ * Nothing happens if all slots hold a song.
+ */
+void menu_record(unsigned char unused){
+    for(compose_slot = 0; compose_slot < LIBRARY_SLOTS; compose_slot++){
+        if(!(library_present & (1 << compose_slot))){
+            startMode(composing);
+            return;
+        }
+    }
+}
+
+
+/**
+ * End the recording of a chart and go back to the menu. task_storage()
+ * programs what is left and then chooses the new song, see chooseComposed().
+ */
+void finishComposing(void){
+    composer_finish();
+    compose_done = 1;
+    changeState(menus);
+    sched_trigger(taskStorage);
+}
+
+
+/**
+ * Choose the song recorded last in the menu so it can be played at once,
+ * once its chart is programmed. A mode started in the meantime keeps the
+ * menu as it is.
+ */
+void chooseComposed(void){
+    compose_done = 0;
+    scanLibrary();
+    if(game_state == menus && game_waiting == menus && (library_present & (1 << compose_slot))){
+        flash_choice = compose_slot;
+        menu_point = playFlash;
+        sched_trigger(taskLcd);
+    }
+}
+
+
+/**
+ * Set the difficulty from its menu point and go back to the song choice.
+ */
+void menu_setDifficulty(unsigned char level){
+    settings.difficulty = level == 0 ? normal : hard;
+    store_mark();
+    menu_point = chooseSong;
+    sched_trigger(taskLcd);
+}
+
+
+/**
+ * Clear all leaderboards, they are written to the flash by task_storage().
+ */
+void menu_resetScores(unsigned char unused){
+    leader_reset();
+    menu_point = chooseScore;
+    sched_trigger(taskLcd);
+}
+
+
+/**
+ * Function to process pressed button in the menu,
+ * calls the action of the current menu point if it has one.
+ */
+void processPressMenu(void){
+    const MenuNode *node = &menu[menu_point];
+
+    if(node->press != NULL){
+        node->press(node->arg);
+    }
+}
+
+
+/**
+ * Function to leave the score screen after a song.
+ */
+void resetGame(void){
+    telemetry_sendScore(song_choice, settings.difficulty);
+#ifdef PROFILE
+    profile_dump();                     // times of the song just played
+    profile_reset();
+#endif
+    changeState(menus);
+}
+
+
+/**
+ * Execute the commands of the game core for the last game_step(),
+ * see game.h. The display is only drawn by task_lcd(), so commands of
+ * several steps in the same tick give one redraw.
+ */
+void processGame(const GameOutput *out){
+    if(out->commands & gameTone){
+        playNotes(out->tone);
+        sched_setPeriod(taskAudio, delay_tone);     // task_audio() stops the tone again
+    }
+    if(out->commands & gameTempo){
+        sched_setPeriod(taskGame, game_next(&game));    // the song got faster
+    }
+    if(out->commands & gameOver){
+        score_board = songBoard();          // task_storage() puts it on there, the leaderboard decides
+        changeState(gameover);
+    }
+    if(out->commands & gameMenu){
+        resetGame();
+    }
+    if(out->commands & gameDraw){
+        sched_trigger(taskLcd);
+    }
+}
+
+
+/**
+ * Move the game core on to the current tick with button <press>
+ * (0 for none) and execute what it asks for.
+ */
+void runGame(unsigned char press){
+    GameOutput out = {0, 0};
+    unsigned int now = tick_now();
+
+    game_step(&game, press, now - game_tick, &out);
+    game_tick = now;
+    processGame(&out);
+}
+
+
+/**
+ * Function to register a button press during a song ingame.
+ * The press is judged by its distance in time to the next note of its
+ * lane in the game core, which also asks for the button's tone.
+ */
+void processPressGame(unsigned char press){
+    PROFILE_BEGIN(profilePress);
+    recorder_press(tick_now(), 1 << (press - 1));
+    runGame(press);
+    PROFILE_END(profilePress);
+}
+
+
+/**
+ * Function to register a button press while a chart is recorded. It
+ * becomes a note on the nearest slot and plays the tone of its lane.
+ */
+void processPressCompose(unsigned char press){
+    if(composer_press(tick_now(), press)){
+        compose_lane = press;
+        sched_trigger(taskLcd);
+    }
+    playNotes(songs[0].tone[press - 1]);        // the tones the recorded song gets
+    sched_setPeriod(taskAudio, delay_tone);
+}
+
+
+/**
+ * Draw the ingame view or the score at the end, as the game core
+ * describes them, and the lane the ghost pressed. Only the cells which
+ * changed are written.
+ */
+void drawGame(void){
+    char lines[LCD_LINES][LCD_COLUMNS];
+    unsigned char lane = 0;
+
+    game_frame(&game, lines);
+    if(ghost_lanes){
+        while(!(ghost_lanes & (1 << lane))){
+            lane++;
+        }
+        lines[0][11] = 'G';                 // between the judgement and the multiplier
+        lines[0][12] = '1' + lane;
+    }
+    lcd_cursorShow(0);                      // turn off before drawing game related stuff
+    lcd_updateLine(0, lines[0]);
+    lcd_updateLine(1, lines[1]);
+    if(game_state == ingame){
+        lcd_cursorSet(0, 1);
+        lcd_cursorShow(1);                  // turn on cursor for little help when to press
+    }
+}
+
+
+/******************************************************************************
+ * TASKS
+ *****************************************************************************/
+
+/**
+ * Scan the buttons and process every new press right away,
+ * so the input path doesn't wait for the other tasks.
+ */
+void task_input(void){
+    unsigned char press = stateButton();        // check if (and if yes which) button (1-4) is pressed
+
+    if(press == last_press){
+        return;                                 // still held or still released, nothing new
+    }
+    last_press = press;
+    if(!press){
+        return;
+    }
+    last_activity = tick_now();
+    TRACE(tracePress, press);
+
+    switch(game_state){
+        case menus:
+            processPressMenu();                 // execute possible button press actions
+            break;
+        case ingame:
+            processPressGame(press);            // process pressed button either increase score or decrease
+            break;
+        case gameover:
+            break;
+        case loading:
+            changeState(menus);                 // any button leaves the upload
+            break;
+        case composing:
+            processPressCompose(press);
+            break;
+    }
+}
+
+
+/**
+ * Runs delay_tone after a tone was started in processPressGame() and stops it.
+ */
+void task_audio(void){
+    playNotes(0);
+    sched_setPeriod(taskAudio, 0);
+}
+
+
+/**
+ * One step of the game, runs every step of the song ingame.
+ * In gameover it runs once after GAME_OVER_MS and returns to the menu.
+ * While a chart is recorded it runs every slot and sounds the metronome.
+ */
+void task_game(void){
+    unsigned char click;
+
+    switch(game_state){
+        case ingame:
+            PROFILE_BEGIN(profileStep);
+            runGame(0);                         // one step of the song
+            PROFILE_END(profileStep);
+            break;
+        case gameover:
+            runGame(0);                         // ends the score screen
+            break;
+        case composing:
+            click = composer_step();            // the next slot of the grid
+            if(click == composerFull){
+                finishComposing();
+                break;
+            }
+            playClick(click);
+            if(click != composerSilent){
+                sched_trigger(taskLcd);
+            }
+            break;
+        case menus:
+        case loading:
+            break;
+    }
+}
+
+
+/**
+ * Read the chart of a flash song ahead, runs every delay_prefetch while
+ * it is played so task_game() takes the slots from RAM. Also shows the
+ * presses of the ghost and hides them again after delay_tone.
+ */
+void task_prefetch(void){
+    unsigned char lanes;
+
+    useFlash();
+    if(song == &flash_song){
+        library_prefetch();
+    }
+    if(ghost){
+        lanes = recorder_ghostDue(tick_now());
+        if(lanes || (ghost_lanes && tick_now() - ghost_shown >= delay_tone)){
+            ghost_lanes = lanes;
+            ghost_shown = tick_now();
+            sched_trigger(taskLcd);
+        }
+    }
+}
+
+
+/**
+ * Read the joystick and navigate the menu, runs every delay_menu in the menu.
+ * While a chart is recorded it only looks for the end, a move and then
+ * letting go, so the menu doesn't get the move.
+ */
+void task_joystick(void){
+    unsigned char joystick[2];                  // ADAC values, horizontal and vertical
+
+    useAdac();
+    adac_read(joystick);                        // read out joystick
+    if(joystickMoved(joystick)){
+        last_activity = tick_now();
+    }
+    if(game_state == composing){
+        if(joystickMoved(joystick)){
+            compose_stop = 1;
+        }
+        else if(compose_stop){
+            finishComposing();
+        }
+        return;
+    }
+    if(navigateMenu(joystick)){                         // check if some input was registered
+        sched_trigger(taskLcd);                 // only draw if input was registered
+    }
+    else if(tick_now() - last_activity >= delay_idle && !store_pending() && !storageBusy()){
+        enterIdle();                            // nothing happened for a while and nothing is left to program
+    }
+}
+
+
+/**
+ * Handle the frames of a chart upload, runs every delay_loader while loading.
+ */
+void task_loader(void){
+    trace_poll();                               // a dump requested through the loader
+    useFlash();
+    if(loader_poll()){
+        if(loader_state() == loaderDone){
+            scanLibrary();                      // the new song shows up in the menu
+        }
+        sched_trigger(taskLcd);
+    }
+}
+
+
+/**
+ * Send the task times, the power stats and the stack high-water mark,
+ * runs every delay_telemetry.
+ * Frames which don't fit into the UART buffer are dropped. A running
+ * trace dump goes first, it takes the whole run.
+ */
+void task_telemetry(void){
+    if(trace_poll()){
+        return;
+    }
+    telemetry_sendTasks(taskCount);
+    telemetry_sendPower();
+    telemetry_sendStack();
+}
+
+
+/**
+ * Sleep one interval (power.h) in LPM3 and look for input, runs
+ * again and again while the menu is idle (see enterIdle()).
+ */
+void task_idle(void){
+    unsigned char joystick[2];
+
+    uart_drain();                               // SMCLK is off in LPM3, let the UART finish first
+    power_sleep();
+    useAdac();
+    adac_read(joystick);
+    last_press = stateButton();                 // a press only wakes up, it doesn't act
+    if(last_press || joystickMoved(joystick)){
+        leaveIdle();
+    }
+    else{
+        sched_trigger(taskIdle);
+    }
+}
+
+
+/**
+ * Redraw the display for the current game_state, runs when triggered.
+ */
+void task_lcd(void){
+    PROFILE_BEGIN(profileDraw);
+    switch(game_state){
+        case menus:
+            // loaded before drawing, so the read isn't on top of its frames
+            if(menu[menu_point].show == showScore){
+                loadBoard(menu[menu_point].arg);
+            }
+            drawMenu();
+            break;
+        case ingame:
+        case gameover:
+            drawGame();
+            break;
+        case loading:
+            drawLoading();
+            break;
+        case composing:
+            drawCompose();
+            break;
+    }
+    PROFILE_END(profileDraw);
+}
+
+
+/**
+ * Write the changed settings, leaderboards, the recording of the song and
+ * a recorded chart to the flash in the background, see store.h, leader.h,
+ * recorder.h and composer.h. A
+ * commit of the settings starts once the menu was left alone for
+ * delay_commit, so all changes made until then give one write and nothing
+ * the player does waits for the flash. A leaderboard is appended to its
+ * log right away, that only programs, and a recording is programmed in
+ * chunks while it is played. Erase and program are started and then only
+ * polled on the next runs. Back in the menu the last recording is sent on
+ * the UART.
+ * The score of a song goes on its leaderboard back in the menu, once the
+ * recording is programmed, and a mode chosen in the menu (see startMode())
+ * starts once everything is.
+ */
+void task_storage(void){
+    unsigned char done = 0;
+
+    if(game_waiting != menus && !storageBusy() && score_board == LEADER_NONE){
+        if(game_waiting == ingame){
+            startSong();
+        }
+        leader_forget();                        // the mode has the RAM of the board now
+        changeState(game_waiting);
+        game_waiting = menus;
+        return;
+    }
+    if(store_busy()){
+        useFlash();
+        done = !store_poll();
+    }
+    else if(leader_busy()){
+        useFlash();
+        done = !leader_poll();
+    }
+    else if(recorder_pending()){
+        useFlash();
+        done = !recorder_poll();                // a leaderboard waited for the ring of the recording
+    }
+    else if(composer_pending()){
+        useFlash();
+        composer_poll();
+    }
+    else if(compose_done){
+        chooseComposed();
+    }
+    else if(score_board != LEADER_NONE && game_state == menus){
+        recordScore();
+    }
+    else if(leader_pending()){
+        useFlash();
+        done = !leader_poll();
+    }
+    else if(store_pending() && game_state == menus && tick_now() - last_activity >= delay_commit){
+        useFlash();
+        store_commit();
+    }
+    else if(recorder_sending() && game_state == menus){
+        useFlash();
+        recorder_send();
+    }
+    if(done && game_state == menus && (menu[menu_point].show == showScore || menu[menu_point].show == showFlash)){
+        sched_trigger(taskLcd);                 // the leaderboard or the name of a song waited for the flash
+    }
+}
+
+
+const Task tasks[taskCount] = {
+    [taskInput]     = {task_input,      delay_input},
+    [taskAudio]     = {task_audio,      0},
+    [taskGame]      = {task_game,       0},
+    [taskPrefetch]  = {task_prefetch,   0},
+    [taskJoystick]  = {task_joystick,   delay_menu},
+    [taskStorage]   = {task_storage,    delay_storage},
+    [taskLoader]    = {task_loader,     0},
+    [taskTelemetry] = {task_telemetry,  delay_telemetry},
+    [taskLcd]       = {task_lcd,        0},
+    [taskIdle]      = {task_idle,       0},
+};
+TaskState task_states[task_periodic];
+
+
+/******************************************************************************
+ * GAME LOOP
+ *****************************************************************************/
+
+
+int main(void) {
+    unsigned int lcd_left;
+
+    stack_paint();                      // before anything runs, see stack.h
+    lcd_left = init_all();
+    sched_init(tasks, taskCount, task_states, task_periodic);
+    changeState(menus);
+    task_lcd();                         // the first menu right away
+    telemetry_sendBoot(tick_now(), lcd_left);
+
+    while(1){
+        sched_dispatch();               // run the most important due task or sleep
+    }
+}
+
+
+/******************************************************************************
+ * TIMER
+ *****************************************************************************/
+
+/**
+ * Timer only used for playing PWM signals with Buzzer
+ */
+#pragma vector=TIMER0_A1_VECTOR
+__interrupt void Timer_A1(void)
+{
+    TACTL &= ~TAIFG;
+}
@@ -0,0 +1,350 @@
+/***************************************************************************//**
+ * @file    msp430g2553.h
+ * @date    19.10.26
+ *
+ * @brief   Register layer of the MSP430G2553 for the host simulation.
+ *
+ * Used instead of the header of CCS when building with the Makefile, the
+ * game and the drivers stay unchanged. Every register is a function call
+ * into the simulation (sim.c), which returns the storage of the register
+ * after it has passed the last writes on to the simulated peripherals and
+ * advanced the simulated time. So a write is seen at the next register
+ * access, in program order, and busy loops on registers make progress.
+ *
+ * Only the registers and bits used by the game are here, the values are
+ * the ones of the real header.
+ *
+ ******************************************************************************/
+
+#ifndef SIM_MSP430G2553_H_
+#define SIM_MSP430G2553_H_
+
+/******************************************************************************
+ * REGISTERS
+ *****************************************************************************/
+
+// 8 bit registers, index of sim_reg8()
+enum SimReg8{
+    simP1IN, simP1OUT, simP1DIR, simP1IFG, simP1IES, simP1IE, simP1SEL, simP1SEL2, simP1REN,
+    simP2IN, simP2OUT, simP2DIR, simP2IFG, simP2IES, simP2IE, simP2SEL, simP2SEL2, simP2REN,
+    simP3IN, simP3OUT, simP3DIR, simP3SEL, simP3SEL2, simP3REN,
+    simIE1, simIFG1, simIE2, simIFG2,
+    simDCOCTL, simBCSCTL1, simBCSCTL2, simBCSCTL3,
+    simCALDCO_1MHZ, simCALBC1_1MHZ, simCALDCO_16MHZ, simCALBC1_16MHZ,
+    simUCA0CTL0, simUCA0CTL1, simUCA0BR0, simUCA0BR1, simUCA0MCTL, simUCA0STAT, simUCA0RXBUF,
+    simUCB0CTL0, simUCB0CTL1, simUCB0BR0, simUCB0BR1, simUCB0I2CIE, simUCB0STAT, simUCB0RXBUF,
+    sim8Count,
+};
+
+// 16 bit registers, index of sim_reg16(). The TX buffers are here too, so
+// writing the byte they already hold can still be told apart from no write.
+enum SimReg16{
+    simWDTCTL,
+    simTA0CTL, simTA0R, simTA0CCTL0, simTA0CCTL1, simTA0CCTL2, simTA0CCR0, simTA0CCR1, simTA0CCR2, simTA0IV,
+    simTA1CTL, simTA1R, simTA1CCTL0, simTA1CCTL1, simTA1CCTL2, simTA1CCR0, simTA1CCR1, simTA1CCR2, simTA1IV,
+    simUCB0I2CSA,
+    simUCA0TXBUF,
+    simUCB0TXBUF,
+    sim16Count,
+};
+
+#ifdef SIM_MODEL
+// Build of the budget model (make model, tools/ram_budget.py): the registers
+// are at fixed addresses like on the chip, so an access is one instruction
+// and not a call. It is only compiled, never linked.
+#define sim_reg8(id)    ((volatile unsigned char *)0x0000 + (id))
+#define sim_reg16(id)   ((volatile unsigned int *)0x0100 + (id))
+#else
+volatile unsigned char *sim_reg8(unsigned char id);
+volatile unsigned int *sim_reg16(unsigned char id);
+#endif
+
+#define P1IN            (*sim_reg8(simP1IN))
+#define P1OUT           (*sim_reg8(simP1OUT))
+#define P1DIR           (*sim_reg8(simP1DIR))
+#define P1IFG           (*sim_reg8(simP1IFG))
+#define P1IES           (*sim_reg8(simP1IES))
+#define P1IE            (*sim_reg8(simP1IE))
+#define P1SEL           (*sim_reg8(simP1SEL))
+#define P1SEL2          (*sim_reg8(simP1SEL2))
+#define P1REN           (*sim_reg8(simP1REN))
+#define P2IN            (*sim_reg8(simP2IN))
+#define P2OUT           (*sim_reg8(simP2OUT))
+#define P2DIR           (*sim_reg8(simP2DIR))
+#define P2IFG           (*sim_reg8(simP2IFG))
+#define P2IES           (*sim_reg8(simP2IES))
+#define P2IE            (*sim_reg8(simP2IE))
+#define P2SEL           (*sim_reg8(simP2SEL))
+#define P2SEL2          (*sim_reg8(simP2SEL2))
+#define P2REN           (*sim_reg8(simP2REN))
+#define P3IN            (*sim_reg8(simP3IN))
+#define P3OUT           (*sim_reg8(simP3OUT))
+#define P3DIR           (*sim_reg8(simP3DIR))
+#define P3SEL           (*sim_reg8(simP3SEL))
+#define P3SEL2          (*sim_reg8(simP3SEL2))
+#define P3REN           (*sim_reg8(simP3REN))
+#define IE1             (*sim_reg8(simIE1))
+#define IFG1            (*sim_reg8(simIFG1))
+#define IE2             (*sim_reg8(simIE2))
+#define IFG2            (*sim_reg8(simIFG2))
+#define DCOCTL          (*sim_reg8(simDCOCTL))
+#define BCSCTL1         (*sim_reg8(simBCSCTL1))
+#define BCSCTL2         (*sim_reg8(simBCSCTL2))
+#define BCSCTL3         (*sim_reg8(simBCSCTL3))
+#define CALDCO_1MHZ     (*sim_reg8(simCALDCO_1MHZ))
+#define CALBC1_1MHZ     (*sim_reg8(simCALBC1_1MHZ))
+#define CALDCO_16MHZ    (*sim_reg8(simCALDCO_16MHZ))
+#define CALBC1_16MHZ    (*sim_reg8(simCALBC1_16MHZ))
+#define UCA0CTL0        (*sim_reg8(simUCA0CTL0))
+#define UCA0CTL1        (*sim_reg8(simUCA0CTL1))
+#define UCA0BR0         (*sim_reg8(simUCA0BR0))
+#define UCA0BR1         (*sim_reg8(simUCA0BR1))
+#define UCA0MCTL        (*sim_reg8(simUCA0MCTL))
+#define UCA0STAT        (*sim_reg8(simUCA0STAT))
+#define UCA0RXBUF       (*sim_reg8(simUCA0RXBUF))
+#define UCB0CTL0        (*sim_reg8(simUCB0CTL0))
+#define UCB0CTL1        (*sim_reg8(simUCB0CTL1))
+#define UCB0BR0         (*sim_reg8(simUCB0BR0))
+#define UCB0BR1         (*sim_reg8(simUCB0BR1))
+#define UCB0I2CIE       (*sim_reg8(simUCB0I2CIE))
+#define UCB0STAT        (*sim_reg8(simUCB0STAT))
+#define UCB0RXBUF       (*sim_reg8(simUCB0RXBUF))
+
+#define WDTCTL          (*sim_reg16(simWDTCTL))
+#define TA0CTL          (*sim_reg16(simTA0CTL))
+#define TA0R            (*sim_reg16(simTA0R))
+#define TA0CCTL0        (*sim_reg16(simTA0CCTL0))
+#define TA0CCTL1        (*sim_reg16(simTA0CCTL1))
+#define TA0CCTL2        (*sim_reg16(simTA0CCTL2))
+#define TA0CCR0         (*sim_reg16(simTA0CCR0))
+#define TA0CCR1         (*sim_reg16(simTA0CCR1))
+#define TA0CCR2         (*sim_reg16(simTA0CCR2))
+#define TA0IV           (*sim_reg16(simTA0IV))
+#define TA1CTL          (*sim_reg16(simTA1CTL))
+#define TA1R            (*sim_reg16(simTA1R))
+#define TA1CCTL0        (*sim_reg16(simTA1CCTL0))
+#define TA1CCTL1        (*sim_reg16(simTA1CCTL1))
+#define TA1CCTL2        (*sim_reg16(simTA1CCTL2))
+#define TA1CCR0         (*sim_reg16(simTA1CCR0))
+#define TA1CCR1         (*sim_reg16(simTA1CCR1))
+#define TA1CCR2         (*sim_reg16(simTA1CCR2))
+#define TA1IV           (*sim_reg16(simTA1IV))
+#define UCB0I2CSA       (*sim_reg16(simUCB0I2CSA))
+#define UCA0TXBUF       (*sim_reg16(simUCA0TXBUF))
+#define UCB0TXBUF       (*sim_reg16(simUCB0TXBUF))
+
+// Names of Timer0_A of the older headers
+#define TACTL           TA0CTL
+#define TAR             TA0R
+#define CCTL0           TA0CCTL0
+#define CCTL1           TA0CCTL1
+#define CCTL2           TA0CCTL2
+#define CCR0            TA0CCR0
+#define CCR1            TA0CCR1
+#define CCR2            TA0CCR2
+
+/******************************************************************************
+ * BITS
+ *****************************************************************************/
+
+#define BIT0            (0x0001)
+#define BIT1            (0x0002)
+#define BIT2            (0x0004)
+#define BIT3            (0x0008)
+#define BIT4            (0x0010)
+#define BIT5            (0x0020)
+#define BIT6            (0x0040)
+#define BIT7            (0x0080)
+
+// Status register
+#define GIE             (0x0008)
+#define CPUOFF          (0x0010)
+#define OSCOFF          (0x0020)
+#define SCG0            (0x0040)
+#define SCG1            (0x0080)
+#define LPM0_bits       (CPUOFF)
+#define LPM1_bits       (SCG0+CPUOFF)
+#define LPM2_bits       (SCG1+CPUOFF)
+#define LPM3_bits       (SCG1+SCG0+CPUOFF)
+#define LPM4_bits       (SCG1+SCG0+OSCOFF+CPUOFF)
+
+// IE1, IFG1, IE2, IFG2
+#define WDTIE           (0x01)
+#define WDTIFG          (0x01)
+#define OFIFG           (0x02)
+#define PORIFG          (0x04)
+#define RSTIFG          (0x08)
+#define NMIIFG          (0x10)
+#define UCA0RXIE        (0x01)
+#define UCA0TXIE        (0x02)
+#define UCB0RXIE        (0x04)
+#define UCB0TXIE        (0x08)
+#define UCA0RXIFG       (0x01)
+#define UCA0TXIFG       (0x02)
+#define UCB0RXIFG       (0x04)
+#define UCB0TXIFG       (0x08)
+
+// Basic clock
+#define DIVA_0          (0x00)
+#define DIVA_1          (0x10)
+#define DIVA_2          (0x20)
+#define DIVA_3          (0x30)
+#define LFXT1S_0        (0x00)
+#define LFXT1S_1        (0x10)
+#define LFXT1S_2        (0x20)
+#define LFXT1S_3        (0x30)
+
+// Watchdog
+#define WDTIS0          (0x0001)
+#define WDTIS1          (0x0002)
+#define WDTSSEL         (0x0004)
+#define WDTCNTCL        (0x0008)
+#define WDTTMSEL        (0x0010)
+#define WDTNMI          (0x0020)
+#define WDTNMIES        (0x0040)
+#define WDTHOLD         (0x0080)
+#define WDTPW           (0x5A00)
+#define WDT_ADLY_1000   (WDTPW+WDTTMSEL+WDTCNTCL+WDTSSEL)
+#define WDT_ADLY_250    (WDTPW+WDTTMSEL+WDTCNTCL+WDTSSEL+WDTIS0)
+#define WDT_ADLY_16     (WDTPW+WDTTMSEL+WDTCNTCL+WDTSSEL+WDTIS1)
+#define WDT_ADLY_1_9    (WDTPW+WDTTMSEL+WDTCNTCL+WDTSSEL+WDTIS1+WDTIS0)
+
+// Timer_A
+#define TAIFG           (0x0001)
+#define TAIE            (0x0002)
+#define TACLR           (0x0004)
+#define MC_0            (0x0000)
+#define MC_1            (0x0010)
+#define MC_2            (0x0020)
+#define MC_3            (0x0030)
+#define ID_0            (0x0000)
+#define ID_1            (0x0040)
+#define ID_2            (0x0080)
+#define ID_3            (0x00C0)
+#define TASSEL_0        (0x0000)
+#define TASSEL_1        (0x0100)
+#define TASSEL_2        (0x0200)
+#define TASSEL_3        (0x0300)
+#define CCIFG           (0x0001)
+#define COV             (0x0002)
+#define OUT             (0x0004)
+#define CCIE            (0x0010)
+#define OUTMOD_0        (0x0000)
+#define OUTMOD_1        (0x0020)
+#define OUTMOD_2        (0x0040)
+#define OUTMOD_3        (0x0060)
+#define OUTMOD_4        (0x0080)
+#define OUTMOD_5        (0x00A0)
+#define OUTMOD_6        (0x00C0)
+#define OUTMOD_7        (0x00E0)
+#define CAP             (0x0100)
+
+// USCI control 0
+#define UCSYNC          (0x01)
+#define UCMODE_0        (0x00)
+#define UCMODE_1        (0x02)
+#define UCMODE_2        (0x04)
+#define UCMODE_3        (0x06)
+#define UCMST           (0x08)
+#define UC7BIT          (0x10)
+#define UCMSB           (0x20)
+#define UCCKPL          (0x40)
+#define UCCKPH          (0x80)
+
+// USCI control 1
+#define UCSWRST         (0x01)
+#define UCTXSTT         (0x02)
+#define UCTXSTP         (0x04)
+#define UCTXNACK        (0x08)
+#define UCTR            (0x10)
+#define UCSSEL_0        (0x00)
+#define UCSSEL_1        (0x40)
+#define UCSSEL_2        (0x80)
+#define UCSSEL_3        (0xC0)
+
+// USCI modulation
+#define UCOS16          (0x01)
+#define UCBRS_0         (0x00)
+#define UCBRS_1         (0x02)
+#define UCBRS_2         (0x04)
+#define UCBRS_3         (0x06)
+#define UCBRS_4         (0x08)
+#define UCBRS_5         (0x0A)
+#define UCBRS_6         (0x0C)
+#define UCBRS_7         (0x0E)
+
+// USCI status and I2C interrupt enable
+#define UCBUSY          (0x01)
+#define UCALIFG         (0x01)
+#define UCSTTIFG        (0x02)
+#define UCSTPIFG        (0x04)
+#define UCNACKIFG       (0x08)
+#define UCBBUSY         (0x10)
+#define UCOE            (0x20)
+#define UCALIE          (0x01)
+#define UCSTTIE         (0x02)
+#define UCSTPIE         (0x04)
+#define UCNACKIE        (0x08)
+
+/******************************************************************************
+ * INTERRUPT VECTORS
+ *****************************************************************************/
+
+// #pragma vector is ignored by gcc, sim.c calls the ISRs of the game by name.
+#define PORT1_VECTOR        (2)
+#define PORT2_VECTOR        (3)
+#define ADC10_VECTOR        (5)
+#define USCIAB0TX_VECTOR    (6)
+#define USCIAB0RX_VECTOR    (7)
+#define TIMER0_A1_VECTOR    (8)
+#define TIMER0_A0_VECTOR    (9)
+#define WDT_VECTOR          (10)
+#define COMPARATORA_VECTOR  (11)
+#define TIMER1_A1_VECTOR    (12)
+#define TIMER1_A0_VECTOR    (13)
+#define NMI_VECTOR          (14)
+
+#define __interrupt
+
+// Stack section of the MSP for libs/stack.h. The game runs on the stack of
+// the host, so this one stays painted and stack_used() returns 0.
+#define SIM_STACK_SIZE      80
+extern unsigned char sim_stack[SIM_STACK_SIZE];
+#define STACK_LOW           (sim_stack)
+#define STACK_HIGH          (sim_stack + SIM_STACK_SIZE)
+#define STACK_POINTER()     (STACK_HIGH)
+
+/******************************************************************************
+ * INTRINSICS
+ *****************************************************************************/
+
+#ifdef SIM_MODEL
+// One instruction on the status register like on the chip, the delay a loop
+#define SIM_SR                          (*sim_reg16(sim16Count))
+#define __delay_cycles(cycles)          do{ unsigned long n = (cycles) / 3; while(n--) __asm__ volatile(""); }while(0)
+#define __no_operation()                __asm__ volatile("nop")
+#define __enable_interrupt()            (SIM_SR |= GIE)
+#define __disable_interrupt()           (SIM_SR &= ~GIE)
+#define __get_interrupt_state()         (SIM_SR)
+#define __set_interrupt_state(state)    (SIM_SR = (state))
+#define __bis_SR_register(bits)         (SIM_SR |= (bits))
+#define __bic_SR_register(bits)         (SIM_SR &= ~(bits))
+#define __bis_SR_register_on_exit(bits) (SIM_SR |= (bits))
+#define __bic_SR_register_on_exit(bits) (SIM_SR &= ~(bits))
+#define __get_SR_register()             (SIM_SR)
+#else
+// All of them are points at which the simulation runs, see sim.c.
+void __delay_cycles(unsigned long cycles);
+void __no_operation(void);
+void __enable_interrupt(void);
+void __disable_interrupt(void);
+unsigned int __get_interrupt_state(void);
+void __set_interrupt_state(unsigned int state);
+void __bis_SR_register(unsigned int bits);
+void __bic_SR_register(unsigned int bits);
+void __bis_SR_register_on_exit(unsigned int bits);
+void __bic_SR_register_on_exit(unsigned int bits);
+unsigned int __get_SR_register(void);
+#endif
+
+#endif /* SIM_MSP430G2553_H_ */
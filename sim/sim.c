@@ -0,0 +1,507 @@
+/***************************************************************************//**
+ * @file    sim.c
+ * @date    19.10.26
+ *
+ * @brief   Core of the simulation: registers, time, interrupts, intrinsics.
+ *
+ * Every register access of the game ends up in sim_reg8() or sim_reg16().
+ * Before the storage is handed out, registers which differ from their
+ * shadow are passed on to the peripherals as writes, the time moves on by
+ * a few cycles and due events and interrupts are handled. TX buffers hold
+ * an impossible value after each access, so writing the same byte twice
+ * still counts as two writes.
+ *
+ * Waits on flags set by ISRs call __no_operation() in their loop, so the
+ * time moves on there too. The run is deterministic: the same input gives
+ * the same output at the same cycle.
+ *
+ * sim_stop() and sim_reset() leave the game with a longjmp() back to
+ * sim_run() at its next register access or sleep, after a reset
+ * sim_run() calls it again.
+ ******************************************************************************/
+
+#include "./sim.h"
+#include "../libs/hal.h"
+#include <setjmp.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define ACCESS_CYCLES           4           // cycles a register access takes
+#define MAX_ISRS                1000        // ISRs in a row before the flags are considered stuck
+#define TXBUF_EMPTY             0xFFFF      // TX buffer after an access, a write stores a byte
+
+#define I2C_MODE()              ((sim_r8[simUCB0CTL0] & UCMODE_3) == UCMODE_3)
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+volatile unsigned char sim_r8[sim8Count];
+volatile unsigned int sim_r16[sim16Count];
+unsigned char sim_stack[SIM_STACK_SIZE];
+unsigned char sim_s8[sim8Count];            // value last passed on to the peripherals
+unsigned int sim_s16[sim16Count];
+
+SimHooks sim_hooks = {NULL, NULL, NULL, NULL};
+
+SimTime sim_time = 0;                       // cycles since reset
+SimTime sim_smclkTime = 0;                  // cycles SMCLK ran
+SimTime sim_nextMs = SIM_MS(1);             // time of the next sim_hooks.ms call
+SimTime sim_limit = SIM_NEVER;
+
+unsigned int sim_sr = 0;                    // status register of the CPU
+unsigned int *sim_exitSr = NULL;            // status register restored after the running ISR
+unsigned char sim_inIsr = 0;
+
+
+unsigned char sim_stopping = 0;
+int sim_code = 0;
+unsigned char sim_puc = 0;                  // IFG1 of a pending reset, see sim_reset()
+unsigned char sim_hanging = 0;              // see sim_hang()
+jmp_buf sim_exit;
+
+// ISRs of the game, see the #pragma vector of each
+void Timer1_A0(void);
+void Timer0_A0(void);
+void Timer_A1(void);
+void USCIAB0RX_ISR(void);
+void USCIAB0TX_ISR(void);
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+void sim_registers(unsigned char flags);
+void sim_passWrites(void);
+SimTime sim_nextEvent(void);
+void sim_moveTo(SimTime t);
+void sim_advance(SimTime cycles);
+void sim_interrupts(void);
+unsigned char sim_pending(void);
+void sim_callIsr(unsigned char vector);
+void sim_sync(unsigned long cycles);
+void sim_sleep(void);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+/**
+ * Set the registers to their values after a power up or a reset with
+ * <flags> in IFG1, the peripherals of the MCU start over as well.
+ */
+void sim_registers(unsigned char flags){
+    unsigned char id;
+
+    for(id = 0; id < sim8Count; id++){
+        sim_set8(id, 0);
+    }
+    for(id = 0; id < sim16Count; id++){
+        sim_set16(id, 0);
+    }
+    sim_set8(simCALBC1_1MHZ, 0x86);
+    sim_set8(simCALDCO_1MHZ, 0xB6);
+    sim_set8(simCALBC1_16MHZ, 0x8F);
+    sim_set8(simCALDCO_16MHZ, 0x8C);
+    sim_set8(simUCA0CTL1, UCSWRST);
+    sim_set8(simUCB0CTL1, UCSWRST);
+    sim_set8(simUCB0CTL0, UCSYNC);
+    sim_set8(simIFG2, UCA0TXIFG | UCB0TXIFG);
+    sim_set8(simIFG1, flags);
+    sim_set16(simWDTCTL, 0x6900);
+    sim_set16(simUCA0TXBUF, TXBUF_EMPTY);
+    sim_set16(simUCB0TXBUF, TXBUF_EMPTY);
+    timer_reset();
+    usci_reset();
+    sim_sr = 0;
+    sim_exitSr = NULL;
+    sim_inIsr = 0;
+    sim_hanging = 0;
+}
+
+/**
+ * Pass every register which changed since the last call on to its peripheral.
+ */
+void sim_passWrites(void){
+    unsigned char id;
+    unsigned char old;
+
+    for(id = 0; id < sim8Count; id++){
+        if(sim_r8[id] == sim_s8[id]){
+            continue;
+        }
+        old = sim_s8[id];
+        sim_s8[id] = sim_r8[id];
+        switch(id){
+            case simP2OUT:
+                board_written(old, sim_s8[id]);
+                break;
+            case simP3OUT:
+                lcd_model_written(sim_s8[simP2OUT], old, sim_s8[id]);
+                if((old ^ sim_s8[id]) & HAL_MASK(BOARD_FLASH_CS)){
+                    flash_model_select(!(sim_s8[id] & HAL_MASK(BOARD_FLASH_CS)));
+                }
+                break;
+            case simBCSCTL3:
+                timer_written(sim16Count);
+                break;
+            case simUCA0CTL0: case simUCA0CTL1: case simUCA0BR0: case simUCA0BR1: case simUCA0MCTL:
+            case simUCB0CTL0: case simUCB0CTL1: case simUCB0BR0: case simUCB0BR1:
+                usci_written8(id, old, sim_s8[id]);
+                break;
+        }
+    }
+    for(id = 0; id < sim16Count; id++){
+        if(sim_r16[id] == sim_s16[id]){
+            continue;
+        }
+        sim_s16[id] = sim_r16[id];
+        switch(id){
+            case simUCA0TXBUF:
+            case simUCB0TXBUF:
+                usci_written16(id, sim_s16[id] & 0xFF);
+                sim_set16(id, TXBUF_EMPTY);
+                break;
+            case simUCB0I2CSA:
+                break;
+            default:
+                timer_written(id);
+                break;
+        }
+    }
+}
+
+/**
+ * Returns the time of the next event of any peripheral.
+ */
+SimTime sim_nextEvent(void){
+    SimTime next = sim_nextMs;
+    SimTime t;
+
+    t = timer_next();
+    if(t < next){
+        next = t;
+    }
+    t = usci_next();
+    if(t < next){
+        next = t;
+    }
+    return next;
+}
+
+/**
+ * Move the time on to <t>, SMCLK only runs if SCG1 is off.
+ */
+void sim_moveTo(SimTime t){
+    if(t <= sim_time){
+        return;
+    }
+    if(!(sim_sr & SCG1)){
+        sim_smclkTime += t - sim_time;
+    }
+    sim_time = t;
+}
+
+/**
+ * Let <cycles> pass, with the events and interrupts due in between.
+ */
+void sim_advance(SimTime cycles){
+    SimTime target = sim_time + cycles;
+    SimTime next;
+
+    while((next = sim_nextEvent()) <= target && !sim_stopping){
+        sim_moveTo(next);
+        if(sim_time >= sim_nextMs){
+            sim_nextMs += SIM_MS(1);
+            if(sim_hooks.ms != NULL){
+                sim_hooks.ms();
+            }
+        }
+        if(timer_next() <= sim_time){
+            timer_event();
+        }
+        if(usci_next() <= sim_time){
+            usci_event();
+        }
+        sim_interrupts();
+        if(sim_time >= sim_limit){
+            sim_stop(0);
+        }
+    }
+    sim_moveTo(target);
+}
+
+/**
+ * Call the ISRs of all pending interrupts, highest priority first.
+ */
+void sim_interrupts(void){
+    unsigned int count = 0;
+    unsigned char vector;
+
+    if(!(sim_sr & GIE) || sim_inIsr){
+        return;
+    }
+    while((vector = sim_pending()) != 0){
+        if(++count > MAX_ISRS){
+            fprintf(stderr, "sim: interrupt %u never clears its flag\n", vector);
+            sim_stop(3);
+            return;
+        }
+        sim_callIsr(vector);
+    }
+}
+
+/**
+ * Returns the vector of the pending interrupt with the highest priority, 0 if none.
+ */
+unsigned char sim_pending(void){
+    unsigned char ie2 = sim_r8[simIE2] & sim_r8[simIFG2];
+
+    if((sim_r16[simTA1CCTL0] & (CCIE | CCIFG)) == (CCIE | CCIFG)){
+        return TIMER1_A0_VECTOR;
+    }
+    if((sim_r16[simTA0CCTL0] & (CCIE | CCIFG)) == (CCIE | CCIFG)){
+        return TIMER0_A0_VECTOR;
+    }
+    if((sim_r16[simTA0CTL] & (TAIE | TAIFG)) == (TAIE | TAIFG)){
+        return TIMER0_A1_VECTOR;
+    }
+    // USCI_B0 in I2C mode has its data flags on the TX vector and its
+    // state flags on the RX vector
+    if((ie2 & UCA0RXIFG) || (!I2C_MODE() && (ie2 & UCB0RXIFG)) ||
+       (I2C_MODE() && (sim_r8[simUCB0I2CIE] & sim_r8[simUCB0STAT] & (UCNACKIFG | UCSTPIFG | UCSTTIFG | UCALIFG)))){
+        return USCIAB0RX_VECTOR;
+    }
+    if((ie2 & (UCA0TXIFG | UCB0TXIFG)) || (I2C_MODE() && (ie2 & UCB0RXIFG))){
+        return USCIAB0TX_VECTOR;
+    }
+    return 0;
+}
+
+/**
+ * Enter the ISR of <vector> like the CPU: single source flags are cleared,
+ * the status register is saved and cleared and restored at the end.
+ */
+void sim_callIsr(unsigned char vector){
+    unsigned int saved = sim_sr;
+    unsigned int *outer = sim_exitSr;
+
+    sim_exitSr = &saved;
+    sim_sr &= ~(GIE | LPM4_bits);
+    sim_inIsr = 1;
+    switch(vector){
+        case TIMER1_A0_VECTOR:
+            sim_set16(simTA1CCTL0, sim_r16[simTA1CCTL0] & ~CCIFG);
+            Timer1_A0();
+            break;
+        case TIMER0_A0_VECTOR:
+            sim_set16(simTA0CCTL0, sim_r16[simTA0CCTL0] & ~CCIFG);
+            Timer0_A0();
+            break;
+        case TIMER0_A1_VECTOR:
+            Timer_A1();
+            break;
+        case USCIAB0RX_VECTOR:
+            USCIAB0RX_ISR();
+            break;
+        case USCIAB0TX_VECTOR:
+            USCIAB0TX_ISR();
+            break;
+    }
+    sim_passWrites();
+    sim_inIsr = 0;
+    sim_exitSr = outer;
+    sim_sr = saved;
+}
+
+/**
+ * The game reached a point at which the simulation runs: pass its writes
+ * on, let <cycles> pass and stop if sim_stop() was called. A hanging game
+ * stays here, only its ISRs run.
+ */
+void sim_sync(unsigned long cycles){
+    sim_passWrites();
+    sim_advance(cycles);
+    sim_interrupts();
+    while(sim_hanging && !sim_inIsr && !sim_stopping){
+        sim_advance(sim_nextEvent() - sim_time);
+    }
+    if(sim_stopping){
+        longjmp(sim_exit, 1);
+    }
+}
+
+/**
+ * CPUOFF is set: run from event to event until an ISR clears it on exit.
+ */
+void sim_sleep(void){
+    while((sim_sr & CPUOFF) && !sim_stopping){
+        sim_advance(sim_nextEvent() - sim_time);
+    }
+    if(sim_stopping){
+        longjmp(sim_exit, 1);
+    }
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+volatile unsigned char *sim_reg8(unsigned char id){
+    sim_sync(ACCESS_CYCLES);
+    switch(id){
+        case simP1IN:
+            sim_set8(id, sim_r8[simP1OUT] & sim_r8[simP1DIR]);
+            break;
+        case simP2IN:
+            sim_set8(id, board_p2in());
+            break;
+        case simP3IN:
+            sim_set8(id, sim_r8[simP3OUT] & sim_r8[simP3DIR]);
+            break;
+        case simUCA0RXBUF: case simUCA0STAT:
+        case simUCB0RXBUF: case simUCB0STAT:
+            usci_reading(id);
+            break;
+    }
+    return &sim_r8[id];
+}
+
+volatile unsigned int *sim_reg16(unsigned char id){
+    sim_sync(ACCESS_CYCLES);
+    switch(id){
+        case simTA0R:
+        case simTA1R:
+            timer_reading(id);
+            break;
+    }
+    return &sim_r16[id];
+}
+
+int sim_run(void (*game)(void), SimTime limit){
+    sim_registers(PORIFG);
+    sim_limit = limit;
+
+    setjmp(sim_exit);                       // sim_stop() and sim_reset() come back here
+    if(sim_puc){
+        sim_registers(sim_puc);
+        if(sim_hooks.reset != NULL){
+            sim_hooks.reset(sim_puc);
+        }
+        sim_puc = 0;
+        sim_stopping = 0;
+    }
+    if(!sim_stopping){
+        game();
+    }
+    return sim_code;
+}
+
+void sim_stop(int code){
+    if(!sim_stopping){
+        sim_code = code;
+        sim_stopping = 1;
+    }
+}
+
+void sim_reset(unsigned char flags){
+    if(!sim_stopping){
+        sim_puc = flags;
+        sim_stopping = 1;
+    }
+}
+
+void sim_hang(void){
+    sim_hanging = 1;
+}
+
+SimTime sim_now(void){
+    return sim_time;
+}
+
+SimTime sim_smclk(void){
+    return sim_smclkTime;
+}
+
+SimTime sim_atSmclk(SimTime smclk){
+    if(smclk == SIM_NEVER || (sim_sr & SCG1)){
+        return SIM_NEVER;
+    }
+    if(smclk <= sim_smclkTime){
+        return sim_time;
+    }
+    return sim_time + (smclk - sim_smclkTime);
+}
+
+void sim_set8(unsigned char id, unsigned char value){
+    sim_r8[id] = value;
+    sim_s8[id] = value;
+}
+
+void sim_set16(unsigned char id, unsigned int value){
+    sim_r16[id] = value;
+    sim_s16[id] = value;
+}
+
+/******************************************************************************
+ * INTRINSICS
+ *****************************************************************************/
+
+void __delay_cycles(unsigned long cycles){
+    sim_sync(cycles);
+}
+
+void __no_operation(void){
+    sim_sync(1);
+}
+
+void __enable_interrupt(void){
+    sim_sr |= GIE;
+    sim_sync(1);
+}
+
+void __disable_interrupt(void){
+    sim_sr &= ~GIE;
+    sim_sync(1);
+}
+
+unsigned int __get_interrupt_state(void){
+    return sim_sr & GIE;
+}
+
+void __set_interrupt_state(unsigned int state){
+    sim_sr = (sim_sr & ~GIE) | (state & GIE);
+    sim_sync(1);
+}
+
+void __bis_SR_register(unsigned int bits){
+    sim_sr |= bits;
+    sim_sync(1);
+    sim_sleep();
+}
+
+void __bic_SR_register(unsigned int bits){
+    sim_sr &= ~bits;
+    sim_sync(1);
+}
+
+void __bis_SR_register_on_exit(unsigned int bits){
+    if(sim_exitSr != NULL){
+        *sim_exitSr |= bits;
+    }
+}
+
+void __bic_SR_register_on_exit(unsigned int bits){
+    if(sim_exitSr != NULL){
+        *sim_exitSr &= ~bits;
+    }
+}
+
+unsigned int __get_SR_register(void){
+    sim_sync(1);
+    return sim_sr;
+}
@@ -0,0 +1,196 @@
+/***************************************************************************//**
+ * @file    sim.h
+ * @date    19.10.26
+ *
+ * @brief   Host simulation of the MSP430G2553 and the board around it.
+ *
+ * The game and the drivers are compiled for the PC against the register
+ * layer of sim/msp430g2553.h. Register writes drive simulated peripherals:
+ *
+ *      sim_lcd.c       HD44780 on P2.0-3 (D4-D7) and P3.0-2 (RS, RW, EN)
+ *      sim_board.c     the two 74HC194 with buttons and LEDs on P2,
+ *                      the PCF8591 ADAC with the joystick on I2C
+ *      sim_flash.c     M25P16 SPI flash, chip select P3.4
+ *      sim_usci.c      USCI_A0 UART, USCI_B0 as I2C or SPI
+ *      sim_timer.c     Timer0_A (buzzer PWM, LPM3 wake), Timer1_A, watchdog
+ *
+ * Time is counted in cycles of the 16 MHz clock. It only moves in the
+ * simulation: by __delay_cycles(), by a few cycles per register access and
+ * in low power modes up to the next event of a peripheral, so a headless
+ * run takes far less than real time. ISRs are called at these points when
+ * their flags are set and GIE is on, like the CPU does between instructions.
+ *
+ * A reset by the watchdog starts main() of the game over. The registers
+ * get their values after a reset, the RAM of the game keeps its values:
+ * the chip keeps the variables which the startup code doesn't touch
+ * (NOINIT), the others are set up again by the init functions of the game.
+ *
+ ******************************************************************************/
+
+#ifndef SIM_SIM_H_
+#define SIM_SIM_H_
+
+/******************************************************************************
+ * INCLUDES
+ *****************************************************************************/
+
+#include "./msp430g2553.h"
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define SIM_CLOCK               16000000UL  // MCLK and SMCLK, the DCO calibrated by initMSP()
+#define SIM_VLO                 12000UL     // ACLK from the VLO
+#define SIM_NEVER               (~(SimTime)0)
+
+#define SIM_MS(ms)              ((SimTime)(ms) * (SIM_CLOCK / 1000))
+
+#define SIM_FLASH_SIZE          0x200000UL  // 2 MB of the M25P16
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+typedef unsigned long long SimTime;         // cycles since reset
+
+// Called by the simulation, all may be NULL.
+typedef struct{
+    void (*ms)(void);                       // every simulated ms
+    void (*uart)(unsigned char byte);       // the MSP sent a byte on the UART
+    void (*tone)(unsigned long hz);         // the buzzer changed, 0 is silent
+    void (*reset)(unsigned char flags);     // the MCU was reset, IFG1 of the reset
+}SimHooks;
+
+extern SimHooks sim_hooks;
+
+extern volatile unsigned char sim_r8[sim8Count];        // storage of the registers
+extern volatile unsigned int sim_r16[sim16Count];
+
+/******************************************************************************
+ * FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+// Running the game
+
+/**
+ * Run <game> (main() of the game) until sim_stop() or until <limit>.
+ * Can only be called once per process, the game doesn't return, a reset
+ * calls it again. Returns the code of sim_stop(), 0 if the limit was
+ * reached.
+ */
+int sim_run(void (*game)(void), SimTime limit);
+
+/**
+ * End sim_run() with <code> at the next point the simulation runs.
+ */
+void sim_stop(int code);
+
+/**
+ * Reset the MCU at the next point the simulation runs, IFG1 gets <flags>
+ * (WDTIFG for the watchdog).
+ */
+void sim_reset(unsigned char flags);
+
+/**
+ * Let the game hang from its next register access outside of an ISR on,
+ * like a task in an endless loop. The ISRs still run, only a reset ends
+ * it.
+ */
+void sim_hang(void);
+
+/**
+ * Returns the simulated time.
+ */
+SimTime sim_now(void);
+
+// Inputs of the board
+
+/**
+ * Hold buttons 1 - 4 down, bit n - 1 is button n.
+ */
+void sim_buttons(unsigned char mask);
+
+/**
+ * Set the joystick, ADAC channel 0 (horizontal) and 1 (vertical).
+ * 128 is the middle, 0 is right or up, 255 left or down.
+ */
+void sim_joystick(unsigned char x, unsigned char y);
+
+/**
+ * Queue <length> bytes which the MSP receives on the UART.
+ */
+void sim_uartSend(const unsigned char *data, unsigned int length);
+
+// Outputs of the board
+
+/**
+ * Copy line <y> of the display into <text> (16 chars and a 0). Codes
+ * 0 - 7 (CGRAM) are replaced by <glyphs>[code], 0x7E and 0x7F by > and <.
+ */
+void sim_lcdLine(unsigned char y, char *text, const char *glyphs);
+
+/**
+ * Returns 1 if the display content changed since the last call.
+ */
+unsigned char sim_lcdChanged(void);
+
+/**
+ * Returns the LEDs, bit n - 1 is LED n.
+ */
+unsigned char sim_leds(void);
+
+/**
+ * Returns the frequency of the buzzer in Hz, 0 if it is silent.
+ */
+unsigned long sim_tone(void);
+
+/**
+ * Load the flash from the image <path>, or save it there.
+ * Returns 1 on success. A missing image leaves the flash erased.
+ */
+unsigned char sim_flashLoad(const char *path);
+unsigned char sim_flashSave(const char *path);
+
+/**
+ * Cut the power once the flash starts the <count>th sector erase (<erase>
+ * 1) or page program (<erase> 0) from now on. Only half of it is done,
+ * then the simulation ends like sim_stop(2).
+ * sim_flashCutting() returns 1 while the cut waits for it.
+ */
+void sim_flashCut(unsigned char erase, unsigned char count);
+unsigned char sim_flashCutting(void);
+
+// Between sim.c and the peripheral models
+
+SimTime sim_smclk(void);                        // SMCLK cycles, they stop in LPM3
+SimTime sim_atSmclk(SimTime smclk);             // sim_now() at SMCLK cycle <smclk>, SIM_NEVER in LPM3
+void sim_set8(unsigned char id, unsigned char value);   // change a register without a write
+void sim_set16(unsigned char id, unsigned int value);
+
+void lcd_model_written(unsigned char p2, unsigned char p3old, unsigned char p3);
+
+void board_written(unsigned char old, unsigned char p2);
+unsigned char board_p2in(void);
+void board_start(unsigned char address, unsigned char transmit);
+unsigned char board_acked(unsigned char address);
+void board_write(unsigned char byte);
+unsigned char board_read(void);
+
+void flash_model_select(unsigned char selected);
+unsigned char flash_model_exchange(unsigned char mosi);
+
+void usci_written8(unsigned char id, unsigned char old, unsigned char value);
+void usci_written16(unsigned char id, unsigned int value);
+void usci_reading(unsigned char id);
+void usci_reset(void);
+SimTime usci_next(void);
+void usci_event(void);
+
+void timer_written(unsigned char id);
+void timer_reading(unsigned char id);
+void timer_reset(void);
+SimTime timer_next(void);
+void timer_event(void);
+
+#endif /* SIM_SIM_H_ */
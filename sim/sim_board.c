@@ -0,0 +1,133 @@
+/***************************************************************************//**
+ * @file    sim_board.c
+ * @date    19.10.26
+ *
+ * @brief   Simulation of the shift registers and the ADAC of the board.
+ *
+ * Two 74HC194 share CLK (P2.4), /MR (P2.5) and DSR (P2.6). Register 1 has
+ * its mode on P2.2/P2.3, the buttons on its parallel inputs and QD on P2.7.
+ * Register 2 has its mode on P2.0/P2.1 and drives LED 1 - 4. Bit 0 of a
+ * register is QA, bit 3 is QD.
+ *
+ * The PCF8591 answers at 0x48 while P1.3 selects I2C. Like the chip, a read
+ * returns the conversion started by the previous read.
+ ******************************************************************************/
+
+#include "./sim.h"
+#include "../libs/hal.h"
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define CLK                     HAL_MASK(BOARD_SHIFT_CLK)
+#define MR                      HAL_MASK(BOARD_SHIFT_MR)
+#define DSR                     HAL_MASK(BOARD_SHIFT_SR)
+#define QD                      BIT3        // of a register
+#define P2_QD                   HAL_MASK(BOARD_SHIFT_QD)
+#define I2C_SELECT              HAL_MASK(BOARD_BUS_I2C)
+
+#define ADAC_ADDRESS            0x48
+#define ADAC_INCREMENT          0x04        // control byte: auto increment the channel
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+unsigned char board_reg1 = 0;               // buttons
+unsigned char board_reg2 = 0;               // LEDs
+unsigned char board_buttons = 0;
+
+unsigned char board_joystick[2] = {128, 128};
+unsigned char board_control = 0;            // last control byte of the ADAC
+unsigned char board_channel = 0;
+unsigned char board_conversion = 0x80;      // result of the last conversion
+unsigned char board_first = 0;              // the next written byte is the control byte
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+unsigned char board_clock(unsigned char q, unsigned char mode, unsigned char inputs, unsigned char dsr);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+/**
+ * Returns a 74HC194 after a rising clock in <mode> (S1 S0).
+ */
+unsigned char board_clock(unsigned char q, unsigned char mode, unsigned char inputs, unsigned char dsr){
+    switch(mode){
+        case 1:                             // shift right, QA from DSR
+            return ((q << 1) | dsr) & 0x0F;
+        case 2:                             // shift left, DSL is low
+            return q >> 1;
+        case 3:                             // parallel load
+            return inputs & 0x0F;
+    }
+    return q;
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void board_written(unsigned char old, unsigned char p2){
+    if(!(p2 & MR)){
+        board_reg1 = 0;
+        board_reg2 = 0;
+        return;
+    }
+    if((p2 & CLK) && !(old & CLK)){
+        board_reg1 = board_clock(board_reg1, (p2 >> 2) & 3, board_buttons, (p2 & DSR) != 0);
+        board_reg2 = board_clock(board_reg2, p2 & 3, 0, (p2 & DSR) != 0);
+    }
+}
+
+unsigned char board_p2in(void){
+    unsigned char in = sim_r8[simP2OUT] & sim_r8[simP2DIR] & ~P2_QD;
+
+    return board_reg1 & QD ? in | P2_QD : in;
+}
+
+unsigned char board_acked(unsigned char address){
+    return address == ADAC_ADDRESS && (sim_r8[simP1OUT] & I2C_SELECT);
+}
+
+void board_start(unsigned char address, unsigned char transmit){
+    (void)address;
+    board_first = transmit;
+}
+
+void board_write(unsigned char byte){
+    if(board_first){
+        board_control = byte;
+        board_channel = byte & 3;
+        board_first = 0;
+    }
+    // further bytes would be the DAC output, which has no model
+}
+
+unsigned char board_read(void){
+    unsigned char result = board_conversion;
+
+    board_conversion = board_channel < 2 ? board_joystick[board_channel] : 0x80;
+    if(board_control & ADAC_INCREMENT){
+        board_channel = (board_channel + 1) & 3;
+    }
+    return result;
+}
+
+void sim_buttons(unsigned char mask){
+    board_buttons = mask & 0x0F;
+}
+
+void sim_joystick(unsigned char x, unsigned char y){
+    board_joystick[0] = x;
+    board_joystick[1] = y;
+}
+
+unsigned char sim_leds(void){
+    return board_reg2;
+}
@@ -0,0 +1,241 @@
+/***************************************************************************//**
+ * @file    sim_flash.c
+ * @date    19.10.26
+ *
+ * @brief   Simulation of the M25P16 SPI flash.
+ *
+ * Only the commands of flash.c and library.c are known. Page program and
+ * the erases start when the chip select rises and keep the flash busy for
+ * a typical time of the data sheet, in which it ignores all but RDSR.
+ *
+ * sim_flashCut() cuts the power in the middle of a page program or sector
+ * erase: only the first half of it is done, then the flash ignores
+ * everything and the simulation ends.
+ ******************************************************************************/
+
+#include "./sim.h"
+#include <stdio.h>
+#include <string.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define CMD_WREN                0x06
+#define CMD_WRDI                0x04
+#define CMD_RDSR                0x05
+#define CMD_READ                0x03
+#define CMD_PP                  0x02
+#define CMD_SE                  0xD8
+#define CMD_BE                  0xC7
+#define CMD_RDID                0x9F
+
+#define STATUS_WIP              0x01
+#define STATUS_WEL              0x02
+
+#define PAGE                    256
+#define SECTOR                  0x10000UL
+
+#define TIME_PP                 SIM_MS(1)
+#define TIME_SE                 SIM_MS(600)
+#define TIME_BE                 SIM_MS(13000)
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+unsigned char flash_memory[SIM_FLASH_SIZE];
+unsigned char flash_initialised = 0;
+
+unsigned char flash_selected = 0;
+unsigned char flash_command = 0;
+unsigned int flash_index = 0;               // bytes since the chip select fell
+unsigned long flash_address = 0;
+unsigned char flash_page[PAGE];             // data of a page program
+unsigned int flash_programmed = 0;          // bytes in flash_page
+unsigned char flash_wel = 0;
+SimTime flash_busyUntil = 0;
+
+unsigned char flash_cutCommand = 0;         // CMD_PP or CMD_SE which cuts the power, 0 if none
+unsigned char flash_cutCount;               // that many of them are started first
+unsigned char flash_off = 0;                // 1 after the cut
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+void flash_model_power(void);
+unsigned char flash_model_busy(void);
+void flash_model_cut(void);
+void flash_model_execute(void);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void flash_model_power(void){
+    if(!flash_initialised){
+        memset(flash_memory, 0xFF, sizeof(flash_memory));
+        flash_initialised = 1;
+    }
+}
+
+unsigned char flash_model_busy(void){
+    return sim_now() < flash_busyUntil;
+}
+
+/**
+ * A page program or sector erase starts, cut the power if sim_flashCut()
+ * waits for it.
+ */
+void flash_model_cut(void){
+    if(flash_command == flash_cutCommand && --flash_cutCount == 0){
+        flash_cutCommand = 0;
+        flash_off = 1;
+        sim_stop(2);
+    }
+}
+
+/**
+ * The chip select rose after a write command.
+ */
+void flash_model_execute(void){
+    unsigned long base;
+    unsigned long length;
+    unsigned int i;
+
+    if(!flash_wel || flash_model_busy()){
+        return;
+    }
+    switch(flash_command){
+        case CMD_PP:
+            if(flash_index < 4){
+                return;
+            }
+            flash_model_cut();
+            base = flash_address & ~(PAGE - 1UL);
+            length = flash_off ? flash_programmed / 2 : flash_programmed;
+            for(i = 0; i < length && i < PAGE; i++){
+                flash_memory[base + ((flash_address + i) & (PAGE - 1))] &= flash_page[i];
+            }
+            flash_busyUntil = sim_now() + TIME_PP;
+            break;
+        case CMD_SE:
+            if(flash_index != 4){
+                return;
+            }
+            flash_model_cut();
+            memset(&flash_memory[flash_address & ~(SECTOR - 1)], 0xFF, flash_off ? SECTOR / 2 : SECTOR);
+            flash_busyUntil = sim_now() + TIME_SE;
+            break;
+        case CMD_BE:
+            if(flash_index != 1){
+                return;
+            }
+            memset(flash_memory, 0xFF, sizeof(flash_memory));
+            flash_busyUntil = sim_now() + TIME_BE;
+            break;
+        default:
+            return;
+    }
+    flash_wel = 0;
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void flash_model_select(unsigned char selected){
+    flash_model_power();
+    if(flash_off){
+        return;
+    }
+    if(flash_selected && !selected){
+        flash_model_execute();
+    }
+    flash_selected = selected;
+    flash_index = 0;
+    flash_programmed = 0;
+}
+
+unsigned char flash_model_exchange(unsigned char mosi){
+    unsigned int index = flash_index++;
+    unsigned char miso = 0xFF;
+
+    if(!flash_selected || flash_off){
+        return 0xFF;
+    }
+    if(index == 0){
+        flash_command = mosi;
+        flash_address = 0;
+        if(flash_model_busy() && mosi != CMD_RDSR){
+            flash_command = 0;              // ignored while programming or erasing
+        }
+        else if(mosi == CMD_WREN){
+            flash_wel = 1;
+        }
+        else if(mosi == CMD_WRDI){
+            flash_wel = 0;
+        }
+        return miso;
+    }
+    switch(flash_command){
+        case CMD_RDSR:
+            miso = (flash_model_busy() ? STATUS_WIP : 0) | (flash_wel ? STATUS_WEL : 0);
+            break;
+        case CMD_RDID:
+            miso = index == 1 ? 0x20 : index == 2 ? 0x20 : index == 3 ? 0x15 : 0x00;
+            break;
+        case CMD_READ:
+        case CMD_PP:
+        case CMD_SE:
+            if(index < 4){
+                flash_address = (flash_address << 8 | mosi) & (SIM_FLASH_SIZE - 1);
+            }
+            else if(flash_command == CMD_READ){
+                miso = flash_memory[flash_address];
+                flash_address = (flash_address + 1) & (SIM_FLASH_SIZE - 1);
+            }
+            else if(flash_command == CMD_PP && flash_programmed < PAGE){
+                flash_page[flash_programmed++] = mosi;
+            }
+            break;
+    }
+    return miso;
+}
+
+void sim_flashCut(unsigned char erase, unsigned char count){
+    flash_cutCommand = erase ? CMD_SE : CMD_PP;
+    flash_cutCount = count;
+}
+
+unsigned char sim_flashCutting(void){
+    return flash_cutCommand != 0;
+}
+
+unsigned char sim_flashLoad(const char *path){
+    FILE *file;
+    size_t length;
+
+    flash_model_power();
+    file = fopen(path, "rb");
+    if(file == NULL){
+        return 0;
+    }
+    length = fread(flash_memory, 1, sizeof(flash_memory), file);
+    fclose(file);
+    return length > 0;
+}
+
+unsigned char sim_flashSave(const char *path){
+    FILE *file;
+    size_t length;
+
+    flash_model_power();
+    file = fopen(path, "wb");
+    if(file == NULL){
+        return 0;
+    }
+    length = fwrite(flash_memory, 1, sizeof(flash_memory), file);
+    return fclose(file) == 0 && length == sizeof(flash_memory);
+}
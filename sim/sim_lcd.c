@@ -0,0 +1,176 @@
+/***************************************************************************//**
+ * @file    sim_lcd.c
+ * @date    19.10.26
+ *
+ * @brief   Simulation of the HD44780 display in 4 bit mode.
+ *
+ * The controller latches D4 - D7 when EN falls. After reset it is in 8 bit
+ * mode, so each nibble is a whole instruction until the function set of
+ * lcd_init() switches to 4 bit mode. Reads (RW high) are not simulated.
+ ******************************************************************************/
+
+#include "./sim.h"
+#include "../libs/hal.h"
+#include <string.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define RS                      HAL_MASK(BOARD_LCD_RS)
+#define EN                      HAL_MASK(BOARD_LCD_EN)
+
+#define DDRAM                   0x80
+#define LINE_LENGTH             40          // DDRAM cells of a line
+#define LINE2                   0x40        // DDRAM address of line 2
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+unsigned char lcd_ddram[DDRAM];
+unsigned char lcd_cgram[64];
+unsigned char lcd_address = 0;              // DDRAM or CGRAM address counter
+unsigned char lcd_toCgram = 0;              // data goes to CGRAM
+unsigned char lcd_increment = 1;
+unsigned char lcd_displayOn = 0;
+unsigned char lcd_shift = 0;                // display shift in cells
+
+unsigned char lcd_fourBit = 0;
+unsigned char lcd_high = 0;                 // first nibble in 4 bit mode
+unsigned char lcd_second = 0;               // the next nibble is the second one
+unsigned char lcd_changed = 1;
+unsigned char lcd_powered = 0;
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+void lcd_model_instruction(unsigned char code);
+void lcd_model_data(unsigned char code);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void lcd_model_instruction(unsigned char code){
+    if(code & 0x80){                        // set DDRAM address
+        lcd_address = code & 0x7F;
+        lcd_toCgram = 0;
+    }
+    else if(code & 0x40){                   // set CGRAM address
+        lcd_address = code & 0x3F;
+        lcd_toCgram = 1;
+    }
+    else if(code & 0x20){                   // function set
+        lcd_fourBit = !(code & 0x10);
+    }
+    else if(code & 0x10){                   // cursor or display shift
+        if(code & 0x08){
+            lcd_shift = (lcd_shift + (code & 0x04 ? LINE_LENGTH - 1 : 1)) % LINE_LENGTH;
+            lcd_changed = 1;
+        }
+    }
+    else if(code & 0x08){                   // display on/off control
+        lcd_displayOn = (code & 0x04) != 0;
+        lcd_changed = 1;
+    }
+    else if(code & 0x04){                   // entry mode set
+        lcd_increment = (code & 0x02) != 0;
+    }
+    else if(code & 0x02){                   // return home
+        lcd_address = 0;
+        lcd_toCgram = 0;
+        lcd_shift = 0;
+        lcd_changed = 1;
+    }
+    else if(code & 0x01){                   // clear display
+        memset(lcd_ddram, ' ', sizeof(lcd_ddram));
+        lcd_address = 0;
+        lcd_toCgram = 0;
+        lcd_shift = 0;
+        lcd_increment = 1;
+        lcd_changed = 1;
+    }
+}
+
+void lcd_model_data(unsigned char code){
+    if(lcd_toCgram){
+        lcd_cgram[lcd_address & 0x3F] = code;
+        lcd_address = (lcd_address + (lcd_increment ? 1 : 0x3F)) & 0x3F;
+        lcd_changed = 1;
+        return;
+    }
+    lcd_ddram[lcd_address & 0x7F] = code;
+    lcd_address = (lcd_address + (lcd_increment ? 1 : 0x7F)) & 0x7F;
+    lcd_changed = 1;
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void lcd_model_written(unsigned char p2, unsigned char p3old, unsigned char p3){
+    unsigned char nibble = p2 & 0x0F;
+    unsigned char code;
+
+    if(!lcd_powered){
+        memset(lcd_ddram, ' ', sizeof(lcd_ddram));
+        lcd_powered = 1;
+    }
+    if(!(p3old & EN) || (p3 & EN)){
+        return;                             // only the falling edge latches
+    }
+    if(!lcd_fourBit){
+        code = nibble << 4;
+        lcd_second = 0;
+    }
+    else if(!lcd_second){
+        lcd_high = nibble;
+        lcd_second = 1;
+        return;
+    }
+    else{
+        code = lcd_high << 4 | nibble;
+        lcd_second = 0;
+    }
+    if(p3 & RS){
+        lcd_model_data(code);
+    }
+    else{
+        lcd_model_instruction(code);
+    }
+}
+
+void sim_lcdLine(unsigned char y, char *text, const char *glyphs){
+    unsigned char x;
+    unsigned char c;
+
+    for(x = 0; x < 16; x++){
+        c = lcd_ddram[(y ? LINE2 : 0) + (x + lcd_shift) % LINE_LENGTH];
+        if(!lcd_displayOn){
+            c = ' ';
+        }
+        else if(c < 16){
+            c = glyphs[c & 7];
+        }
+        else if(c == 0x7E){
+            c = '>';
+        }
+        else if(c == 0x7F){
+            c = '<';
+        }
+        else if(c >= 0x80){
+            c = '?';
+        }
+        text[x] = c;
+    }
+    text[16] = 0;
+}
+
+unsigned char sim_lcdChanged(void){
+    unsigned char changed = lcd_changed;
+
+    lcd_changed = 0;
+    return changed;
+}
@@ -0,0 +1,415 @@
+/***************************************************************************//**
+ * @file    sim_main.c
+ * @date    19.10.26
+ *
+ * @brief   Command line front end of the host simulation.
+ *
+ * Usage: synthhero [-s script] [-t ms] [-f flash] [-u uart] [-p] [-v]
+ *
+ *      -s script   input script, see below
+ *      -t ms       stop after ms of simulated time (default 60000)
+ *      -f flash    flash image, loaded at the start and saved at the end
+ *      -u uart     file for the bytes the game sends on the UART
+ *      -p          connect the UART to a pseudo terminal and run in real
+ *                  time, e.g. for tools/chart_upload.py; no time limit
+ *                  (SIGINT or SIGTERM end it like quit)
+ *      -v          print every change of the display
+ *
+ * A script has one command per line, '#' starts a comment. Each line starts
+ * with the ms at which it runs, or +ms after the previous line:
+ *
+ *      500 press 1             hold button 1 - 4 (press 1 3 holds two)
+ *      +100 release            release all buttons
+ *      +0 joy up               joystick up, down, left, right or center
+ *      +0 uart 55 02 00 AB     bytes the game receives, in hex
+ *      +50 expect 0 Play a Song
+ *                              fail unless line 0 or 1 of the display
+ *                              shows the text (trailing blanks ignored)
+ *      +0 print                print the display, LEDs and buzzer
+ *      +0 cut erase            cut the power once the flash starts the next
+ *      +0 cut program 2        sector erase or the 2nd page program from now,
+ *                              half of it is done and the simulation ends;
+ *                              the next line fails if it comes first
+ *      +0 hang                 the game stops like a task in an endless loop,
+ *                              until the watchdog resets the MCU
+ *      +0 quit                 end the simulation successfully
+ *
+ * The exit code is 0 if every expect matched, 1 otherwise. A reset of the
+ * MCU fails the run unless the script let the game hang.
+ ******************************************************************************/
+
+#define _GNU_SOURCE
+
+#include "./sim.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define MAX_LINES               4096        // commands in a script
+#define LINE_LENGTH             256
+#define DEFAULT_LIMIT           60000       // ms
+
+#define GLYPHS                  "*?v?^???"  // CGRAM 0: note, 2: down, 4: up
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+typedef struct{
+    unsigned long ms;
+    unsigned int line;                      // line in the script file
+    char text[LINE_LENGTH];                 // command without the time
+}SimCommand;
+
+SimCommand main_commands[MAX_LINES];
+unsigned int main_count = 0;
+unsigned int main_next = 0;                 // next command to run
+unsigned long main_ms = 0;                  // simulated ms
+unsigned char main_failed = 0;
+unsigned char main_verbose = 0;
+unsigned char main_hung = 0;                // the script let the game hang, a reset is expected
+volatile sig_atomic_t main_signaled = 0;    // SIGINT or SIGTERM, quit at the next ms
+char main_shown[34];                        // display at the last print of -v
+
+FILE *main_uart = NULL;
+int main_pty = -1;
+struct timespec main_start;
+
+int game_main(void);                        // main() of main.c
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+void main_game(void);
+unsigned char main_load(const char *path);
+void main_print(void);
+void main_run(SimCommand *c);
+void main_pace(void);
+void main_ms_hook(void);
+void main_uart_hook(unsigned char byte);
+void main_reset_hook(unsigned char flags);
+void main_signal(int number);
+unsigned char main_openPty(void);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void main_game(void){
+    game_main();
+}
+
+/**
+ * Read the script at <path> into main_commands. Returns 0 on errors.
+ */
+unsigned char main_load(const char *path){
+    FILE *file = fopen(path, "r");
+    char buffer[LINE_LENGTH];
+    char *text;
+    char *end;
+    unsigned long ms = 0;
+    unsigned int line = 0;
+
+    if(file == NULL){
+        perror(path);
+        return 0;
+    }
+    while(fgets(buffer, sizeof(buffer), file) != NULL){
+        line++;
+        buffer[strcspn(buffer, "#\r\n")] = 0;
+        text = buffer + strspn(buffer, " \t");
+        if(*text == 0){
+            continue;
+        }
+        if(*text == '+'){
+            ms += strtoul(text + 1, &end, 10);
+        }
+        else{
+            ms = strtoul(text, &end, 10);
+        }
+        if(end == text || main_count == MAX_LINES){
+            fprintf(stderr, "%s:%u: expected a time\n", path, line);
+            fclose(file);
+            return 0;
+        }
+        main_commands[main_count].ms = ms;
+        main_commands[main_count].line = line;
+        strcpy(main_commands[main_count].text, end + strspn(end, " \t"));
+        main_count++;
+    }
+    fclose(file);
+    return 1;
+}
+
+/**
+ * Print the display, the LEDs and the buzzer.
+ */
+void main_print(void){
+    char text[17];
+    unsigned char leds = sim_leds();
+    unsigned char i;
+
+    sim_lcdLine(0, text, GLYPHS);
+    printf("%8lu ms |%s| leds ", main_ms, text);
+    for(i = 0; i < 4; i++){
+        putchar(leds & (1 << i) ? '1' + i : '.');
+    }
+    printf(" tone %lu\n", sim_tone());
+    sim_lcdLine(1, text, GLYPHS);
+    printf("            |%s|\n", text);
+    fflush(stdout);
+}
+
+/**
+ * Run a script command.
+ */
+void main_run(SimCommand *c){
+    char *arg = c->text + strcspn(c->text, " \t");
+    char text[17];
+    char *end;
+    unsigned char mask = 0;
+    unsigned char byte;
+    unsigned long value;
+    size_t length;
+
+    arg += strspn(arg, " \t");
+    if(sim_flashCutting()){
+        printf("line %u: the flash didn't start what the cut waits for\n", c->line);
+        main_failed = 1;
+        sim_stop(1);
+        return;
+    }
+    if(!strncmp(c->text, "press", 5)){
+        while((value = strtoul(arg, &end, 10)) != 0 && end != arg){
+            mask |= 1 << ((value - 1) & 3);
+            arg = end;
+        }
+        sim_buttons(mask);
+    }
+    else if(!strncmp(c->text, "release", 7)){
+        sim_buttons(0);
+    }
+    else if(!strncmp(c->text, "joy", 3)){
+        if(!strncmp(arg, "up", 2)){
+            sim_joystick(128, 0);
+        }
+        else if(!strncmp(arg, "down", 4)){
+            sim_joystick(128, 255);
+        }
+        else if(!strncmp(arg, "left", 4)){
+            sim_joystick(255, 128);
+        }
+        else if(!strncmp(arg, "right", 5)){
+            sim_joystick(0, 128);
+        }
+        else{
+            sim_joystick(128, 128);
+        }
+    }
+    else if(!strncmp(c->text, "uart", 4)){
+        while((value = strtoul(arg, &end, 16)) <= 0xFF && end != arg){
+            byte = value;
+            sim_uartSend(&byte, 1);
+            arg = end;
+        }
+    }
+    else if(!strncmp(c->text, "expect", 6)){
+        value = strtoul(arg, &end, 10);
+        arg = end + strspn(end, " \t");
+        length = strlen(arg);
+        while(length && arg[length - 1] == ' '){
+            arg[--length] = 0;
+        }
+        sim_lcdLine(value & 1, text, GLYPHS);
+        length = 16;
+        while(length && text[length - 1] == ' '){
+            text[--length] = 0;
+        }
+        if(strcmp(text, arg)){
+            printf("line %u: expected \"%s\" on line %lu, got \"%s\"\n", c->line, arg, value & 1, text);
+            main_print();
+            main_failed = 1;
+            sim_stop(1);
+        }
+    }
+    else if(!strncmp(c->text, "cut", 3)){
+        value = strtoul(arg + strcspn(arg, " \t"), NULL, 10);
+        sim_flashCut(!strncmp(arg, "erase", 5), value ? value : 1);
+    }
+    else if(!strncmp(c->text, "print", 5)){
+        main_print();
+    }
+    else if(!strncmp(c->text, "hang", 4)){
+        main_hung = 1;
+        sim_hang();
+    }
+    else if(!strncmp(c->text, "quit", 4)){
+        sim_stop(2);
+    }
+    else{
+        fprintf(stderr, "line %u: unknown command \"%s\"\n", c->line, c->text);
+        main_failed = 1;
+        sim_stop(1);
+    }
+}
+
+/**
+ * Keep the simulation at real time, for the pseudo terminal.
+ */
+void main_pace(void){
+    struct timespec now;
+    long ahead;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    ahead = main_ms - ((now.tv_sec - main_start.tv_sec) * 1000L + (now.tv_nsec - main_start.tv_nsec) / 1000000L);
+    if(ahead > 0){
+        usleep(ahead * 1000L);
+    }
+}
+
+/**
+ * Called every simulated ms.
+ */
+void main_ms_hook(void){
+    unsigned char buffer[64];
+    char lines[34];
+    ssize_t length;
+
+    main_ms++;
+    if(main_signaled){
+        sim_stop(2);                        // from here the flash image is saved
+    }
+    while(main_next < main_count && main_commands[main_next].ms <= main_ms){
+        main_run(&main_commands[main_next++]);
+    }
+    if(main_verbose && sim_lcdChanged()){
+        sim_lcdLine(0, lines, GLYPHS);
+        sim_lcdLine(1, lines + 17, GLYPHS);
+        if(memcmp(lines, main_shown, sizeof(lines))){
+            memcpy(main_shown, lines, sizeof(lines));
+            main_print();
+        }
+    }
+    if(main_pty >= 0){
+        length = read(main_pty, buffer, sizeof(buffer));
+        if(length > 0){
+            sim_uartSend(buffer, length);
+        }
+        main_pace();
+    }
+}
+
+void main_uart_hook(unsigned char byte){
+    if(main_uart != NULL){
+        fputc(byte, main_uart);
+    }
+    if(main_pty >= 0){
+        write(main_pty, &byte, 1);
+    }
+}
+
+void main_reset_hook(unsigned char flags){
+    printf("%8lu ms reset, IFG1 0x%02X\n", main_ms, flags);
+    if(!main_hung){
+        main_failed = 1;
+    }
+    main_hung = 0;
+}
+
+void main_signal(int number){
+    (void)number;
+    main_signaled = 1;
+}
+
+/**
+ * Open a raw pseudo terminal for the UART. Returns 0 on errors.
+ */
+unsigned char main_openPty(void){
+    struct termios raw;
+
+    main_pty = posix_openpt(O_RDWR | O_NOCTTY);
+    if(main_pty < 0 || grantpt(main_pty) || unlockpt(main_pty)){
+        perror("pty");
+        return 0;
+    }
+    tcgetattr(main_pty, &raw);
+    cfmakeraw(&raw);
+    tcsetattr(main_pty, TCSANOW, &raw);
+    fcntl(main_pty, F_SETFL, O_NONBLOCK);
+    fprintf(stderr, "UART on %s\n", ptsname(main_pty));
+    clock_gettime(CLOCK_MONOTONIC, &main_start);
+    return 1;
+}
+
+/******************************************************************************
+ * MAIN
+ *****************************************************************************/
+
+int main(int argc, char **argv){
+    const char *flash = NULL;
+    SimTime limit = SIM_MS(DEFAULT_LIMIT);
+    int option;
+    int code;
+
+    while((option = getopt(argc, argv, "s:t:f:u:pv")) != -1){
+        switch(option){
+            case 's':
+                if(!main_load(optarg)){
+                    return 2;
+                }
+                break;
+            case 't':
+                limit = SIM_MS(strtoul(optarg, NULL, 10));
+                break;
+            case 'f':
+                flash = optarg;
+                sim_flashLoad(flash);
+                break;
+            case 'u':
+                main_uart = fopen(optarg, "wb");
+                if(main_uart == NULL){
+                    perror(optarg);
+                    return 2;
+                }
+                break;
+            case 'p':
+                if(!main_openPty()){
+                    return 2;
+                }
+                limit = SIM_NEVER;
+                break;
+            case 'v':
+                main_verbose = 1;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-s script] [-t ms] [-f flash] [-u uart] [-p] [-v]\n", argv[0]);
+                return 2;
+        }
+    }
+    sim_hooks.ms = main_ms_hook;
+    sim_hooks.uart = main_uart_hook;
+    sim_hooks.reset = main_reset_hook;
+    signal(SIGINT, main_signal);
+    signal(SIGTERM, main_signal);
+    code = sim_run(main_game, limit);
+    if(code != 0 && code != 2){
+        main_failed = 1;                    // stuck interrupt
+    }
+    if(flash != NULL && !sim_flashSave(flash)){
+        perror(flash);
+    }
+    if(main_uart != NULL){
+        fclose(main_uart);
+    }
+    return main_failed;
+}
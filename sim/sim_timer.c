@@ -0,0 +1,328 @@
+/***************************************************************************//**
+ * @file    sim_timer.c
+ * @date    19.10.26
+ *
+ * @brief   Simulation of Timer0_A, Timer1_A and the watchdog timer.
+ *
+ * The counters are not stepped, TAxR is calculated from the cycles of its
+ * clock since the counter was last known: SMCLK cycles (sim_smclk()), which
+ * stop in LPM3, or for ACLK the time itself (sim_now()). Only compares with
+ * CCIE and the overflow with TAIE are events, the outputs of Timer0_A are
+ * reduced to the frequency of the buzzer. The watchdog in watchdog mode
+ * resets the MCU when it expires (sim_reset()).
+ ******************************************************************************/
+
+#include "./sim.h"
+#include <stdio.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+// offsets of the registers behind TAxCTL
+#define T_CTL                   0
+#define T_R                     1
+#define T_CCTL                  2
+#define T_CCR                   5
+
+#define CHANNELS                3
+#define OVERFLOW                CHANNELS    // slot of the TAIFG event
+
+#define MODE(ctl)               (((ctl) >> 4) & 3)
+#define DIVIDER(ctl)            (1U << (((ctl) >> 6) & 3))
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+typedef struct{
+    unsigned char first;                    // id of TAxCTL
+    unsigned int ctl;                       // TAxCTL the counter runs with
+    unsigned int r;                         // TAxR at <base>
+    SimTime base;                           // timer_clock() at which TAxR became <r>
+    SimTime due[CHANNELS + 1];              // timer_clock() of the next compare or overflow
+}SimTimer;
+
+SimTimer sim_timers[2] = {{simTA0CTL}, {simTA1CTL}};
+
+unsigned char wdt_on = 0;
+unsigned char wdt_aclk = 0;                 // counts ACLK, else SMCLK
+SimTime wdt_period = 0;                     // in cycles of its clock domain
+SimTime wdt_due = SIM_NEVER;                // sim_now() or sim_smclk() of the next interval
+
+unsigned long timer_tone = 0;
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+unsigned int timer_reg(SimTimer *t, unsigned char offset);
+unsigned long timer_aclk(void);
+unsigned char timer_onAclk(SimTimer *t);
+SimTime timer_clock(SimTimer *t);
+unsigned long timer_cycles(SimTimer *t);
+unsigned char timer_counting(SimTimer *t);
+void timer_count(SimTimer *t);
+unsigned long timer_distance(SimTimer *t, unsigned int compare);
+void timer_schedule(SimTimer *t);
+void timer_updateTone(void);
+void timer_wdt(void);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+unsigned int timer_reg(SimTimer *t, unsigned char offset){
+    return sim_r16[t->first + offset];
+}
+
+/**
+ * Returns the cycles of the CPU clock in one cycle of ACLK.
+ */
+unsigned long timer_aclk(void){
+    return SIM_CLOCK / ((sim_r8[simBCSCTL3] & LFXT1S_3) == LFXT1S_2 ? SIM_VLO : 32768UL);
+}
+
+unsigned char timer_onAclk(SimTimer *t){
+    return (t->ctl & TASSEL_3) == TASSEL_1;
+}
+
+/**
+ * Returns the time the clock of the timer ran.
+ */
+SimTime timer_clock(SimTimer *t){
+    return timer_onAclk(t) ? sim_now() : sim_smclk();
+}
+
+/**
+ * Returns the cycles of timer_clock() in one count.
+ */
+unsigned long timer_cycles(SimTimer *t){
+    return timer_onAclk(t) ? DIVIDER(t->ctl) * timer_aclk() : DIVIDER(t->ctl);
+}
+
+/**
+ * Returns 1 if the timer counts, only SMCLK and ACLK are connected on this
+ * board.
+ */
+unsigned char timer_counting(SimTimer *t){
+    if(MODE(t->ctl) == 0 || ((t->ctl & TASSEL_3) != TASSEL_2 && !timer_onAclk(t))){
+        return 0;
+    }
+    return MODE(t->ctl) != MC_1 >> 4 || timer_reg(t, T_CCR) != 0;
+}
+
+/**
+ * Bring <r> up to the current cycle of its clock and set TAIFG on an overflow.
+ */
+void timer_count(SimTimer *t){
+    SimTime now = timer_clock(t);
+    unsigned long ticks;
+    unsigned long total;
+    unsigned long period;
+
+    if(!timer_counting(t)){
+        t->base = now;
+        return;
+    }
+    ticks = (now - t->base) / timer_cycles(t);
+    t->base += (SimTime)ticks * timer_cycles(t);
+    total = t->r + ticks;
+    period = MODE(t->ctl) == MC_2 >> 4 ? 0x10000UL : timer_reg(t, T_CCR) + 1UL;  // up/down counts like up
+    if(total >= period){
+        sim_set16(t->first + T_CTL, timer_reg(t, T_CTL) | TAIFG);
+    }
+    t->r = total % period;
+}
+
+/**
+ * Returns the counts until TAxR reaches <compare>, 0 if never.
+ */
+unsigned long timer_distance(SimTimer *t, unsigned int compare){
+    unsigned long period = 0x10000UL;
+    unsigned long d;
+
+    if(MODE(t->ctl) != MC_2 >> 4){
+        period = timer_reg(t, T_CCR) + 1UL;
+        if(compare >= period){
+            return 0;
+        }
+    }
+    d = (compare + period - t->r) % period;
+    return d == 0 ? period : d;
+}
+
+/**
+ * Calculate the events of a timer after its counter or registers changed.
+ */
+void timer_schedule(SimTimer *t){
+    unsigned char n;
+    unsigned long d;
+
+    for(n = 0; n <= OVERFLOW; n++){
+        t->due[n] = SIM_NEVER;
+    }
+    if(!timer_counting(t)){
+        return;
+    }
+    for(n = 0; n < CHANNELS; n++){
+        if(timer_reg(t, T_CCTL + n) & CCIE){
+            d = timer_distance(t, timer_reg(t, T_CCR + n));
+            if(d){
+                t->due[n] = t->base + (SimTime)d * timer_cycles(t);
+            }
+        }
+    }
+    if(timer_reg(t, T_CTL) & TAIE){
+        t->due[OVERFLOW] = t->base + (SimTime)timer_distance(t, 0) * timer_cycles(t);
+    }
+}
+
+/**
+ * The buzzer on P3.6 (TA0.2) plays SMCLK / (TA0CCR0 + 1) in up mode.
+ */
+void timer_updateTone(void){
+    SimTimer *t = &sim_timers[0];
+    unsigned int ccr0 = timer_reg(t, T_CCR);
+    unsigned long tone = 0;
+
+    if(MODE(t->ctl) == MC_1 >> 4 && timer_counting(t) && !timer_onAclk(t) && (timer_reg(t, T_CCTL + 2) & OUTMOD_7) &&
+       timer_reg(t, T_CCR + 2) != 0 && timer_reg(t, T_CCR + 2) <= ccr0){
+        tone = SIM_CLOCK / DIVIDER(t->ctl) / (ccr0 + 1UL);
+    }
+    if(tone != timer_tone){
+        timer_tone = tone;
+        if(sim_hooks.tone != NULL){
+            sim_hooks.tone(tone);
+        }
+    }
+}
+
+/**
+ * WDTCTL or BCSCTL3 was written.
+ */
+void timer_wdt(void){
+    static const unsigned int dividers[4] = {32768, 8192, 512, 64};
+    unsigned int ctl = sim_r16[simWDTCTL];
+
+    wdt_on = !(ctl & WDTHOLD);
+    wdt_aclk = (ctl & WDTSSEL) != 0;
+    wdt_period = wdt_aclk ? dividers[ctl & 3] * timer_aclk() : dividers[ctl & 3];
+    wdt_due = wdt_on ? (wdt_aclk ? sim_now() : sim_smclk()) + wdt_period : SIM_NEVER;
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void timer_written(unsigned char id){
+    SimTimer *t;
+    unsigned int value;
+
+    if(id == simWDTCTL || id == sim16Count){
+        value = sim_r16[simWDTCTL];
+        if(id == simWDTCTL && (value & 0xFF00) != WDTPW){
+            fprintf(stderr, "sim: WDTCTL written without password, reset\n");
+            sim_reset(WDTIFG);
+            return;
+        }
+        sim_set16(simWDTCTL, (value & 0xFF & ~WDTCNTCL) | 0x6900);
+        timer_wdt();
+        return;
+    }
+    t = &sim_timers[id >= simTA1CTL];
+    timer_count(t);                         // up to now with the old settings
+    switch(id - t->first){
+        case T_CTL:
+            t->ctl = timer_reg(t, T_CTL);
+            t->base = timer_clock(t);       // the clock may have changed
+            if(t->ctl & TACLR){
+                t->r = 0;
+                sim_set16(id, t->ctl & ~TACLR);
+            }
+            break;
+        case T_R:
+            t->r = timer_reg(t, T_R);
+            t->base = timer_clock(t);
+            break;
+    }
+    timer_schedule(t);
+    if(t == &sim_timers[0]){
+        timer_updateTone();
+    }
+}
+
+void timer_reading(unsigned char id){
+    SimTimer *t = &sim_timers[id >= simTA1CTL];
+
+    timer_count(t);
+    sim_set16(id, t->r);
+}
+
+SimTime timer_next(void){
+    SimTime next = wdt_aclk ? wdt_due : sim_atSmclk(wdt_due);
+    SimTime due;
+    unsigned char i;
+    unsigned char n;
+
+    for(i = 0; i < 2; i++){
+        if(!timer_counting(&sim_timers[i])){
+            continue;
+        }
+        for(n = 0; n <= OVERFLOW; n++){
+            due = timer_onAclk(&sim_timers[i]) ? sim_timers[i].due[n] : sim_atSmclk(sim_timers[i].due[n]);
+            if(due < next){
+                next = due;
+            }
+        }
+    }
+    return next;
+}
+
+void timer_event(void){
+    SimTimer *t;
+    unsigned char i;
+    unsigned char n;
+
+    if(wdt_on && (wdt_aclk ? sim_now() : sim_smclk()) >= wdt_due){
+        if(!(sim_r16[simWDTCTL] & WDTTMSEL)){
+            fprintf(stderr, "sim: watchdog expired, reset\n");
+            sim_reset(WDTIFG);
+            return;
+        }
+        sim_set8(simIFG1, sim_r8[simIFG1] | WDTIFG);
+        wdt_due += wdt_period;
+    }
+    for(i = 0; i < 2; i++){
+        t = &sim_timers[i];
+        if(!timer_counting(t)){
+            continue;
+        }
+        for(n = 0; n < CHANNELS; n++){
+            if(timer_clock(t) >= t->due[n]){
+                sim_set16(t->first + T_CCTL + n, timer_reg(t, T_CCTL + n) | CCIFG);
+            }
+        }
+        timer_count(t);                     // sets TAIFG on an overflow
+        timer_schedule(t);
+    }
+}
+
+void timer_reset(void){
+    unsigned char i;
+    unsigned char n;
+
+    for(i = 0; i < 2; i++){
+        sim_timers[i].ctl = 0;
+        sim_timers[i].r = 0;
+        for(n = 0; n <= OVERFLOW; n++){
+            sim_timers[i].due[n] = SIM_NEVER;
+        }
+    }
+    timer_wdt();
+    timer_updateTone();
+}
+
+unsigned long sim_tone(void){
+    return timer_tone;
+}
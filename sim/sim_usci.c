@@ -0,0 +1,416 @@
+/***************************************************************************//**
+ * @file    sim_usci.c
+ * @date    19.10.26
+ *
+ * @brief   Simulation of USCI_A0 as UART and USCI_B0 as I2C or SPI master.
+ *
+ * Each module shifts one byte at a time from SMCLK. A byte written to TXBUF
+ * while another one is shifted waits in the buffer, so TXIFG behaves like
+ * on the chip. The UART receives the bytes queued by sim_uartSend(), the
+ * SPI exchanges with the flash while its chip select and P1.3 are low, I2C
+ * talks to the ADAC in sim_board.c.
+ ******************************************************************************/
+
+#include "./sim.h"
+#include "../libs/hal.h"
+#include <stddef.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define RX_QUEUE                4096        // bytes sim_uartSend() can queue, power of 2
+#define UART_BITS               10          // start, 8 data, stop
+#define I2C_BITS                9           // 8 data, acknowledge
+
+#define I2C_MODE()              ((sim_r8[simUCB0CTL0] & UCMODE_3) == UCMODE_3)
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+// state of the I2C master
+typedef enum{
+    i2cIdle,
+    i2cAddress,                             // sending the address after a start
+    i2cTransmit,                            // shifting a byte out
+    i2cHoldTx,                              // waiting for TXBUF, a stop or a start
+    i2cReceive,                             // shifting a byte in
+    i2cHoldRx,                              // waiting until RXBUF is read
+    i2cStop,                                // sending the stop condition
+}I2cState;
+
+typedef struct{
+    unsigned char shifting;                 // a byte is in the shift register
+    unsigned char buffered;                 // a byte waits in TXBUF
+    unsigned char shift;                    // byte in the shift register
+    unsigned char buffer;                   // byte in TXBUF
+    SimTime done;                           // SMCLK cycle the shift register is done
+}SimShifter;
+
+SimShifter usci_a = {0, 0, 0, 0, SIM_NEVER};
+SimShifter usci_b = {0, 0, 0, 0, SIM_NEVER};
+I2cState usci_i2c = i2cIdle;
+unsigned char usci_miso = 0xFF;            // answer to the byte the SPI shifts
+
+unsigned char usci_rxQueue[RX_QUEUE];
+unsigned int usci_rxHead = 0;
+unsigned int usci_rxTail = 0;
+unsigned char usci_receiving = 0;           // UART shifts in usci_rxQueue[usci_rxTail]
+SimTime usci_rxDone = SIM_NEVER;
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+unsigned long usci_bitCycles(unsigned char br0);
+void usci_setIfg(unsigned char bits);
+void usci_clearIfg(unsigned char bits);
+void usci_shiftOut(SimShifter *s, unsigned long cycles, unsigned char ifg);
+void usci_uartDone(void);
+void usci_uartRx(void);
+void usci_spiStart(void);
+void usci_spiDone(void);
+void usci_i2cStart(void);
+void usci_i2cShifted(void);
+void usci_i2cReceive(void);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+/**
+ * Returns the SMCLK cycles of one bit from the baud rate registers after <br0>.
+ */
+unsigned long usci_bitCycles(unsigned char br0){
+    unsigned long br = sim_r8[br0] | (unsigned int)sim_r8[br0 + 1] << 8;
+
+    return br ? br : 1;
+}
+
+void usci_setIfg(unsigned char bits){
+    sim_set8(simIFG2, sim_r8[simIFG2] | bits);
+}
+
+void usci_clearIfg(unsigned char bits){
+    sim_set8(simIFG2, sim_r8[simIFG2] & ~bits);
+}
+
+/**
+ * Move the buffered byte into the idle shift register, TXBUF is free again.
+ */
+void usci_shiftOut(SimShifter *s, unsigned long cycles, unsigned char ifg){
+    s->shifting = 1;
+    s->buffered = 0;
+    s->shift = s->buffer;
+    s->done = sim_smclk() + cycles;
+    usci_setIfg(ifg);
+}
+
+/**
+ * The UART sent a byte.
+ */
+void usci_uartDone(void){
+    usci_a.shifting = 0;
+    usci_a.done = SIM_NEVER;
+    if(sim_hooks.uart != NULL){
+        sim_hooks.uart(usci_a.shift);
+    }
+    if(usci_a.buffered){
+        usci_shiftOut(&usci_a, UART_BITS * usci_bitCycles(simUCA0BR0), UCA0TXIFG);
+    }
+}
+
+/**
+ * Start receiving the next queued byte.
+ */
+void usci_uartRx(void){
+    if(usci_receiving || usci_rxHead == usci_rxTail || (sim_r8[simUCA0CTL1] & UCSWRST)){
+        return;
+    }
+    usci_receiving = 1;
+    usci_rxDone = sim_smclk() + UART_BITS * usci_bitCycles(simUCA0BR0);
+}
+
+/**
+ * Start shifting the buffered byte over the SPI. The flash sees the byte
+ * now: flash.c raises the chip select while the last byte still shifts,
+ * which would cut off every command if the byte was exchanged at its end.
+ */
+void usci_spiStart(void){
+    usci_shiftOut(&usci_b, 8 * usci_bitCycles(simUCB0BR0), UCB0TXIFG);
+    usci_miso = 0xFF;
+    if(!(sim_r8[simP1OUT] & HAL_MASK(BOARD_BUS_I2C)) && !(sim_r8[simP3OUT] & HAL_MASK(BOARD_FLASH_CS))){
+        usci_miso = flash_model_exchange(usci_b.shift);
+    }
+}
+
+/**
+ * The SPI exchanged a byte.
+ */
+void usci_spiDone(void){
+    usci_b.shifting = 0;
+    usci_b.done = SIM_NEVER;
+    sim_set8(simUCB0RXBUF, usci_miso);
+    usci_setIfg(UCB0RXIFG);
+    if(usci_b.buffered){
+        usci_spiStart();
+    }
+}
+
+/**
+ * UCTXSTT was set: (repeated) start and the address of UCB0I2CSA.
+ */
+void usci_i2cStart(void){
+    usci_i2c = i2cAddress;
+    usci_b.done = sim_smclk() + (I2C_BITS + 1) * usci_bitCycles(simUCB0BR0);
+    if(sim_r8[simUCB0CTL1] & UCTR){
+        usci_setIfg(UCB0TXIFG);
+    }
+}
+
+/**
+ * Start receiving a byte from the slave.
+ */
+void usci_i2cReceive(void){
+    usci_i2c = i2cReceive;
+    usci_b.done = sim_smclk() + I2C_BITS * usci_bitCycles(simUCB0BR0);
+}
+
+/**
+ * The address, a byte or the stop condition was shifted.
+ */
+void usci_i2cShifted(void){
+    unsigned char ctl1 = sim_r8[simUCB0CTL1];
+    unsigned char address = sim_r16[simUCB0I2CSA] & 0x7F;
+    unsigned long bit = usci_bitCycles(simUCB0BR0);
+
+    usci_b.done = SIM_NEVER;
+    switch(usci_i2c){
+        case i2cAddress:
+            ctl1 &= ~UCTXSTT;
+            sim_set8(simUCB0CTL1, ctl1);
+            if(!board_acked(address)){
+                sim_set8(simUCB0STAT, sim_r8[simUCB0STAT] | UCNACKIFG);
+                usci_i2c = i2cHoldTx;
+                break;
+            }
+            board_start(address, (ctl1 & UCTR) != 0);
+            if(!(ctl1 & UCTR)){
+                usci_i2cReceive();
+                break;
+            }
+            // the buffered byte is sent
+            // fall through
+        case i2cTransmit:
+            if(usci_i2c == i2cTransmit){
+                board_write(usci_b.shift);
+            }
+            usci_b.shifting = 0;
+            if(usci_b.buffered){
+                usci_i2c = i2cTransmit;
+                usci_shiftOut(&usci_b, I2C_BITS * bit, UCB0TXIFG);
+            }
+            else if(ctl1 & UCTXSTT){
+                usci_i2cStart();
+            }
+            else if(ctl1 & UCTXSTP){
+                usci_i2c = i2cStop;
+                usci_b.done = sim_smclk() + bit;
+            }
+            else{
+                usci_i2c = i2cHoldTx;
+            }
+            break;
+        case i2cReceive:
+            sim_set8(simUCB0RXBUF, board_read());
+            usci_setIfg(UCB0RXIFG);
+            if(ctl1 & UCTXSTP){
+                usci_i2c = i2cStop;
+                usci_b.done = sim_smclk() + bit;
+            }
+            else{
+                usci_i2c = i2cHoldRx;
+            }
+            break;
+        case i2cStop:
+            sim_set8(simUCB0CTL1, ctl1 & ~UCTXSTP);
+            usci_i2c = i2cIdle;
+            break;
+        default:
+            break;
+    }
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void usci_written8(unsigned char id, unsigned char old, unsigned char value){
+    unsigned char rising = value & ~old;
+
+    switch(id){
+        case simUCA0CTL1:
+            if(rising & UCSWRST){
+                usci_a.shifting = 0;
+                usci_a.buffered = 0;
+                usci_a.done = SIM_NEVER;
+                usci_receiving = 0;
+                usci_rxDone = SIM_NEVER;
+                sim_set8(simIE2, sim_r8[simIE2] & ~(UCA0RXIE | UCA0TXIE));
+                usci_clearIfg(UCA0RXIFG);
+                usci_setIfg(UCA0TXIFG);
+            }
+            usci_uartRx();
+            break;
+        case simUCB0CTL1:
+            if(value & UCSWRST){
+                if(rising & UCSWRST){
+                    usci_b.shifting = 0;
+                    usci_b.buffered = 0;
+                    usci_b.done = SIM_NEVER;
+                    usci_i2c = i2cIdle;
+                    sim_set8(simIE2, sim_r8[simIE2] & ~(UCB0RXIE | UCB0TXIE));
+                    sim_set8(simUCB0STAT, 0);
+                    usci_clearIfg(UCB0RXIFG);
+                    usci_setIfg(UCB0TXIFG);
+                }
+                break;
+            }
+            if(!I2C_MODE()){
+                break;
+            }
+            if(old & UCSWRST){
+                usci_clearIfg(UCB0TXIFG);           // I2C starts with TXIFG cleared
+            }
+            if(rising & UCTXSTT){
+                if(usci_i2c == i2cIdle || usci_i2c == i2cHoldTx || usci_i2c == i2cHoldRx){
+                    usci_i2cStart();
+                }
+            }
+            else if(rising & UCTXSTP){
+                if(usci_i2c == i2cHoldTx || usci_i2c == i2cHoldRx || usci_i2c == i2cIdle){
+                    usci_i2c = i2cStop;
+                    usci_b.done = sim_smclk() + usci_bitCycles(simUCB0BR0);
+                }
+            }
+            break;
+    }
+}
+
+void usci_written16(unsigned char id, unsigned int value){
+    if(id == simUCA0TXBUF){
+        if(sim_r8[simUCA0CTL1] & UCSWRST){
+            return;
+        }
+        usci_clearIfg(UCA0TXIFG);
+        usci_a.buffer = value;
+        usci_a.buffered = 1;
+        if(!usci_a.shifting){
+            usci_shiftOut(&usci_a, UART_BITS * usci_bitCycles(simUCA0BR0), UCA0TXIFG);
+        }
+        return;
+    }
+    if(sim_r8[simUCB0CTL1] & UCSWRST){
+        return;
+    }
+    usci_clearIfg(UCB0TXIFG);
+    usci_b.buffer = value;
+    usci_b.buffered = 1;
+    if(!I2C_MODE()){
+        if(!usci_b.shifting){
+            usci_spiStart();
+        }
+    }
+    else if(usci_i2c == i2cHoldTx && (sim_r8[simUCB0CTL1] & UCTR)){
+        usci_i2c = i2cTransmit;
+        usci_shiftOut(&usci_b, I2C_BITS * usci_bitCycles(simUCB0BR0), UCB0TXIFG);
+    }
+}
+
+void usci_reading(unsigned char id){
+    switch(id){
+        case simUCA0RXBUF:
+            usci_clearIfg(UCA0RXIFG);
+            sim_set8(simUCA0STAT, sim_r8[simUCA0STAT] & ~UCOE);
+            break;
+        case simUCA0STAT:
+            sim_set8(id, (sim_r8[id] & ~UCBUSY) | (usci_a.shifting || usci_receiving ? UCBUSY : 0));
+            break;
+        case simUCB0RXBUF:
+            usci_clearIfg(UCB0RXIFG);
+            if(I2C_MODE() && usci_i2c == i2cHoldRx){
+                usci_i2cReceive();
+            }
+            break;
+        case simUCB0STAT:
+            if(I2C_MODE()){
+                sim_set8(id, (sim_r8[id] & ~UCBBUSY) | (usci_i2c != i2cIdle ? UCBBUSY : 0));
+            }
+            else{
+                sim_set8(id, (sim_r8[id] & ~UCBUSY) | (usci_b.shifting || usci_b.buffered ? UCBUSY : 0));
+            }
+            break;
+    }
+}
+
+void usci_reset(void){
+    usci_a.shifting = 0;
+    usci_a.buffered = 0;
+    usci_a.done = SIM_NEVER;
+    usci_b = usci_a;
+    usci_i2c = i2cIdle;
+    usci_receiving = 0;
+    usci_rxDone = SIM_NEVER;
+    usci_rxTail = usci_rxHead;              // sent while the MCU was reset
+}
+
+SimTime usci_next(void){
+    SimTime next = usci_a.shifting ? usci_a.done : SIM_NEVER;
+
+    if(usci_receiving && usci_rxDone < next){
+        next = usci_rxDone;
+    }
+    if(usci_b.done < next){
+        next = usci_b.done;
+    }
+    return sim_atSmclk(next);
+}
+
+void usci_event(void){
+    SimTime now = sim_smclk();
+
+    if(usci_a.shifting && usci_a.done <= now){
+        usci_uartDone();
+    }
+    if(usci_receiving && usci_rxDone <= now){
+        if(sim_r8[simIFG2] & UCA0RXIFG){
+            sim_set8(simUCA0STAT, sim_r8[simUCA0STAT] | UCOE);
+        }
+        sim_set8(simUCA0RXBUF, usci_rxQueue[usci_rxTail]);
+        usci_rxTail = (usci_rxTail + 1) & (RX_QUEUE - 1);
+        usci_setIfg(UCA0RXIFG);
+        usci_receiving = 0;
+        usci_rxDone = SIM_NEVER;
+        usci_uartRx();
+    }
+    if(usci_b.done <= now){
+        if(I2C_MODE()){
+            usci_i2cShifted();
+        }
+        else{
+            usci_spiDone();
+        }
+    }
+}
+
+void sim_uartSend(const unsigned char *data, unsigned int length){
+    while(length--){
+        if(((usci_rxHead + 1) & (RX_QUEUE - 1)) == usci_rxTail){
+            break;                          // a full queue drops the rest
+        }
+        usci_rxQueue[usci_rxHead] = *data++;
+        usci_rxHead = (usci_rxHead + 1) & (RX_QUEUE - 1);
+    }
+    usci_uartRx();
+}
@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+"""Host test of tools/chart_upload.py against libs/loader.c.
+
+Runs on the PC without a board, after make sim:
+
+    python3 tests/chart_upload_test.py [build/synthhero]
+
+Checks that the packer gives the same bytes as the charts of libs/songs.c
+and that a packed chart decodes back to its notes like chart.c does. Then
+the simulation runs the game with its UART on a pseudo terminal (-p) and
+tests/upload.sim puts it into "Upload Song": a chart uploaded through the
+pty ends up complete in the flash image, even with a damaged frame and a
+lost ack, and the loader refuses a chart shorter than the display. Returns
+0 if everything passed.
+"""
+
+import os
+import re
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+sys.path.insert(0, os.path.join(ROOT, "tools"))
+
+import chart_upload as cu   # noqa: E402
+
+failures = 0
+
+
+def check(ok, what):
+    global failures
+    if not ok:
+        print("FAIL " + what)
+        failures += 1
+
+
+# notes1 of the first version of the game, one char per slot
+SONG1 = """
+name: Song 1
+period: 125
+tones: 262 349 392 523
+notes:
+........ ........ 1...4... 2...3... 3.3...1. ..4...2. ..3..3.1 ...1..4.
+..2...3. ..3.3... 1...2... 3...4.4. ..1..... ........ ........
+"""
+
+
+def songs_chart(name):
+    """The bytes of chart <name> in libs/songs.c."""
+    with open(os.path.join(ROOT, "libs", "songs.c")) as f:
+        source = f.read()
+    body = re.search(r"%s\[\] = \{(.*?)\};" % name, source, re.S).group(1)
+    length = int(re.search(r"CHART_LENGTH\((\d+)\)", body).group(1))
+    out = bytearray(struct.pack("<H", length))
+    for gap, lane in re.findall(r"CHART_NOTE\(\s*(\d+),\s*(\d+)\)", body):
+        out.append(int(gap) << 2 | (int(lane) - 1))
+    out.append(cu.CHART_END)
+    return bytes(out)
+
+
+def decode(chart):
+    """Lane sets per slot, like chart_next() of chart.c."""
+    length = chart[0] | chart[1] << 8
+    slots = [set() for _ in range(length)]
+    last = 0
+    for b in chart[2:]:
+        if b == cu.CHART_END:
+            break
+        if b == cu.CHART_SKIP:
+            last += 63
+            continue
+        last += b >> 2
+        slots[last].add((b & 3) + 1)
+    return slots
+
+
+class FaultyUploader(cu.Uploader):
+    """Damages the second data frame once and loses the ack of the third."""
+
+    def __init__(self, fd):
+        super().__init__(fd)
+        self.data_frames = 0
+        self.answers = {}
+
+    def exchange(self, data, timeout):
+        if data[1] == cu.LOADER_DATA:
+            self.data_frames += 1
+            if self.data_frames == 2:
+                os.write(self.fd, data[:-1] + bytes([data[-1] ^ 0xFF]))
+                self.answers["damaged"] = self.ack(timeout)
+            elif self.data_frames == 3:
+                os.write(self.fd, data)
+                self.answers["lost"] = self.ack(timeout)
+                self.answers["repeated"] = super().exchange(data, timeout)
+                return self.answers["repeated"]
+        return super().exchange(data, timeout)
+
+
+def wait_for(path, text, timeout):
+    """Waits until the -v output of the simulation in <path> shows <text>."""
+    end = time.monotonic() + timeout
+    while time.monotonic() < end:
+        with open(path) as f:
+            if text in f.read():
+                return True
+        time.sleep(0.05)
+    return False
+
+
+def test_pack():
+    name, period, tones, slots = cu.parse_chart(SONG1)
+    chart, notes = cu.pack_chart(slots)
+    check(name == "Song 1" and period == 125 and tones == [262, 349, 392, 523], "header of SONG1")
+    check(len(slots) == 120, "SONG1 has 120 slots")
+    check(chart == songs_chart("chart1"), "SONG1 packs to chart1 of songs.c")
+    check(notes == len(chart) - 3, "notes of SONG1")
+
+    # chords and pauses longer than one note byte
+    text = "period: 100\ntones: 1 2 3 4\nnotes:\n[14]" + "." * 140 + "2 . [23]"
+    _, _, _, slots = cu.parse_chart(text)
+    chart, notes = cu.pack_chart(slots)
+    check(notes == 5, "notes of chords")
+    check(cu.CHART_SKIP in chart, "long pause uses CHART_SKIP")
+    check(decode(chart) == slots, "chart decodes to its notes")
+
+
+def test_upload(sim):
+    """Uploads to libs/loader.c of the simulation through its -p pty."""
+    directory = tempfile.mkdtemp()
+    image = os.path.join(directory, "flash.bin")
+    shown = os.path.join(directory, "display.txt")
+    with open(shown, "w") as out:
+        game = subprocess.Popen([sim, "-p", "-v", "-s", os.path.join(ROOT, "tests", "upload.sim"), "-f", image],
+                                stdout=out, stderr=subprocess.PIPE, universal_newlines=True)
+    try:
+        port = re.match(r"UART on (\S+)", game.stderr.readline())
+        check(port is not None, "simulation opened its pty")
+        check(wait_for(shown, "|Waiting...", 10), "game waits for an upload")
+        if port is None:
+            return
+        fd = cu.open_port(port.group(1), 115200)
+
+        _, period, tones, slots = cu.parse_chart(SONG1)
+
+        # shorter than the display: refused by the host before anything is
+        # sent, and by the loader once the header of the chart arrives
+        chart, notes = cu.pack_chart(slots[:cu.MIN_SLOTS - 1])
+        try:
+            cu.Uploader(-1).upload(5, chart, notes, period, tones, "Short")
+            refused = False
+        except cu.UploadError:
+            refused = True
+        check(refused, "chart of %d slots refused" % (cu.MIN_SLOTS - 1))
+        uploader = cu.Uploader(fd)
+        try:
+            begin = uploader.exchange(cu.frame(cu.LOADER_BEGIN,
+                                               cu.begin_payload(5, chart, notes, period, tones, "Short")),
+                                      cu.ERASE_TIMEOUT)
+            data = uploader.exchange(cu.frame(cu.LOADER_DATA, struct.pack("<H", 0) + chart), cu.FRAME_TIMEOUT)
+        except cu.UploadError as error:
+            print(error)
+            begin = data = None
+        check(begin is not None and begin[0] == cu.STATUS_OK, "short chart begun")
+        check(data is not None and data[0] == cu.STATUS_INVALID, "loader refused the short chart")
+
+        # longer than one flash page, the last frame is short
+        chart, notes = cu.pack_chart(slots * 12)
+        uploader = FaultyUploader(fd)
+        try:
+            uploader.upload(3, chart, notes, period, tones, "Twelve Times Song")
+            ok = True
+        except cu.UploadError as error:
+            print(error)
+            ok = False
+        check(ok, "upload finished")
+        damaged = uploader.answers.get("damaged")
+        lost = uploader.answers.get("lost")
+        repeated = uploader.answers.get("repeated")
+        check(damaged is not None and damaged[0] == cu.STATUS_CRC, "damaged frame answered with loaderCrc")
+        check(lost is not None and lost[0] == cu.STATUS_OK, "frame of the lost ack taken")
+        check(repeated == (cu.STATUS_ORDER, 3 * cu.CHUNK), "repeated frame answered with the next offset")
+        check(wait_for(shown, "|Done, slot 4", 5), "game shows the new song")
+        os.close(fd)
+    finally:
+        game.terminate()
+        code = game.wait(10)
+    check(code == 0, "simulation ran the script (exit code %d)" % code)
+
+    with open(image, "rb") as f:
+        flash = f.read()
+    shutil.rmtree(directory)
+    song = (3 + 1) << 16                                # LIBRARY_ADDRESS(3)
+    header = struct.unpack("<HHHH4H12s", flash[song:song + 28])
+    check(header[0] == 0x4643, "magic programmed")
+    check(header[1:4] == (len(chart), notes, period) and list(header[4:8]) == tones, "header")
+    check(header[8] == b"Twelve Times", "name cut to 12 chars")
+    check(flash[song + 0x100:song + 0x100 + len(chart)] == chart, "chart in the flash")
+    check(flash[(5 + 1) << 16:((5 + 1) << 16) + 2] == b"\xff\xff", "short chart left without magic")
+
+
+def main():
+    test_pack()
+    test_upload(sys.argv[1] if len(sys.argv) > 1 else os.path.join(ROOT, "build", "synthhero"))
+    print("%d failures" % failures)
+    return failures != 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,161 @@
+/***************************************************************************//**
+ * @file    hal_test.c
+ * @date    19.10.26
+ *
+ * @brief   Host test of the HAL_TRACE backend of hal.h on the shift registers.
+ *
+ * Runs on the PC, shift.c is built with HAL_TRACE against the registers of
+ * sim/msp430g2553.h, which are plain arrays here:
+ *
+ *      make build/hal_test
+ *      ./build/hal_test
+ *
+ * Checks the pin accesses hal_trace() recorded for shift_init(), every LED
+ * of stateLED() and stateButton() against the sequences the two 74HC194
+ * need, with the pins of board.h, and that the port registers end up like
+ * the accesses say. Returns 0 if everything passed.
+ ******************************************************************************/
+
+#include "../libs/hal.h"
+#include "../libs/shift.h"
+#include <stdio.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+// A pin of board.h with its access, the way the HAL_* macros take it
+#define ACCESS(access, pin)     ACCESS_(access, pin)
+#define ACCESS_(access, port, mask)     {(access), (port), (mask)}
+
+// Cleared registers with the clock low, then one bit each: data and a
+// rising edge of the clock
+#define SHIFT_CLEAR             ACCESS(halLow, BOARD_SHIFT_MR), ACCESS(halHigh, BOARD_SHIFT_MR)
+#define SHIFT_START             SHIFT_CLEAR, ACCESS(halLow, BOARD_SHIFT_CLK)
+#define SHIFT_IN(access)        ACCESS(access, BOARD_SHIFT_SR), ACCESS(halHigh, BOARD_SHIFT_CLK), \
+                                ACCESS(halLow, BOARD_SHIFT_CLK)
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+unsigned int failures = 0;
+unsigned int sequences = 0;
+
+volatile unsigned char registers8[sim8Count];
+volatile unsigned int registers16[sim16Count];
+
+const HalRecord init[] = {
+    ACCESS(halOutput, BOARD_SHIFT_OUTPUTS),
+    ACCESS(halGpio, BOARD_SHIFT_GPIO),
+};
+
+// LED n is the first of n bits shifted in, a 1 followed by n - 1 zeros
+const HalRecord led0[] = {SHIFT_CLEAR};
+const HalRecord led1[] = {SHIFT_START, SHIFT_IN(halHigh)};
+const HalRecord led2[] = {SHIFT_START, SHIFT_IN(halHigh), SHIFT_IN(halLow)};
+const HalRecord led3[] = {SHIFT_START, SHIFT_IN(halHigh), SHIFT_IN(halLow), SHIFT_IN(halLow)};
+const HalRecord led4[] = {SHIFT_START, SHIFT_IN(halHigh), SHIFT_IN(halLow), SHIFT_IN(halLow), SHIFT_IN(halLow)};
+
+// register 2 off, register 1 loads the buttons in parallel and shifts
+// them out on QD, button 4 first
+const HalRecord buttons[] = {
+    SHIFT_CLEAR,
+    ACCESS(halHigh, BOARD_SHIFT_CLK),
+    ACCESS(halLow, BOARD_SHIFT_SR),
+    ACCESS(halLow, BOARD_SHIFT_S0_2),
+    ACCESS(halLow, BOARD_SHIFT_S1_2),
+    ACCESS(halHigh, BOARD_SHIFT_S0_1),
+    ACCESS(halHigh, BOARD_SHIFT_S1_1),
+    ACCESS(halLow, BOARD_SHIFT_CLK),
+    ACCESS(halHigh, BOARD_SHIFT_CLK),
+    ACCESS(halLow, BOARD_SHIFT_S1_1),
+    ACCESS(halRead, BOARD_SHIFT_QD),
+    ACCESS(halLow, BOARD_SHIFT_CLK),
+    ACCESS(halHigh, BOARD_SHIFT_CLK),
+    ACCESS(halRead, BOARD_SHIFT_QD),
+    ACCESS(halLow, BOARD_SHIFT_CLK),
+    ACCESS(halHigh, BOARD_SHIFT_CLK),
+    ACCESS(halRead, BOARD_SHIFT_QD),
+    ACCESS(halLow, BOARD_SHIFT_CLK),
+    ACCESS(halHigh, BOARD_SHIFT_CLK),
+    ACCESS(halRead, BOARD_SHIFT_QD),
+    ACCESS(halLow, BOARD_SHIFT_S0_1),
+};
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+// Registers of the simulation, see sim/msp430g2553.h
+volatile unsigned char *sim_reg8(unsigned char id){
+    return &registers8[id];
+}
+
+volatile unsigned int *sim_reg16(unsigned char id){
+    return &registers16[id];
+}
+
+/**
+ * Compare the records since the last call with the <count> of <expected>.
+ */
+void check(const HalRecord *expected, unsigned int count, const char *what){
+    unsigned int i;
+
+    sequences++;
+    if(hal_count != count){
+        printf("FAIL %s: %u accesses instead of %u\n", what, hal_count, count);
+        failures++;
+    }
+    for(i = 0; i < count && i < hal_count && i < HAL_TRACE_SIZE; i++){
+        if(hal_records[i].access != expected[i].access || hal_records[i].port != expected[i].port ||
+           hal_records[i].mask != expected[i].mask){
+            printf("FAIL %s: access %u is %u on P%u mask 0x%02X instead of %u on P%u mask 0x%02X\n", what, i,
+                   hal_records[i].access, hal_records[i].port, hal_records[i].mask,
+                   expected[i].access, expected[i].port, expected[i].mask);
+            failures++;
+            break;
+        }
+    }
+    hal_count = 0;
+}
+
+#define CHECK(expected, what)   check((expected), sizeof(expected) / sizeof(HalRecord), (what))
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+int main(void){
+    shift_init();
+    CHECK(init, "shift_init()");
+    if(P2DIR != HAL_MASK(BOARD_SHIFT_OUTPUTS) || (P2SEL | P2SEL2) != 0){
+        printf("FAIL shift_init(): P2DIR 0x%02X, P2SEL 0x%02X\n", P2DIR, P2SEL);
+        failures++;
+    }
+
+    stateLED(0);
+    CHECK(led0, "stateLED(0)");
+    stateLED(1);
+    CHECK(led1, "stateLED(1)");
+    stateLED(2);
+    CHECK(led2, "stateLED(2)");
+    stateLED(3);
+    CHECK(led3, "stateLED(3)");
+    stateLED(4);
+    CHECK(led4, "stateLED(4)");
+    if(P2OUT != HAL_MASK(BOARD_SHIFT_MR)){
+        printf("FAIL stateLED(4): P2OUT 0x%02X\n", P2OUT);
+        failures++;
+    }
+
+    P2IN = HAL_MASK(BOARD_SHIFT_QD);
+    if(stateButton() != 4){
+        printf("FAIL stateButton(): QD high on the first read isn't button 4\n");
+        failures++;
+    }
+    CHECK(buttons, "stateButton()");
+
+    printf("%u pin sequences, %u failures\n", sequences, failures);
+    return failures != 0;
+}
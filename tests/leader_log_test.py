@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""Host test of a full leaderboard log of libs/leader.c and a power cut.
+
+Runs on the PC without a board, after make sim:
+
+    python3 tests/leader_log_test.py [build/synthhero]
+
+Writes a flash image whose log of song 1 on Normal has all its slots
+taken. tests/leader_cut.sim puts a score on the board, which then has to
+be copied to the spare sector before its log is erased, and cuts the power
+in the middle of the erase. tests/leader_copy.sim runs twice on the image:
+the board is read back from its copy, then from its log, which starts
+again at slot 0. Returns 0 if everything passed.
+"""
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+
+SECTOR = 0x10000
+SLOT = 128                  # LEADER_SLOT of leader.h
+SLOTS = SECTOR // SLOT
+LOG = 18 * SECTOR           # LEADER_SECTOR, board 0 is song 1 on Normal
+SPARE = 28 * SECTOR         # LEADER_SPARE, the copies of board 0 first
+CLAIM = 0x4C
+
+failures = 0
+
+
+def check(ok, what):
+    global failures
+    if not ok:
+        print("FAIL " + what)
+        failures += 1
+
+
+def run(game, script, image):
+    code = subprocess.run([game, "-s", os.path.join(ROOT, "tests", script), "-f", image]).returncode
+    check(code == 0, "%s ran (exit code %d)" % (script, code))
+    with open(image, "rb") as f:
+        return f.read()
+
+
+def slot(flash, address):
+    """Claim and count of the slot at <address>."""
+    return flash[address], flash[address + 1]
+
+
+def main():
+    game = sys.argv[1] if len(sys.argv) > 1 else os.path.join(ROOT, "build", "synthhero")
+    directory = tempfile.mkdtemp()
+    image = os.path.join(directory, "leader.bin")
+
+    # every slot taken by an empty board, the CRC-8 of a count of 0 is 0
+    flash = bytearray(b"\xff" * (LOG + SECTOR))
+    for n in range(SLOTS):
+        flash[LOG + n * SLOT:LOG + n * SLOT + 3] = bytes([CLAIM, 0, 0])
+    with open(image, "wb") as f:
+        f.write(flash)
+
+    flash = run(game, "leader_cut.sim", image)
+    check(slot(flash, SPARE) == (CLAIM, 1), "the board with its new score copied first")
+    check(slot(flash, LOG) == (0xFF, 0xFF), "the log erased after the copy")
+
+    flash = run(game, "leader_copy.sim", image)
+    check(slot(flash, LOG) == (CLAIM, 1), "the log started again from the copy")
+    check(slot(flash, LOG + SLOT)[0] == 0xFF, "the rest of the log erased")
+    check(slot(flash, LOG + SLOTS // 2 * SLOT)[0] == 0xFF, "the half the cut left erased too")
+
+    flash = run(game, "leader_copy.sim", image)
+    check(slot(flash, LOG + SLOT)[0] == 0xFF, "a board read from its log isn't written again")
+    shutil.rmtree(directory)
+
+    print("%d failures" % failures)
+    return failures != 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
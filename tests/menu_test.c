@@ -0,0 +1,167 @@
+/***************************************************************************//**
+ * @file    menu_test.c
+ * @date    19.10.26
+ *
+ * @brief   Host test of the menu graph, walks every edge of menu[].
+ *
+ * Runs on the PC, the menu doesn't touch any hardware:
+ *
+ *      gcc -std=gnu99 -Wall -o menu_test tests/menu_test.c libs/menu.c
+ *      ./menu_test
+ *
+ * Checks that every edge leads to a menu point, up and down are mirrored,
+ * left goes back to the point whose right leads into the same column,
+ * every point can be reached from chooseSong and menu_navigate() follows
+ * each edge. Returns 0 if everything passed.
+ ******************************************************************************/
+
+#include "../libs/menu.h"
+#include <stdio.h>
+#include <stddef.h>
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+unsigned int failures = 0;
+unsigned char edit_result = 0;          // what the stub of menu_editName() returns
+unsigned char edit_calls = 0;
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+#define CHECK(cond, point, dir) check((cond), #cond, (point), (dir))
+
+void check(int ok, const char *what, unsigned char point, unsigned char direction){
+    if(!ok){
+        printf("FAIL menu[%u] direction %u: %s\n", point, direction, what);
+        failures++;
+    }
+}
+
+// Actions of the game, only counted here
+void menu_play(unsigned char song){ (void)song; }
+void menu_playFlash(unsigned char unused){ (void)unused; }
+void menu_playEndless(unsigned char unused){ (void)unused; }
+void menu_upload(unsigned char unused){ (void)unused; }
+void menu_record(unsigned char unused){ (void)unused; }
+void menu_setDifficulty(unsigned char difficulty){ (void)difficulty; }
+void menu_resetScores(unsigned char unused){ (void)unused; }
+unsigned char menu_editName(unsigned char direction){
+    (void)direction;
+    edit_calls++;
+    return edit_result;
+}
+unsigned char menu_browseFlash(unsigned char direction){
+    (void)direction;
+    edit_calls++;
+    return edit_result;
+}
+unsigned char menu_browseBoard(unsigned char direction){
+    (void)direction;
+    edit_calls++;
+    return edit_result;
+}
+
+// Returns 1 if <to> is in the column of <from>, following up and down.
+unsigned char sameColumn(unsigned char from, unsigned char to){
+    unsigned char p;
+
+    for(p = from; p != menuNone; p = menu[p].next[menuUp]){
+        if(p == to) return 1;
+    }
+    for(p = from; p != menuNone; p = menu[p].next[menuDown]){
+        if(p == to) return 1;
+    }
+    return 0;
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+int main(void){
+    const unsigned char opposite[4] = {menuDown, menuUp, menuRight, menuLeft};
+    unsigned char reached[menuCount] = {0};
+    unsigned char queue[menuCount];
+    unsigned char head = 0, tail = 0;
+    unsigned int edges = 0;
+    unsigned char p, d, q, point;
+
+    for(p = 0; p < menuCount; p++){
+        const MenuNode *node = &menu[p];
+
+        CHECK(node->text != NULL || node->show == showName || node->show == showFlash, p, 0);
+        CHECK((node->show != showName && node->show != showFlash && node->show != showScore) || node->edit != NULL, p, 0);
+
+        for(d = menuUp; d <= menuRight; d++){
+            q = node->next[d];
+            if(q == menuNone) continue;
+            edges++;
+
+            CHECK(q < menuCount, p, d);
+            if(q >= menuCount) continue;
+            CHECK(q != p, p, d);
+
+            // up and down are mirrored
+            if(d == menuUp || d == menuDown){
+                CHECK(menu[q].next[opposite[d]] == p, p, d);
+            }
+            // right enters a column which has its way back with left
+            if(d == menuRight){
+                CHECK(menu[q].next[menuLeft] == p, p, d);
+                CHECK(menu[q].next[menuUp] == menuNone, p, d);
+            }
+            // left goes back to the point which entered this column
+            if(d == menuLeft){
+                CHECK(menu[q].next[menuRight] != menuNone &&
+                      sameColumn(p, menu[q].next[menuRight]), p, d);
+            }
+
+            // menu_navigate() follows the edge, an edit function which
+            // doesn't use the direction passes it on
+            point = p;
+            edit_result = 0;
+            CHECK(menu_navigate(&point, d) == 1 && point == q, p, d);
+        }
+
+        // nothing happens on a move without an edge
+        for(d = menuUp; d <= menuRight; d++){
+            if(node->next[d] != menuNone) continue;
+            point = p;
+            edit_result = 0;
+            CHECK(menu_navigate(&point, d) == 0 && point == p, p, d);
+        }
+
+        // an edit function which uses the direction keeps the point
+        if(node->edit != NULL){
+            for(d = menuUp; d <= menuRight; d++){
+                point = p;
+                edit_result = 1;
+                edit_calls = 0;
+                CHECK(menu_navigate(&point, d) == 1 && point == p && edit_calls == 1, p, d);
+            }
+        }
+    }
+
+    // every point can be reached from the first one
+    reached[chooseSong] = 1;
+    queue[tail++] = chooseSong;
+    while(head < tail){
+        p = queue[head++];
+        for(d = menuUp; d <= menuRight; d++){
+            q = menu[p].next[d];
+            if(q < menuCount && !reached[q]){
+                reached[q] = 1;
+                queue[tail++] = q;
+            }
+        }
+    }
+    for(p = 0; p < menuCount; p++){
+        CHECK(reached[p], p, 0);
+    }
+
+    printf("%u menu points, %u edges, %u failures\n", menuCount, edges, failures);
+    return failures != 0;
+}
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""Host test of tools/ram_budget.py.
+
+    python3 tests/ram_budget_test.py
+
+Feeds a map of the CCS linker, one of GNU ld and a call graph of gcc to the
+budget and checks the bytes per module and the deepest call chains. The
+model is checked on an object gcc compiles from VARIABLES.
+Returns 0 if everything passed.
+"""
+
+import io
+import os
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+sys.path.insert(0, os.path.join(ROOT, "tools"))
+
+import ram_budget as rb     # noqa: E402
+
+failures = 0
+
+
+def check(ok, what):
+    global failures
+    if not ok:
+        print("FAIL " + what)
+        failures += 1
+
+
+CCS_MAP = """
+SECTION ALLOCATION MAP
+
+ output                                  attributes/
+section   page    origin      length       input sections
+--------  ----  ----------  ----------   ----------------
+.bss       0    00000200    00000046     UNINITIALIZED
+                  00000200    00000040     uart.obj (.bss:uart_tx)
+                  00000240    00000006     main.obj (.bss)
+
+.data      0    00000246    00000004     UNINITIALIZED
+                  00000246    00000004     main.obj (.data)
+
+.TI.noinit
+*          0    0000024a    00000044     UNINITIALIZED
+                  0000024a    00000040     trace.obj (.TI.noinit:trace_ring)
+                  0000028a    00000004     trace.obj (.TI.noinit)
+
+.stack     0    000003b0    00000050     UNINITIALIZED
+                  000003b0    00000002     rts430_eabi.lib : boot.c.obj (.stack)
+                  000003b2    0000004e     --HOLE--
+
+.text      0    0000c000    00000100
+                  0000c000    00000100     main.obj (.text:main)
+"""
+
+GNU_MAP = """
+.data           0x00000200        0x2
+ .data          0x00000200        0x2 build/msp430/libs/tick.o
+.bss            0x00000202       0x88
+ .bss.loader_buffer
+                0x00000202       0x86 build/msp430/libs/loader.o
+ COMMON         0x00000288        0x2 build/msp430/libs/i2c.o
+.text           0x0000c000       0x10
+ .text          0x0000c000       0x10 build/msp430/main.o
+ .rodata.songs  0x0000c010        0x8 build/msp430/libs/songs.o
+"""
+
+# char + int + long of a struct are 8 bytes on the MSP430, 12 on the host
+VARIABLES = r"""
+typedef struct{ char c; int i; long l; }Mixed;
+typedef enum{ a, b }Kind;
+int header;
+Mixed mixed[3];
+static void *pointers[4] = {&header};
+Kind kinds[2];
+const char table[100] = {1};
+void use(void){ static unsigned char once; once++; }
+"""
+
+CI = r"""
+graph: { title: "main.c"
+node: { title: "main" label: "main\nmain.c:1:5\n2 bytes (static)" }
+node: { title: "sched_dispatch" label: "sched_dispatch\nsched.c:1:6\n10 bytes (static)" }
+edge: { sourcename: "main" targetname: "sched_dispatch" label: "main.c:2:5" }
+edge: { sourcename: "sched_dispatch" targetname: "__indirect_call" label: "sched.c:3:5" }
+node: { title: "task_lcd" label: "task_lcd\nmain.c:5:6\n30 bytes (static)" }
+node: { title: "task_input" label: "task_input\nmain.c:6:6\n4 bytes (static)" }
+node: { title: "uart_txIsr" label: "uart_txIsr\nuart.c:7:6\n50 bytes (static)" }
+node: { title: "Timer1_A0" label: "Timer1_A0\ntick.c:8:6\n8 bytes (static)" }
+}
+"""
+
+def budget(map_text, size=512, headroom=0):
+    out = io.StringIO()
+    functions = {}
+    calls = {}
+    rb.parse_ci(CI, functions, calls)
+    left = rb.report(rb.parse_map(map_text, 0x200, size), functions, calls,
+                     {"Timer1_A0"}, {"task_input", "task_lcd", "uart_txIsr"}, size, out,
+                     headroom=headroom)
+    return left, out.getvalue()
+
+
+# CCS: sections by object file, .stack counted whole
+modules = rb.parse_map(CCS_MAP, 0x200, 512)
+check(modules.get("uart") == {"bss": 64}, "CCS uart %r" % modules.get("uart"))
+check(modules.get("main") == {"bss": 6, "data": 4}, "CCS main %r" % modules.get("main"))
+check(modules.get("trace") == {"noinit": 68}, "CCS trace %r" % modules.get("trace"))
+check(modules.get(rb.STACK) == {"stack": 80}, "CCS stack %r" % modules.get(rb.STACK))
+check("main" not in modules or "text" not in modules["main"], "CCS code counted as RAM")
+
+# GNU ld: wrapped names and COMMON
+modules = rb.parse_map(GNU_MAP, 0x200, 512)
+check(modules == {"tick": {"data": 2}, "loader": {"bss": 134}, "i2c": {"bss": 2}}, "GNU %r" % modules)
+
+# GNU ld with the flash: code and the initial values of .data
+modules = rb.parse_map(GNU_MAP, 0x200, 512, 0xC000)
+check(modules.get("main") == {"code": 16} and modules.get("songs") == {"code": 8} and
+      modules.get("tick") == {"data": 2, "code": 2}, "GNU code %r" % modules)
+
+# the model: sizes of the MSP430, const not in RAM, a header variable once
+with tempfile.TemporaryDirectory() as directory:
+    source = os.path.join(directory, "vars.c")
+    with open(source, "w") as f:
+        f.write(VARIABLES)
+    subprocess.run(["gcc", "-g", "-fcommon", "-c", "-o", source + ".o", source], check=True)
+    text = subprocess.run(["readelf", "-W", "--sections", "--syms", "--debug-dump=info", source + ".o"],
+                          check=True, capture_output=True, text=True).stdout
+modules = rb.parse_dwarf(text, "vars", {"header"}, {"kinds"})
+check(modules == {"vars": {"bss": 3 * 8 + 1 + 1, "data": 4 * 2, "noinit": 2 * 2}},
+      "model %r" % modules)
+
+# frames of 4 byte words are halved
+functions = {}
+rb.parse_ci(CI, functions, {}, 4)
+check(functions.get("task_lcd") == 16 and functions.get("main") == 2, "words %r" % functions)
+
+# main > sched_dispatch > a task through the pointer, the ISR callback isn't a task
+left, text = budget(CCS_MAP)
+check("main > sched_dispatch > task_lcd" in text, "deepest chain of main:\n" + text)
+check(" 42 " in text.split("stack worst case")[0].split("stack of main")[1], "depth of main:\n" + text)
+check("stack worst case" in text and text.split("stack worst case")[1].split()[0] == "54",
+      "worst case main + Timer1_A0 + 4:\n" + text)
+check(left == 512 - (64 + 10 + 68) - 80, "free bytes %d" % left)
+check(budget(CCS_MAP, 150)[0] < 0, "too much RAM not found")
+
+# the headroom has to stay free on top of it
+left, text = budget(CCS_MAP, headroom=290)
+check(left == 512 - (64 + 10 + 68) - 80 - 290 and "too little free" not in text, "headroom %d:\n%s" % (left, text))
+left, text = budget(CCS_MAP, headroom=291)
+check(left < 0 and "too little free" in text, "headroom not kept free:\n" + text)
+
+# the address taken functions of the sources
+interrupts, taken = rb.scan_sources(ROOT, {"task_input": 0, "Timer0_A0": 0, "loader_receive": 0})
+check("Timer0_A0" in interrupts, "interrupts of the sources %r" % interrupts)
+check({"task_input", "loader_receive"} <= taken, "address taken %r" % taken)
+
+print("%d failures" % failures)
+sys.exit(1 if failures else 0)
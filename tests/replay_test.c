@@ -0,0 +1,771 @@
+/***************************************************************************//**
+ * @file    replay_test.c
+ * @date    19.10.26
+ *
+ * @brief   Host replay harness and scoring regression test of the songs.
+ *
+ * Runs on the PC, plays button timelines through the game core (game.c)
+ * like the tasks of main.c do, without the hardware:
+ *
+ *      make build/replay_test
+ *      ./build/replay_test                 run the regression test
+ *      ./build/replay_test -u              write the golden files again
+ *      ./build/replay_test replay...       print what the replays show
+ *
+ * A replay (tests/replays/) is a timeline of presses:
+ *
+ *      song 1 normal                       song 1 - 3 or endless, normal or expert
+ *      4750 1                              press of lane 1 at 4750 ms
+ *
+ * The endless mode can be followed by the seed of its chart, "endless
+ * normal 1234", TEST_SEED without one.
+ *
+ * The times count from the start of the song, the tick at which
+ * game_start() ran. Each replay has a golden file of the same name
+ * in tests/golden/ with every frame the display shows and the final score
+ * and judgements. tests/golden/scripted.txt holds the results of the
+ * scripted players below on every song and difficulty.
+ *
+ * The autoplay bot presses every note in the middle of its step and has to
+ * reach the perfect score of songs[] on every song and difficulty. At the
+ * end the harness measures how many songs it plays per second. The same
+ * bot plays song 1 through main.c in the simulation, see tests/autoplay.sim.
+ *
+ * The presses of every scripted player also go through the encoding of the
+ * recordings (replay.h) and have to come back unchanged, the harness prints
+ * the bytes per press and how many events per second are encoded and
+ * decoded. A play of the autoplay bot has to fit into one recording.
+ *
+ * The chart of the endless mode (endless.h) has to come out the same for
+ * the same seed and get denser and faster, the autoplay bot plays it until
+ * its presses run out and the lives end the run. Charts shorter than the
+ * display have to end as well.
+ * Returns 0 if everything passed.
+ ******************************************************************************/
+
+#define _GNU_SOURCE
+
+#include "../libs/game.h"
+#include "../libs/replay.h"
+#include "../libs/recorder.h"
+#include "../libs/endless.h"
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/******************************************************************************
+ * CONSTANTS
+ *****************************************************************************/
+
+#define MAX_PRESSES             2048
+
+#define REPLAYS                 "tests/replays/"
+#define GOLDEN                  "tests/golden/"
+
+#define BENCH_SECONDS           0.25
+#define RAW_PRESS               5           // bytes of a press without the encoding, ms (4) and lane (1)
+#define CODEC_EVENTS            65536       // presses of all scripted players at most
+#define ENDLESS_SLOTS           (ENDLESS_LEVEL_SLOTS * ENDLESS_LEVELS)  // slots of the endless chart compared
+#define SHORT_STEPS             64          // steps until a short chart has to end
+#define LONG_STEPS              0x10010UL   // steps until a chart of up to 0xFFFF slots has to end
+#define TEST_SEED               0x5348      // seed of an endless replay without one, "SH"
+
+/******************************************************************************
+ * VARIABLES
+ *****************************************************************************/
+
+typedef struct{
+    unsigned long ms;                       // time since the start of the song
+    unsigned char lane;                     // 0 - 3
+}Press;
+
+// A scripted player, presses every note <offset> ms after the middle of
+// its step, see script().
+typedef struct{
+    const char *name;
+    int offset;
+    unsigned char mode;
+}Player;
+
+enum PlayerMode{
+    playNotes,                              // every note
+    playNothing,                            // never presses
+    playMash,                               // every lane in turn, ignoring the notes
+    playSloppy,                             // random offsets within the windows and beyond, some notes left out
+};
+
+const Player players[] = {
+    {"autoplay", 0,    playNotes},
+    {"early",    -60,  playNotes},
+    {"late",     100,  playNotes},
+    {"idle",     0,    playNothing},
+    {"mash",     0,    playMash},
+    {"sloppy",   0,    playSloppy},
+};
+
+const char *difficultyText[] = {"normal", "expert"};
+
+unsigned int failures = 0;
+unsigned char update = 0;                   // -u, write the golden files
+unsigned int chart_seed = TEST_SEED;     // of the endless chart, set by load()
+
+Game game;
+
+Press presses[MAX_PRESSES];
+
+/******************************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *****************************************************************************/
+
+void check(int ok, const char *what, const char *song);
+const Song *songOf(unsigned char index);
+void draw(FILE *out, unsigned long ms);
+void play(const Song *song, unsigned char difficulty, const Press *list, unsigned int count, FILE *out);
+void result(FILE *out);
+int comparePresses(const void *a, const void *b);
+int isReplay(const struct dirent *entry);
+unsigned int script(const Player *player, const Song *song, unsigned char difficulty, Press *list);
+int load(const char *path, unsigned char *index, unsigned char *difficulty, Press *list);
+void compare(const char *path, char *text, size_t length);
+void replays(void);
+void scripted(void);
+unsigned int roundTrip(const Press *list, unsigned int count, unsigned char *stream, const char *name);
+void codec(void);
+void endless(void);
+void shortCharts(void);
+void bench(void);
+
+/******************************************************************************
+ * LOCAL FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+void check(int ok, const char *what, const char *song){
+    if(!ok){
+        printf("FAIL %s: %s\n", song, what);
+        failures++;
+    }
+}
+
+/**
+ * Returns the song of <index> of load(), SONG_COUNT is the endless mode.
+ */
+const Song *songOf(unsigned char index){
+    return index < SONG_COUNT ? &songs[index] : &endless_song;
+}
+
+/**
+ * Print the frame of the game at <ms>.
+ */
+void draw(FILE *out, unsigned long ms){
+    char lines[2][GAME_COLUMNS];
+
+    game_frame(&game, lines);
+    fprintf(out, "%6lu |%.*s|\n       |%.*s|\n", ms, GAME_COLUMNS, lines[0], GAME_COLUMNS, lines[1]);
+}
+
+/**
+ * Play <song> with the presses of <list>, sorted by time. Every frame is
+ * printed to <out> unless it is NULL.
+ *
+ * Like the scheduler of main.c the display is drawn once the game was
+ * stepped for everything of a ms.
+ */
+void play(const Song *song, unsigned char difficulty, const Press *list, unsigned int count, FILE *out){
+    GameOutput output;
+    unsigned long now = 0;
+    unsigned long next;
+    unsigned char redraw = 1;               // the start draws the song
+    unsigned char press;
+    unsigned int i = 0;
+
+    if(song == &endless_song){
+        endless_open(&game.chart, chart_seed);
+    }
+    game_start(&game, song, difficulty);
+    do{
+        next = now + game_next(&game);
+        press = 0;
+        if(i < count && list[i].ms <= next){
+            next = list[i].ms;
+            press = list[i].lane + 1;
+            i++;
+        }
+        if(next > now && redraw && out != NULL){
+            draw(out, now);
+        }
+        redraw = next == now && redraw;
+
+        output.commands = 0;
+        game_step(&game, press, next - now, &output);
+        now = next;
+        redraw = redraw || (output.commands & gameDraw);
+    }while(!(output.commands & gameOver));
+    if(out != NULL){
+        draw(out, now);                     // the score
+    }
+}
+
+/**
+ * Print the score and the judgements of the last song.
+ */
+void result(FILE *out){
+    fprintf(out, "score %lu perfect %u great %u good %u miss %u combo %u accuracy %u\n",
+            score_total(), score_count(judgePerfect), score_count(judgeGreat),
+            score_count(judgeGood), score_count(judgeMiss), score_maxCombo(), score_accuracy());
+}
+
+/**
+ * Order of presses for qsort(), by time and then lane.
+ */
+int comparePresses(const void *a, const void *b){
+    const Press *p = a;
+    const Press *q = b;
+
+    if(p->ms != q->ms){
+        return p->ms < q->ms ? -1 : 1;
+    }
+    return p->lane - q->lane;
+}
+
+/**
+ * Write the presses of <player> for <song> into <list>, sorted by time,
+ * at most MAX_PRESSES. Returns their number.
+ */
+unsigned int script(const Player *player, const Song *song, unsigned char difficulty, Press *list){
+    unsigned int period = difficulty ? song->period : song->period * 2;
+    unsigned long seed = 1;                 // the same presses on every run
+    unsigned long start = 0;                // ms the step of the slot starts
+    unsigned int count = 0;
+    unsigned int slot;
+    unsigned char mask;
+    unsigned char lane;
+    long offset = player->offset;
+    long ms;
+    ChartReader r;
+
+    if(song == &endless_song){
+        endless_open(&r, chart_seed);
+    }
+    else{
+        chart_open(&r, song->chart);
+    }
+    switch(player->mode){
+        case playNothing:
+            break;
+        case playMash:
+            for(ms = 0; ms < (long)chart_length(&r) * period && count < MAX_PRESSES; ms += 37){
+                list[count].ms = ms;
+                list[count].lane = count & 3;
+                count++;
+            }
+            break;
+        default:
+            for(slot = 0; slot < chart_length(&r) && count + 4 <= MAX_PRESSES; slot++){
+                if(song->tempo != NULL){
+                    period = difficulty ? song->tempo(slot) : song->tempo(slot) * 2;
+                }
+                mask = chart_next(&r);
+                for(lane = 0; lane < 4; lane++){
+                    if(!(mask & (1 << lane))){
+                        continue;
+                    }
+                    if(player->mode == playSloppy){
+                        seed = seed * 1103515245UL + 12345UL;
+                        if((seed >> 16) % 10 == 0){
+                            continue;           // forgot this one
+                        }
+                        offset = (long)((seed >> 16) % 301) - 150;
+                    }
+                    ms = start + period / 2 + offset;
+                    list[count].ms = ms < 0 ? 0 : ms;
+                    list[count].lane = lane;
+                    count++;
+                }
+                start += period;
+            }
+            break;
+    }
+    qsort(list, count, sizeof(Press), comparePresses);
+    return count;
+}
+
+/**
+ * Returns 1 for the *.txt files of a directory.
+ */
+int isReplay(const struct dirent *entry){
+    size_t length = strlen(entry->d_name);
+
+    return length > 4 && !strcmp(entry->d_name + length - 4, ".txt");
+}
+
+/**
+ * Read the replay at <path> into <list>, an endless one sets chart_seed.
+ * Returns the number of presses, -1 on errors.
+ */
+int load(const char *path, unsigned char *index, unsigned char *difficulty, Press *list){
+    FILE *file = fopen(path, "r");
+    char buffer[128];
+    char level[16];
+    unsigned int song = 0;
+    unsigned long ms;
+    unsigned int lane;
+    unsigned int line = 0;
+    int count = 0;
+    char *text;
+
+    if(file == NULL){
+        perror(path);
+        return -1;
+    }
+    while(fgets(buffer, sizeof(buffer), file) != NULL){
+        line++;
+        buffer[strcspn(buffer, "#\r\n")] = 0;
+        text = buffer + strspn(buffer, " \t");
+        if(*text == 0){
+            continue;
+        }
+        if(song == 0){
+            chart_seed = TEST_SEED;
+            if(sscanf(text, "endless %15s %u", level, &chart_seed) >= 1){
+                song = SONG_COUNT + 1;              // the index after the songs
+            }
+            else if(sscanf(text, "song %u %15s", &song, level) != 2 || song < 1 || song > SONG_COUNT){
+                song = 0;
+            }
+            if(song == 0 || (strcmp(level, "normal") && strcmp(level, "expert"))){
+                song = 0;
+                break;
+            }
+            *index = song - 1;
+            *difficulty = !strcmp(level, "expert");
+            continue;
+        }
+        if(sscanf(text, "%lu %u", &ms, &lane) != 2 || lane < 1 || lane > 4 || count == MAX_PRESSES ||
+           (count > 0 && ms < list[count - 1].ms)){
+            break;
+        }
+        list[count].ms = ms;
+        list[count].lane = lane - 1;
+        count++;
+        line = 0;
+    }
+    fclose(file);
+    if(song == 0 || line != 0){
+        printf("%s: expected \"song <1 - %u>|endless normal|expert\" and then \"<ms> <lane>\" in order\n",
+               path, SONG_COUNT);
+        return -1;
+    }
+    return count;
+}
+
+/**
+ * Compare <text> with the golden file <path>, or write it with -u.
+ */
+void compare(const char *path, char *text, size_t length){
+    FILE *file = fopen(path, update ? "w" : "r");
+    char *golden = NULL;
+    size_t size = 0;
+    size_t read = 0;
+    unsigned int line = 1;
+    size_t i;
+
+    if(file == NULL){
+        perror(path);
+        failures++;
+        return;
+    }
+    if(update){
+        fwrite(text, 1, length, file);
+        fclose(file);
+        return;
+    }
+    golden = malloc(length + 1);
+    if(golden != NULL){
+        read = fread(golden, 1, length + 1, file);
+        size = read;
+    }
+    fclose(file);
+    for(i = 0; i < length && i < size && text[i] == golden[i]; i++){
+        line += text[i] == '\n';
+    }
+    if(size != length || i != length){
+        printf("FAIL %s differs from line %u on, run with -u if that is intended\n", path, line);
+        failures++;
+    }
+    free(golden);
+}
+
+/**
+ * Play every replay of tests/replays/ and compare it with its golden file.
+ */
+void replays(void){
+    struct dirent **names;
+    char path[512];
+    char *text;
+    size_t length;
+    FILE *out;
+    unsigned char index = 0;
+    unsigned char difficulty = 0;
+    int files;
+    int count;
+    int n;
+
+    files = scandir(REPLAYS, &names, isReplay, alphasort);
+    if(files <= 0){
+        printf("FAIL no replays in " REPLAYS "\n");
+        failures++;
+        return;
+    }
+    for(n = 0; n < files; n++){
+        snprintf(path, sizeof(path), REPLAYS "%s", names[n]->d_name);
+        count = load(path, &index, &difficulty, presses);
+        if(count < 0){
+            failures++;
+            free(names[n]);
+            continue;
+        }
+        out = open_memstream(&text, &length);
+        if(index < SONG_COUNT){
+            fprintf(out, "# song %u %s, %d presses\n", index + 1, difficultyText[difficulty], count);
+        }
+        else{
+            fprintf(out, "# endless %s, %d presses\n", difficultyText[difficulty], count);
+        }
+        play(songOf(index), difficulty, presses, count, out);
+        result(out);
+        fclose(out);
+        snprintf(path, sizeof(path), GOLDEN "%s", names[n]->d_name);
+        compare(path, text, length);
+        free(text);
+        free(names[n]);
+    }
+    free(names);
+}
+
+/**
+ * Play every scripted player on every song and difficulty, the autoplay
+ * bot has to reach the perfect score.
+ */
+void scripted(void){
+    char name[32];
+    char *text;
+    size_t length;
+    FILE *out = open_memstream(&text, &length);
+    unsigned char p, s, d;
+    unsigned int count;
+    const Song *song;
+
+    for(p = 0; p < sizeof(players) / sizeof(players[0]); p++){
+        for(s = 0; s < SONG_COUNT; s++){
+            for(d = 0; d < 2; d++){
+                song = &songs[s];
+                count = script(&players[p], song, d, presses);
+                play(song, d, presses, count, NULL);
+                fprintf(out, "%-8s song %u %-6s ", players[p].name, s + 1, difficultyText[d]);
+                result(out);
+                if(players[p].mode == playNotes && players[p].offset == 0){
+                    snprintf(name, sizeof(name), "song %u %s", s + 1, difficultyText[d]);
+                    check(score_total() == song->perfect[d], "autoplay misses the perfect score", name);
+                    check(score_count(judgePerfect) == song->notes, "autoplay didn't hit every note", name);
+                    check(score_maxCombo() == song->notes, "autoplay lost the combo", name);
+                }
+            }
+        }
+    }
+    fclose(out);
+    compare(GOLDEN "scripted.txt", text, length);
+    free(text);
+}
+
+/**
+ * Encode the presses of <list> into <stream> and decode them again, they
+ * have to come back unchanged. Returns the bytes of the stream.
+ */
+unsigned int roundTrip(const Press *list, unsigned int count, unsigned char *stream, const char *name){
+    ReplayDecoder decoder;
+    unsigned long ms = 0;
+    unsigned int length = 0;
+    unsigned int n = 0;
+    unsigned int i;
+    unsigned char ok = 1;
+
+    for(i = 0; i < count; i++){
+        length += replay_encode(&stream[length], list[i].ms - ms, 1 << list[i].lane);
+        ms = list[i].ms;
+    }
+    ms = 0;
+    replay_start(&decoder);
+    for(i = 0; i < length; i++){
+        if(replay_decode(&decoder, stream[i])){
+            ms += REPLAY_DELTA(&decoder);
+            ok = ok && n < count && ms == list[n].ms && REPLAY_MASK(&decoder) == 1 << list[n].lane;
+            n++;
+        }
+    }
+    check(ok && n == count, "the encoding changed the presses", name);
+    return length;
+}
+
+/**
+ * Put the presses of every scripted player through the encoding of the
+ * recordings and measure how fast it is.
+ */
+void codec(void){
+    static unsigned long deltas[CODEC_EVENTS];
+    static unsigned char masks[CODEC_EVENTS];
+    static unsigned char stream[CODEC_EVENTS * REPLAY_EVENT_MAX];
+    unsigned char event[REPLAY_EVENT_MAX];
+    char name[32];
+    ReplayDecoder decoder;
+    unsigned long events = 0;
+    unsigned long bytes = 0;
+    unsigned long coded = 0;
+    unsigned long length = 0;
+    unsigned int longest = 0;
+    unsigned int count;
+    unsigned int size;
+    unsigned int i;
+    unsigned char p, s, d;
+    clock_t start;
+    double encode, decode;
+
+    // the limits of a single event
+    check(replay_encode(event, 0, 15) == 1 && event[0] == 15, "0 ms isn't 1 byte", "codec");
+    check(replay_encode(event, REPLAY_DELTA_MAX, 1) == REPLAY_EVENT_MAX, "the longest delta isn't 4 bytes", "codec");
+    check(replay_encode(event, REPLAY_DELTA_MAX + 1000, 1) == REPLAY_EVENT_MAX, "a longer delta isn't cut", "codec");
+    replay_start(&decoder);
+    for(i = 0; i < REPLAY_EVENT_MAX - 1; i++){
+        replay_decode(&decoder, event[i]);
+    }
+    check(replay_decode(&decoder, event[i]) && REPLAY_DELTA(&decoder) == REPLAY_DELTA_MAX && REPLAY_MASK(&decoder) == 1,
+          "the longest delta doesn't decode", "codec");
+    for(i = 0; i < 37; i++){
+        replay_decode(&decoder, 0x80);      // a broken stream, the 8 bit shift would wrap to 3
+    }
+    check(replay_decode(&decoder, 0x7F) && REPLAY_DELTA(&decoder) == 0 && REPLAY_MASK(&decoder) == 0,
+          "the bits of a broken event wrap into it", "codec");
+
+    for(p = 0; p < sizeof(players) / sizeof(players[0]); p++){
+        for(s = 0; s < SONG_COUNT; s++){
+            for(d = 0; d < 2; d++){
+                snprintf(name, sizeof(name), "%s song %u %s", players[p].name, s + 1, difficultyText[d]);
+                count = script(&players[p], &songs[s], d, presses);
+                size = roundTrip(presses, count, stream, name);
+                if(players[p].mode == playNotes && size > longest){
+                    longest = size;
+                }
+                for(i = 0; i < count && events < CODEC_EVENTS; i++){
+                    deltas[events] = presses[i].ms - (i > 0 ? presses[i - 1].ms : 0);
+                    masks[events] = 1 << presses[i].lane;
+                    events++;
+                }
+                bytes += size;
+            }
+        }
+    }
+    check(longest <= RECORDER_EVENTS, "a play of the autoplay bot doesn't fit into a recording", "codec");
+    printf("%.2f bytes per press instead of %u, the longest play takes %u of %u bytes\n",
+           (double)bytes / events, RAW_PRESS, longest, RECORDER_EVENTS);
+
+    start = clock();
+    do{
+        for(i = 0, length = 0; i < events; i++){
+            length += replay_encode(&stream[length], deltas[i], masks[i]);
+        }
+        coded += events;
+        encode = (double)(clock() - start) / CLOCKS_PER_SEC;
+    }while(encode < BENCH_SECONDS);
+    coded = coded / encode;
+
+    start = clock();
+    events = 0;
+    do{
+        replay_start(&decoder);
+        for(i = 0; i < length; i++){
+            events += replay_decode(&decoder, stream[i]);
+        }
+        decode = (double)(clock() - start) / CLOCKS_PER_SEC;
+    }while(decode < BENCH_SECONDS);
+    printf("%lu events encoded and %.0f decoded per second\n", coded, events / decode);
+}
+
+/**
+ * Check the chart of the endless mode: the same seed has to give the same
+ * slots and another seed other ones, the last level has to have more notes
+ * and a shorter period than the first. Then the autoplay bot plays it on
+ * both difficulties, it has to hit every note until its presses run out.
+ */
+void endless(void){
+    static unsigned char slots[ENDLESS_SLOTS];
+    unsigned int notes[2] = {0, 0};         // of the first and the last level
+    unsigned int same = 0;
+    unsigned int other = 0;
+    unsigned int count;
+    unsigned int i;
+    unsigned char d;
+    char name[32];
+    ChartReader r;
+
+    endless_open(&r, TEST_SEED);
+    for(i = 0; i < ENDLESS_SLOTS; i++){
+        slots[i] = chart_next(&r);
+    }
+    endless_open(&r, TEST_SEED);
+    for(i = 0; i < ENDLESS_SLOTS; i++){
+        same += chart_next(&r) == slots[i];
+    }
+    endless_open(&r, TEST_SEED + 1);
+    for(i = 0; i < ENDLESS_SLOTS; i++){
+        other += chart_next(&r) == slots[i];
+    }
+    for(i = 0; i < ENDLESS_LEVEL_SLOTS; i++){
+        notes[0] += slots[i] != 0;
+        notes[1] += slots[ENDLESS_SLOTS - ENDLESS_LEVEL_SLOTS + i] != 0;
+    }
+    check(same == ENDLESS_SLOTS, "the same seed gave another chart", "endless");
+    check(other < ENDLESS_SLOTS, "another seed gave the same chart", "endless");
+    check(notes[1] > notes[0], "the notes don't get denser", "endless");
+    check(endless_tempo(ENDLESS_SLOTS) < endless_tempo(0), "the tempo doesn't get faster", "endless");
+    printf("endless: %u of %u slots with notes in the first level, %u in the last, %u to %u ms per slot\n",
+           notes[0], ENDLESS_LEVEL_SLOTS, notes[1], endless_tempo(0), endless_tempo(ENDLESS_SLOTS));
+
+    chart_seed = TEST_SEED;              // a replay may have set another one
+    for(d = 0; d < 2; d++){
+        snprintf(name, sizeof(name), "endless %s", difficultyText[d]);
+        count = script(&players[0], &endless_song, d, presses);
+        play(&endless_song, d, presses, count, NULL);
+        check(score_count(judgePerfect) == count, "autoplay didn't hit every note", name);
+        check(game.lives == 0, "the run didn't end with the lives", name);
+        printf("%s: autoplay hit %u notes, the run ended at slot %u with %u ms per slot\n",
+               name, count, game.slot, game.period);
+    }
+}
+
+/**
+ * Play charts of a few slots up to CHART_MIN_SLOTS without a press. All
+ * of their slots are on the display from the start, so the game has to end
+ * with the first slot.
+ */
+void shortCharts(void){
+    static const unsigned char lengths[] = {0, 1, 4, 15, CHART_MIN_SLOTS};
+    unsigned char chart[] = {CHART_LENGTH(0), CHART_NOTE(0, 1), CHART_END};
+    Song song = songs[0];
+    GameOutput output;
+    unsigned int steps;
+    unsigned char n;
+    char name[32];
+
+    song.chart = chart;
+    song.size = sizeof(chart);
+    song.notes = 1;
+    for(n = 0; n < sizeof(lengths); n++){
+        chart[0] = lengths[n];
+        snprintf(name, sizeof(name), "chart of %u slots", lengths[n]);
+        game_start(&game, &song, 1);
+        output.commands = 0;
+        for(steps = 0; steps < SHORT_STEPS && !(output.commands & gameOver); steps++){
+            game_step(&game, 0, game_next(&game), &output);
+        }
+        check(output.commands & gameOver, "the song never ended", name);
+        check(game.slot == 1, "the song didn't end after the first slot", name);
+    }
+    printf("short charts: every one up to %u slots ended\n", CHART_MIN_SLOTS);
+}
+
+/**
+ * Play charts of nearly 0xFFFF slots without a press, where slot + 16 no
+ * longer fits an unsigned int of the MSP430. The game has to end once the
+ * last slot is on the display, 15 slots before the end.
+ */
+void longCharts(void){
+    static const unsigned int lengths[] = {0xFFEF, 0xFFF0, 0xFFFE, 0xFFFF};
+    unsigned char chart[] = {CHART_LENGTH(0), CHART_NOTE(0, 1), CHART_END};
+    Song song = songs[0];
+    GameOutput output;
+    unsigned long steps;
+    unsigned char n;
+    char name[32];
+
+    song.chart = chart;
+    song.size = sizeof(chart);
+    song.notes = 1;
+    for(n = 0; n < sizeof(lengths) / sizeof(lengths[0]); n++){
+        chart[0] = lengths[n] & 0xFF;
+        chart[1] = lengths[n] >> 8;
+        snprintf(name, sizeof(name), "chart of %u slots", lengths[n]);
+        game_start(&game, &song, 1);
+        output.commands = 0;
+        for(steps = 0; steps < LONG_STEPS && !(output.commands & gameOver); steps++){
+            game_step(&game, 0, game_next(&game), &output);
+        }
+        check(output.commands & gameOver, "the song never ended", name);
+        check(game.slot == (unsigned int)(lengths[n] - 15), "the song didn't end with its last slot on the display", name);
+    }
+    printf("long charts: every one up to 0xFFFF slots ended\n");
+}
+
+/**
+ * Measure how many songs the autoplay bot plays per second of CPU time.
+ */
+void bench(void){
+    static Press lists[SONG_COUNT * 2][MAX_PRESSES];
+    unsigned int counts[SONG_COUNT * 2];
+    unsigned long plays = 0;
+    clock_t start;
+    double seconds;
+    unsigned char n;
+
+    for(n = 0; n < SONG_COUNT * 2; n++){
+        counts[n] = script(&players[0], &songs[n / 2], n & 1, lists[n]);
+    }
+    start = clock();
+    do{
+        for(n = 0; n < SONG_COUNT * 2; n++){
+            play(&songs[n / 2], n & 1, lists[n], counts[n], NULL);
+            plays++;
+        }
+        seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    }while(seconds < BENCH_SECONDS);
+    printf("%.0f plays per second\n", plays / seconds);
+}
+
+/******************************************************************************
+ * FUNCTION IMPLEMENTATION
+ *****************************************************************************/
+
+int main(int argc, char **argv){
+    unsigned char index = 0;
+    unsigned char difficulty = 0;
+    unsigned char shown = 0;
+    int count;
+    int i;
+
+    for(i = 1; i < argc; i++){
+        if(!strcmp(argv[i], "-u")){
+            update = 1;
+            continue;
+        }
+        count = load(argv[i], &index, &difficulty, presses);
+        if(count < 0){
+            return 1;
+        }
+        play(songOf(index), difficulty, presses, count, stdout);
+        result(stdout);
+        shown = 1;
+    }
+    if(shown){
+        return 0;
+    }
+
+    replays();
+    scripted();
+    endless();
+    shortCharts();
+    longCharts();
+    codec();
+    bench();
+    printf("%u failures\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,286 @@
+#!/usr/bin/env python3
+"""Upload a chart over the UART into the song library of the SPI flash.
+
+Usage:
+    chart_upload.py PORT CHART --slot N [--baud 115200]
+    chart_upload.py --pack CHART          (only print the packed chart)
+
+Put the game into "Upload Song" first. The protocol is described in
+libs/loader.h, the packed chart format in libs/chart.h.
+
+A chart file is text:
+
+    # comment
+    name: My Song
+    period: 150                 ms per slot on Expert
+    tones: 262 294 330 349      playNotes() values of lane 1 - 4
+    notes:
+    ........1...4...2...3...
+    [14]....
+
+After "notes:" every char is one slot: '1' - '4' is a note on that lane
+(the same digits the game shows), '.' is no note and [..] holds the lanes
+of a chord. Whitespace is ignored.
+"""
+
+import argparse
+import os
+import select
+import struct
+import sys
+import termios
+import time
+
+SYNC = 0xA5
+LOADER_BEGIN = 0x10
+LOADER_DATA = 0x11
+LOADER_END = 0x12
+LOADER_ACK = 0x20
+
+STATUS_OK = 0
+STATUS_CRC = 1
+STATUS_ORDER = 2
+STATUS_INVALID = 3
+
+CHUNK = 32                      # LOADER_CHUNK
+SLOTS = 16                      # LIBRARY_SLOTS
+NAME = 12                       # LIBRARY_NAME
+MAX_SIZE = 0xFF00               # LIBRARY_MAX_SIZE
+MIN_SLOTS = 16                  # CHART_MIN_SLOTS
+
+CHART_SKIP = 0xFC
+CHART_END = 0xFF
+CHART_MAX_GAP = 62
+
+ERASE_TIMEOUT = 5.0             # a sector erase takes up to 3 s
+FRAME_TIMEOUT = 0.5
+RETRIES = 8
+
+
+class UploadError(Exception):
+    pass
+
+
+def crc8(data, crc=0):
+    """CRC-8 with polynomial 0x07, like uart_crc8()."""
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def frame(frame_type, payload=b""):
+    body = bytes([frame_type, len(payload)]) + bytes(payload)
+    return bytes([SYNC]) + body + bytes([crc8(body)])
+
+
+class FrameReader:
+    """Collects frames from a byte stream, damaged ones are skipped."""
+
+    def __init__(self):
+        self.buffer = bytearray()
+
+    def feed(self, data):
+        self.buffer += data
+        frames = []
+        while True:
+            start = self.buffer.find(bytes([SYNC]))
+            if start < 0:
+                self.buffer.clear()
+                return frames
+            del self.buffer[:start]
+            if len(self.buffer) < 3 or len(self.buffer) < 4 + self.buffer[2]:
+                return frames
+            length = self.buffer[2]
+            body = bytes(self.buffer[1:3 + length])
+            if crc8(body) == self.buffer[3 + length]:
+                frames.append((body[0], body[2:]))
+                del self.buffer[:4 + length]
+            else:
+                del self.buffer[:1]         # not a frame start, look for the next sync
+
+
+def parse_chart(text):
+    """Returns (name, period, tones, slots), slots is a list of lane sets."""
+    name, period, tones, slots = "", 0, None, []
+    in_notes = False
+    for line in text.splitlines():
+        line = line.split("#", 1)[0]
+        if not in_notes:
+            if not line.strip():
+                continue
+            key, _, value = line.partition(":")
+            key = key.strip().lower()
+            if key == "name":
+                name = value.strip()
+            elif key == "period":
+                period = int(value)
+            elif key == "tones":
+                tones = [int(t) for t in value.split()]
+            elif key == "notes":
+                in_notes = True
+            else:
+                raise ValueError("unknown line: " + line)
+            continue
+        chord = None
+        for char in line:
+            if char.isspace():
+                continue
+            if char == "[":
+                chord = set()
+            elif char == "]":
+                slots.append(chord)
+                chord = None
+            elif char in "1234":
+                if chord is None:
+                    slots.append({int(char)})
+                else:
+                    chord.add(int(char))
+            elif char == "." and chord is None:
+                slots.append(set())
+            else:
+                raise ValueError("bad note char: " + char)
+    if not period or tones is None or len(tones) != 4:
+        raise ValueError("period and four tones are needed")
+    return name, period, tones, slots
+
+
+def pack_chart(slots):
+    """Packs lane sets into the format of chart.h, returns (bytes, notes)."""
+    out = bytearray(struct.pack("<H", len(slots)))
+    last = 0
+    notes = 0
+    for slot, lanes in enumerate(slots):
+        for lane in sorted(lanes):
+            gap = slot - last
+            while gap > CHART_MAX_GAP:
+                out.append(CHART_SKIP)
+                gap -= 63
+            out.append(gap << 2 | (lane - 1))
+            last = slot
+            notes += 1
+    out.append(CHART_END)
+    return bytes(out), notes
+
+
+def begin_payload(slot, chart, notes, period, tones, name):
+    encoded = name.encode("ascii", "replace")[:NAME].ljust(NAME, b"\0")
+    return struct.pack("<BHHH4H", slot, len(chart), notes, period, *tones) + encoded
+
+
+def open_port(path, baud):
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+    attrs = termios.tcgetattr(fd)
+    attrs[0] = 0                                    # iflag: raw
+    attrs[1] = 0                                    # oflag
+    attrs[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+    attrs[3] = 0                                    # lflag: no echo, not canonical
+    speed = getattr(termios, "B%d" % baud)
+    attrs[4] = attrs[5] = speed
+    attrs[6][termios.VMIN] = 0
+    attrs[6][termios.VTIME] = 0
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    termios.tcflush(fd, termios.TCIOFLUSH)
+    return fd
+
+
+class Uploader:
+    def __init__(self, fd, log=None):
+        self.fd = fd
+        self.reader = FrameReader()
+        self.log = log or (lambda message: None)
+        self.resent = 0
+
+    def ack(self, timeout):
+        """Waits for a loaderAck, returns (status, next offset) or None."""
+        end = time.monotonic() + timeout
+        while True:
+            left = end - time.monotonic()
+            if left <= 0:
+                return None
+            ready, _, _ = select.select([self.fd], [], [], left)
+            if not ready:
+                return None
+            for frame_type, payload in self.reader.feed(os.read(self.fd, 256)):
+                if frame_type == LOADER_ACK and len(payload) == 3:
+                    return payload[0], payload[1] | payload[2] << 8
+                # telemetry of the game, not for us
+
+    def exchange(self, data, timeout):
+        """Sends a frame until it is answered, returns (status, next offset)."""
+        for attempt in range(RETRIES):
+            if attempt:
+                self.resent += 1
+            os.write(self.fd, data)
+            answer = self.ack(timeout)
+            if answer is not None and answer[0] != STATUS_CRC:
+                return answer
+        raise UploadError("no answer from the MSP")
+
+    def upload(self, slot, chart, notes, period, tones, name):
+        if not 0 <= slot < SLOTS:
+            raise UploadError("slot must be 0 - %d" % (SLOTS - 1))
+        if not 3 <= len(chart) <= MAX_SIZE:
+            raise UploadError("chart has %d bytes" % len(chart))
+        if struct.unpack_from("<H", chart)[0] < MIN_SLOTS:
+            raise UploadError("chart has fewer than %d slots" % MIN_SLOTS)
+
+        status, offset = self.exchange(frame(LOADER_BEGIN,
+                                             begin_payload(slot, chart, notes, period, tones, name)),
+                                       ERASE_TIMEOUT)
+        if status != STATUS_OK:
+            raise UploadError("upload refused (status %d)" % status)
+
+        while offset < len(chart):
+            data = chart[offset:offset + CHUNK]
+            status, next_offset = self.exchange(frame(LOADER_DATA, struct.pack("<H", offset) + data),
+                                                FRAME_TIMEOUT)
+            if status == STATUS_INVALID:
+                raise UploadError("upload stopped by the MSP")
+            if status == STATUS_ORDER and next_offset % CHUNK and next_offset != len(chart):
+                raise UploadError("MSP expects offset %d" % next_offset)
+            offset = next_offset
+            self.log("%d / %d bytes" % (offset, len(chart)))
+
+        for _ in range(RETRIES):
+            status, offset = self.exchange(frame(LOADER_END), FRAME_TIMEOUT)
+            if status == STATUS_OK:
+                return
+        raise UploadError("song not finished (status %d)" % status)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("port", nargs="?", help="serial port of the LaunchPad")
+    parser.add_argument("chart", help="chart text file")
+    parser.add_argument("--slot", type=int, default=0, help="library slot 0 - %d" % (SLOTS - 1))
+    parser.add_argument("--baud", type=int, default=115200, help="UART_BAUD of the game")
+    parser.add_argument("--pack", action="store_true", help="only print the packed chart")
+    args = parser.parse_args()
+
+    with open(args.chart) as f:
+        name, period, tones, slots = parse_chart(f.read())
+    chart, notes = pack_chart(slots)
+    if args.pack:
+        print("%d slots, %d notes, %d bytes" % (len(slots), notes, len(chart)))
+        print(" ".join("%02X" % b for b in chart))
+        return 0
+    if args.port is None:
+        parser.error("the port is needed for an upload")
+
+    fd = open_port(args.port, args.baud)
+    try:
+        uploader = Uploader(fd, log=lambda message: print("\r" + message, end="", flush=True))
+        uploader.upload(args.slot, chart, notes, period, tones, name or os.path.basename(args.chart))
+    except UploadError as error:
+        print("\nfailed: %s" % error, file=sys.stderr)
+        return 1
+    finally:
+        os.close(fd)
+    print("\nuploaded %s to slot %d (%d frames resent)" % (args.chart, args.slot, uploader.resent))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
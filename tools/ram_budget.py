@@ -0,0 +1,408 @@
+#!/usr/bin/env python3
+"""RAM budget of the firmware per module, with the worst case of the stack.
+
+Usage:
+    ram_budget.py MAP [CI ...] [--ram 0x0200:512] [--rom 0xC000:16384] [--headroom 16] [--src DIR]
+    ram_budget.py MAP [CI ...] --objects OBJ ... --word 4 [...]
+
+MAP is the linker map of the build, either the one of CCS (--map_file) or
+the one of GNU ld (-Wl,-Map). Every input section in RAM is counted for the
+module of its object file, the .stack section for the stack. With --rom the
+sections from the start of the flash on and the initial values of .data are
+counted as code.
+
+The CI files are the call graphs with stack usage which gcc writes with
+-fcallgraph-info=su, e.g. msp430-elf-gcc -Os -fcallgraph-info=su. From them
+the deepest call chain of main() and of every interrupt is searched. An
+interrupt can come on top of the deepest point of main() and pushes PC and
+SR, interrupts don't nest. Indirect calls go to the functions of
+INDIRECT_CALLS whose address is taken in the sources under --src, the
+callers missing there to all of them.
+
+Without a toolchain of the MSP430 the budget can be taken from a model build
+of the host (make model). --objects then takes the variables from the debug
+information of its objects (readelf), laid out like on the MSP430: int,
+enums and pointers 2 bytes, long 4, nothing aligned to more than 2. The
+frames of the call graphs are in words of --word bytes and are scaled to
+the 2 bytes of the MSP430. The code of the model build is only printed.
+
+--headroom is the RAM which has to stay free on top of the worst case, for
+the frames the call graphs don't see (the C start-up, a change which adds a
+byte somewhere) so that a build doesn't fail only on the board.
+
+Returns 1 if the variables and the worst case of the stack don't fit with
+the headroom, or the code of a real build with --rom.
+"""
+
+import argparse
+import fnmatch
+import glob
+import io
+import os
+import re
+import subprocess
+import sys
+
+INTERRUPT_FRAME = 4             # PC and SR pushed by an interrupt
+INDIRECT = "__indirect_call"    # callee of gcc for calls through pointers
+KINDS = ("data", "bss", "noinit", "sysmem", "stack")
+UNLOADED = ("comment", "note", "ARM", "stab", "stabstr")    # and debug*, never in the flash
+STACK = "(stack section)"
+CODE = "code"                   # kind of the sections in flash
+
+# Sizes of the base types of the MSP430 ABI
+MSP430_TYPES = {
+    "char": 1, "signed char": 1, "unsigned char": 1, "_Bool": 1,
+    "short int": 2, "short unsigned int": 2, "int": 2, "unsigned int": 2,
+    "long int": 4, "long unsigned int": 4, "float": 4,
+    "long long int": 8, "long long unsigned int": 8, "double": 8, "long double": 8,
+}
+
+# Functions called through pointers, by caller
+INDIRECT_CALLS = {
+    "sched_dispatch":   ["task_*"],                     # Task.run, the tasks of main.c
+    "uart_rxIsr":       ["*_receive"],                  # UartReceiver
+    "processPressMenu": ["menu_*"],                     # MenuAction
+    "menu_navigate":    ["menu_*"],                     # MenuEdit
+    "chart_fetch":      ["library_next", "endless_next"],   # ChartSource
+    "chart_openSource": ["library_next", "endless_next"],
+    "game_advance":     ["endless_tempo"],              # SongTempo
+}
+
+
+class BudgetError(Exception):
+    pass
+
+
+def parse_map(text, start, size, rom=None):
+    """Returns {module: {section: bytes}} of the input sections in RAM, with
+    <rom> the start of the flash also the code."""
+    end = start + size
+    modules = {}
+    ccs = "SECTION ALLOCATION MAP" in text     # has the initial values in .cinit
+
+    def add(section, address, length, source):
+        if section == "COMMON":
+            section = ".bss"
+        parts = section.split(":")[0].split(".")
+        kind = parts[2] if parts[1:2] == ["TI"] else parts[1]      # .TI.noinit of CCS
+        if kind.startswith("debug") or kind in UNLOADED:
+            return                              # offsets in the file, not addresses
+        if rom is not None and address >= rom and length:
+            kind = CODE
+        elif kind not in KINDS or not start <= address < end or length == 0:
+            return
+        match = re.search(r"([\w\-]+)\.(?:c\.)?o(?:bj)?\b", source)
+        module = match.group(1) if match else source.strip()
+        if kind == "stack":
+            module = STACK
+        modules.setdefault(module, {}).setdefault(kind, 0)
+        modules[module][kind] += length
+        if kind == "data" and rom is not None and not ccs:
+            modules[module].setdefault(CODE, 0)
+            modules[module][CODE] += length     # the initial values, loaded from the flash
+
+    if ccs:
+        # CCS: output section lines, then "address length file (section)"
+        section = None
+        name = None
+        for line in text.splitlines():
+            if re.match(r"^\.\S+\s*$", line):
+                name = line.strip()                 # long name, the rest is on the next line
+                continue
+            out = re.match(r"^(\.\S+|\*)\s+\d+\s+([0-9a-fA-F]{8})\s+([0-9a-fA-F]{8})", line)
+            if out:
+                section = name if out.group(1) == "*" else out.group(1)
+                if section == ".stack":             # the inputs don't cover all of it
+                    add(section, int(out.group(2), 16), int(out.group(3), 16), "")
+                    section = None
+                continue
+            inp = re.match(r"^\s+([0-9a-fA-F]{8})\s+([0-9a-fA-F]{8})\s+(.+?)\s+\((\S+)\)\s*$", line)
+            if inp and section is not None:
+                add(inp.group(4), int(inp.group(1), 16), int(inp.group(2), 16), inp.group(3))
+            elif line and not line[0].isspace():
+                section = None
+        return modules
+
+    # GNU ld: " .section 0xaddress 0xsize file", long names wrap
+    pending = None
+    for line in text.splitlines():
+        if pending is not None:
+            inp = re.match(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S+)", line)
+            if inp:
+                add(pending, int(inp.group(1), 16), int(inp.group(2), 16), inp.group(3))
+            pending = None
+            continue
+        inp = re.match(r"^ (\.\S+|COMMON)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S+)", line)
+        if inp:
+            add(inp.group(1), int(inp.group(2), 16), int(inp.group(3), 16), inp.group(4))
+        elif re.match(r"^ \.\S+\s*$", line):
+            pending = line.strip()
+    return modules
+
+
+def parse_dwarf(text, module, externals, noinit):
+    """Returns {module: {section: bytes}} of the variables in the output of
+    readelf -W --sections --syms --debug-dump=info of one object, in the
+    sizes of the MSP430. A variable of a header (-fcommon) is only counted
+    for the first object in <externals>."""
+    sections = {}
+    symbols = {}
+    dies = {}
+    variables = []
+    parents = []
+    die = None
+    for line in text.splitlines():
+        header = re.match(r"^\s+\[\s*(\d+)\]\s+(\S+)", line)
+        if header and die is None:
+            sections[header.group(1)] = header.group(2)
+            continue
+        symbol = re.match(r"^\s+\d+:\s+[0-9a-f]+\s+\d+\s+OBJECT\s+\w+\s+\w+\s+(\w+)\s+([\w.]+)$", line)
+        if symbol:
+            index, name = symbol.groups()
+            symbols[name.split(".")[0]] = ".bss" if index == "COM" else sections.get(index, "")
+            continue
+        tag = re.match(r"^\s*<(\d+)><([0-9a-f]+)>: Abbrev Number: \d+ \((\w+)\)", line)
+        if tag:
+            depth = int(tag.group(1))
+            die = {"tag": tag.group(3), "children": []}
+            del parents[depth:]
+            if parents:
+                parents[-1]["children"].append(die)
+            parents.append(die)
+            dies[int(tag.group(2), 16)] = die
+            if die["tag"] == "DW_TAG_variable":
+                variables.append(die)
+            continue
+        attribute = re.match(r"^\s*<[0-9a-f]+>\s+(DW_AT_\w+)\s*:\s*(.*)$", line)
+        if attribute and die is not None:
+            die[attribute.group(1)] = re.sub(r"^(?:\([^)]*\):?\s*)+", "", attribute.group(2).strip())
+
+    def ref(die, attribute="DW_AT_type"):
+        match = re.search(r"<0x([0-9a-f]+)>", die.get(attribute, ""))
+        return dies[int(match.group(1), 16)] if match else None
+
+    def layout(die):
+        """Returns (size, alignment) of a type on the MSP430."""
+        tag = die["tag"]
+        if tag == "DW_TAG_base_type":
+            size = MSP430_TYPES[die["DW_AT_name"]]
+            return size, min(size, 2)
+        if tag in ("DW_TAG_pointer_type", "DW_TAG_enumeration_type"):
+            return 2, 2
+        if tag in ("DW_TAG_typedef", "DW_TAG_const_type", "DW_TAG_volatile_type"):
+            return layout(ref(die))
+        if tag == "DW_TAG_array_type":
+            size, align = layout(ref(die))
+            for dimension in die["children"]:
+                if "DW_AT_upper_bound" in dimension:
+                    size *= int(dimension["DW_AT_upper_bound"].split()[0], 0) + 1
+                elif "DW_AT_count" in dimension:
+                    size *= int(dimension["DW_AT_count"].split()[0], 0)
+            return size, align
+        if tag in ("DW_TAG_structure_type", "DW_TAG_union_type"):
+            size = 0
+            align = 1
+            for member in die["children"]:
+                if member["tag"] != "DW_TAG_member":
+                    continue
+                length, alignment = layout(ref(member))
+                align = max(align, alignment)
+                if tag == "DW_TAG_union_type":
+                    size = max(size, length)
+                else:
+                    size = -(-size // alignment) * alignment + length
+            return -(-size // align) * align, align
+        raise BudgetError("no size of %s" % tag)
+
+    def const(die):
+        while die["tag"] in ("DW_TAG_typedef", "DW_TAG_volatile_type", "DW_TAG_array_type"):
+            die = ref(die)
+        return die["tag"] == "DW_TAG_const_type"
+
+    modules = {}
+    for variable in variables:
+        if "DW_OP_addr" not in variable.get("DW_AT_location", ""):
+            continue                                # a declaration or optimized out
+        declaration = ref(variable, "DW_AT_specification") or variable
+        name = declaration.get("DW_AT_name")
+        kind = ref(declaration)
+        if name is None or kind is None or const(kind):
+            continue                                # const lives in the flash
+        if "DW_AT_external" in declaration:
+            if name in externals:
+                continue
+            externals.add(name)
+        if name in noinit:
+            section = "noinit"
+        else:
+            section = "data" if symbols.get(name, "").startswith(".data") else "bss"
+        modules.setdefault(module, {}).setdefault(section, 0)
+        modules[module][section] += layout(kind)[0]
+    for sizes in modules.values():
+        for section in sizes:
+            sizes[section] += sizes[section] & 1        # the next module starts at an even address
+    return modules
+
+
+def parse_ci(text, functions, calls, word=2):
+    """Adds the nodes with stack usage and the edges of a .ci file, with the
+    frames in words of <word> bytes scaled to the 2 bytes of the MSP430."""
+    for node in re.finditer(r'node: \{ title: "([^"]+)" label: "([^"]*)"', text):
+        usage = re.search(r"\\n(\d+) bytes \((static|dynamic[^)]*)\)", node.group(2))
+        if usage:
+            functions[node.group(1)] = -(-int(usage.group(1)) // word) * 2
+    for edge in re.finditer(r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"', text):
+        calls.setdefault(edge.group(1), set()).add(edge.group(2))
+
+
+def scan_sources(directory, functions):
+    """Returns the interrupts and the functions whose address is taken."""
+    interrupts = set()
+    taken = set()
+    names = re.compile(r"\b(" + "|".join(map(re.escape, functions)) + r")\b(?!\s*\()") if functions else None
+    paths = glob.glob(os.path.join(directory, "*.c")) + glob.glob(os.path.join(directory, "libs", "*.c"))
+    for path in paths:
+        with open(path, errors="replace") as f:
+            text = re.sub(r"//[^\n]*|/\*.*?\*/", "", f.read(), flags=re.S)
+        interrupts.update(re.findall(r"__interrupt\s+void\s+(\w+)\s*\(", text))
+        if names is not None:
+            taken.update(names.findall(text))
+    return interrupts, taken
+
+
+def scan_noinit(directory):
+    """Returns the variables of #pragma NOINIT, which the host build has in .bss."""
+    noinit = set()
+    for path in glob.glob(os.path.join(directory, "*.c")) + glob.glob(os.path.join(directory, "libs", "*.c")):
+        with open(path, errors="replace") as f:
+            noinit.update(re.findall(r"#pragma\s+NOINIT\s*\(\s*(\w+)\s*\)", f.read()))
+    return noinit
+
+
+def deepest(name, functions, calls, taken, memo, active):
+    """Returns (bytes, chain) of the deepest call chain from <name>."""
+    if name in memo:
+        return memo[name]
+    if name in active:
+        raise BudgetError("recursion through " + name)
+    active.add(name)
+    targets = set(calls.get(name, ()))
+    if INDIRECT in targets:
+        targets.discard(INDIRECT)
+        patterns = INDIRECT_CALLS.get(name, ["*"])
+        targets |= {f for f in taken if any(fnmatch.fnmatchcase(f, p) for p in patterns)}
+    best = (0, [])
+    for target in sorted(targets):
+        if target in functions:
+            depth = deepest(target, functions, calls, taken, memo, active)
+            if depth[0] > best[0]:
+                best = depth
+    active.discard(name)
+    memo[name] = (functions.get(name, 0) + best[0], [name] + best[1])
+    return memo[name]
+
+
+def report(modules, functions, calls, interrupts, taken, size, out=sys.stdout, rom=None, model=False,
+           headroom=0):
+    """Prints the budget, returns the bytes left over <headroom> (negative if
+    too much). The code counts against <rom> unless it is the one of the
+    <model> build."""
+    kinds = ["data", "bss", "noinit"]
+    section = modules.pop(STACK, {}).get("stack", 0)
+    code = {module: modules[module].pop(CODE, 0) for module in modules}
+    out.write("%-16s %6s %6s %6s %6s" % ("module", *kinds, "total") + ("   code" if rom else "") + "\n")
+    variables = 0
+    for module in sorted(modules, key=lambda m: (-sum(modules[m].values()), -code[m], m)):
+        sizes = modules[module]
+        total = sum(sizes.values())
+        variables += total
+        out.write("%-16s %6d %6d %6d %6d" % (module, *(sizes.get(k, 0) for k in kinds), total) +
+                  (" %6d" % code[module] if rom else "") + "\n")
+    out.write("%-16s %27d\n" % ("variables", variables))
+
+    stack = 0
+    if functions:
+        memo = {}
+        main = deepest("main", functions, calls, taken, memo, set())
+        out.write("\n%-16s %6d  %s\n" % ("stack of main", main[0], " > ".join(main[1])))
+        worst = 0
+        for isr in sorted(interrupts & set(functions)):
+            depth = deepest(isr, functions, calls, taken, memo, set())
+            out.write("%-16s %6d  %s\n" % (isr, depth[0] + INTERRUPT_FRAME, " > ".join(depth[1])))
+            worst = max(worst, depth[0] + INTERRUPT_FRAME)
+        stack = main[0] + worst
+        out.write("%-16s %27d\n" % ("stack worst case", stack))
+    if section:
+        out.write("%-16s %27d%s\n" % ("stack section", section,
+                                      "  too small" if section < stack else ""))
+    left = size - variables - max(stack, section)
+    out.write("%-16s %27d of %d\n" % ("free", left, size))
+    if headroom:
+        out.write("%-16s %27d%s\n" % ("headroom", headroom, "  too little free" if left < headroom else ""))
+    left -= headroom
+    if rom:
+        total = sum(code.values())
+        out.write("\n%-16s %27d of %d%s\n" % ("code", total, rom,
+                                              "  of the model build, not checked" if model else
+                                              "  too much" if total > rom else ""))
+        if not model:
+            left = min(left, rom - total)
+    return left
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("map", help="linker map of the build")
+    parser.add_argument("ci", nargs="*", help=".ci files of gcc -fcallgraph-info=su")
+    parser.add_argument("--ram", default="0x0200:512", help="start:size of the RAM")
+    parser.add_argument("--rom", help="start:size of the flash, to check the code too")
+    parser.add_argument("--objects", nargs="+", default=[],
+                        help="objects of the model build, the variables are taken from them")
+    parser.add_argument("--headroom", type=int, default=0, help="bytes of RAM which have to stay free")
+    parser.add_argument("--word", type=int, default=2, help="bytes per stack word of the call graphs")
+    parser.add_argument("--write", help="file to write the budget to as well")
+    parser.add_argument("--src", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."),
+                        help="directory of main.c, for interrupts and indirect calls")
+    args = parser.parse_args()
+
+    start, size = (int(value, 0) for value in args.ram.split(":"))
+    rom_start, rom = (int(value, 0) for value in args.rom.split(":")) if args.rom else (None, None)
+    with open(args.map, errors="replace") as f:
+        modules = parse_map(f.read(), start, size, rom_start)
+    functions = {}
+    calls = {}
+    for path in args.ci:
+        with open(path, errors="replace") as f:
+            parse_ci(f.read(), functions, calls, args.word)
+    interrupts, taken = scan_sources(args.src, functions)
+    try:
+        if args.objects:
+            # the variables of the model, the code of its map
+            code = {module: {CODE: sizes[CODE]} for module, sizes in modules.items() if CODE in sizes}
+            modules = {}
+            externals = set()
+            noinit = scan_noinit(args.src)
+            for path in args.objects:
+                text = subprocess.run(["readelf", "-W", "--sections", "--syms", "--debug-dump=info", path],
+                                      check=True, capture_output=True, text=True).stdout
+                module = os.path.splitext(os.path.basename(path))[0]
+                for name, sizes in parse_dwarf(text, module, externals, noinit).items():
+                    modules[name] = sizes
+            for module, sizes in code.items():
+                modules.setdefault(module, {}).update(sizes)
+        out = io.StringIO()
+        left = report(modules, functions, calls, interrupts, taken, size, out, rom, bool(args.objects),
+                      args.headroom)
+    except BudgetError as error:
+        print("failed: %s" % error, file=sys.stderr)
+        return 1
+    sys.stdout.write(out.getvalue())
+    if args.write:
+        with open(args.write, "w") as f:
+            f.write(out.getvalue())
+    return 0 if left >= 0 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""Decode the recordings of the plays.
+
+Usage:
+    replay_decode.py --image FLASH      (read them from a flash image)
+    replay_decode.py --file UART        (decode bytes sent by the game)
+
+        [--write REPLAY]                write the newest one of a song of the
+                                        game as replay of tests/replays/
+        [--check REPLAY_TEST]           play it with build/replay_test and
+                                        compare the score with the recorded one
+
+The game records every play into sectors 26 and 27 of the flash and sends
+the page of a recording as telemetryReplay frames once it is back in the
+menu. --image takes a dump of the flash or the -f file of the host
+simulation, --file a capture or its -u file. The format is described in
+libs/recorder.h and libs/replay.h. Truncated recordings, which lack presses
+the game had no room for, are listed but never written or checked. Returns
+1 if no complete recording was found or the check failed.
+"""
+
+import argparse
+import re
+import struct
+import subprocess
+import sys
+
+from chart_upload import FrameReader, crc8
+
+TELEMETRY_REPLAY = 8            # telemetryReplay
+
+RECORDER_SECTOR = 26
+RECORDER_SLOTS = 512
+RECORDER_CLAIM = 0x52
+RECORDER_EVENTS = 242
+RECORDER_TRUNCATED = 0x01       # flag of RecorderHeader
+PAGE = 256
+HEADER = "<BBHHBB4sBx"           # RecorderHeader
+HEADER_SIZE = struct.calcsize(HEADER)
+SONG_COUNT = 3                  # songs of the game, libs/songs.h
+
+DIFFICULTIES = ["normal", "expert"]
+
+
+def decode(data):
+    """Returns the (delta, mask) events of a varint stream, see replay.h."""
+    events = []
+    value = shift = 0
+    for byte in data:
+        value |= (byte & 0x7F) << shift
+        if byte & 0x80:
+            shift += 7
+            continue
+        events.append((value >> 4, value & 0x0F))
+        value = shift = 0
+    return events
+
+
+def recording(slot, page):
+    """Returns the recording of a page as dict, None if it isn't complete."""
+    claim, board, sequence, seed, length, crc, score, flags = struct.unpack_from(HEADER, page)
+    if claim != RECORDER_CLAIM or length > RECORDER_EVENTS:
+        return None
+    data = bytes(page[HEADER_SIZE:HEADER_SIZE + length])
+    if len(data) != length:
+        return None
+    return {
+        "slot": slot,
+        "board": board,
+        "sequence": sequence,
+        "seed": seed,
+        "score": struct.unpack("<I", score)[0],
+        "data": data,
+        "crc": crc == crc8(data),
+        "truncated": bool(flags & RECORDER_TRUNCATED),
+        "events": decode(data),
+    }
+
+
+def from_image(path):
+    """Returns the pages of the log in the flash image at <path>."""
+    with open(path, "rb") as f:
+        f.seek(RECORDER_SECTOR << 16)
+        log = f.read(RECORDER_SLOTS * PAGE)
+    log += b"\xFF" * (RECORDER_SLOTS * PAGE - len(log))
+    return {slot: log[slot * PAGE:(slot + 1) * PAGE] for slot in range(RECORDER_SLOTS)}
+
+
+def from_frames(frames):
+    """Returns the pages put together from the telemetryReplay frames."""
+    pages = {}
+    for frame_type, payload in frames:
+        if frame_type != TELEMETRY_REPLAY or len(payload) < 3:
+            continue
+        slot, offset = struct.unpack_from("<HB", payload)
+        page = pages.setdefault(slot, bytearray(b"\xFF" * PAGE))
+        data = payload[3:]
+        page[offset:offset + len(data)] = data
+    return pages
+
+
+def song_name(board, seed=None):
+    if board & 0x80:
+        return "flash slot %d %s" % ((board >> 1 & 0x3F) + 1, DIFFICULTIES[board & 1])
+    if board // 2 == SONG_COUNT:
+        if seed is not None:
+            return "endless %s %d" % (DIFFICULTIES[board & 1], seed)
+        return "endless %s" % DIFFICULTIES[board & 1]
+    return "song %d %s" % (board // 2 + 1, DIFFICULTIES[board & 1])
+
+
+def show(found):
+    for r in found:
+        presses = sum(bin(mask).count("1") for _, mask in r["events"])
+        print("slot %3d  #%-5d %-22s score %-6d %3d presses in %3d bytes (%.2f per press)%s%s" % (
+            r["slot"], r["sequence"], song_name(r["board"], r["seed"]), r["score"], presses, len(r["data"]),
+            len(r["data"]) / presses if presses else 0, "" if r["crc"] else "  CRC wrong",
+            "  truncated" if r["truncated"] else ""))
+
+
+def write_replay(r, path):
+    """Writes <r> in the format of tests/replays/, one line per lane."""
+    ms = 0
+    with open(path, "w") as f:
+        f.write("# slot %d, recorded score %d\n" % (r["slot"], r["score"]))
+        f.write(song_name(r["board"], r["seed"]) + "\n")
+        for delta, mask in r["events"]:
+            ms += delta
+            for lane in range(4):
+                if mask & 1 << lane:
+                    f.write("%d %d\n" % (ms, lane + 1))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--image", help="flash image to read the log from")
+    parser.add_argument("--file", help="UART capture with telemetryReplay frames")
+    parser.add_argument("--write", help="write the newest recording of a song of the game as replay")
+    parser.add_argument("--check", help="replay_test binary to play the written replay with")
+    args = parser.parse_args()
+
+    if args.image is not None:
+        pages = from_image(args.image)
+    elif args.file is not None:
+        with open(args.file, "rb") as f:
+            pages = from_frames(FrameReader().feed(f.read()))
+    else:
+        parser.error("--image or --file is needed")
+
+    found = [r for r in (recording(slot, page) for slot, page in sorted(pages.items())) if r]
+    found.sort(key=lambda r: r["sequence"])
+    show(found)
+    game = [r for r in found if r["crc"] and not r["truncated"] and r["board"] < (SONG_COUNT + 1) * 2]
+    if not found or ((args.write or args.check) and not game):
+        return 1
+    if args.write is None:
+        return 0
+
+    write_replay(game[-1], args.write)
+    if args.check is None:
+        return 0
+    output = subprocess.run([args.check, args.write], capture_output=True, text=True).stdout
+    match = re.search(r"^score (\d+)", output, re.M)
+    if match is None or int(match.group(1)) != game[-1]["score"]:
+        print("FAIL the replay scores %s, recorded %d" % (match.group(1) if match else "nothing", game[-1]["score"]))
+        return 1
+    print("replay scores %d like recorded" % game[-1]["score"])
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
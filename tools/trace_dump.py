@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""Request and print the trace ring of the game.
+
+Usage:
+    trace_dump.py PORT [--baud 115200] [--timeout 5]
+    trace_dump.py --file UART           (decode bytes sent by the game)
+
+        [--expect "EVENT ARG"]...       records which have to be in the dump,
+                                        in this order, e.g. "press 2"
+
+The game answers a request in the menu or in "Upload Song". After a reset
+by the watchdog it sends the ring on its own, --file decodes such a capture
+or the -u file of the host simulation. The format is described in
+libs/trace.h. Returns 1 if no record was found or an expected one is
+missing.
+"""
+
+import argparse
+import os
+import select
+import struct
+import sys
+import time
+
+from chart_upload import FrameReader, frame, open_port
+
+TELEMETRY_TRACE = 5             # telemetryTrace
+TRACE_REQUEST = 0x30            # traceRequest
+
+GAME_STATES = ["menus", "ingame", "gameover", "loading", "composing"]
+LOADER_STATUS = ["ok", "crc", "order", "invalid"]
+RESET_FLAGS = [(0x01, "watchdog"), (0x04, "power on"), (0x08, "reset pin")]
+SONG_COUNT = 3                  # songs of the game, libs/songs.h
+LIBRARY_SLOTS = 16              # songs of the flash, libs/library.h
+
+
+def song_name(song):
+    """Returns the name of song_choice <song> of main.c."""
+    if song < SONG_COUNT:
+        return str(song + 1)
+    if song < SONG_COUNT + LIBRARY_SLOTS:
+        return "flash slot %d" % (song - SONG_COUNT + 1)
+    return "endless"
+
+
+def board_name(board):
+    """Returns the name of leaderboard <board> of leader.h."""
+    song = "endless" if board // 2 == SONG_COUNT else "song %d" % (board // 2 + 1)
+    return "%s %s" % (song, "Expert" if board & 1 else "Normal")
+
+
+# enum TraceEvent: name, function to print the argument
+EVENTS = {
+    1: ("reset", lambda a: ", ".join(n for bit, n in RESET_FLAGS if a & bit) or "-"),
+    2: ("state", lambda a: GAME_STATES[a] if a < len(GAME_STATES) else str(a)),
+    3: ("song", song_name),
+    4: ("press", lambda a: " ".join(str(i + 1) for i in range(4) if a & 1 << i)),
+    5: ("idle", lambda a: "LPM3" if a else "awake"),
+    6: ("late", lambda a: "task %d" % a),
+    7: ("i2c nack", lambda a: "0x%02X" % a),
+    8: ("flash erase", lambda a: "sector %d" % a),
+    9: ("flash program", lambda a: "sector %d" % a),
+    10: ("storage", lambda a: "copy %s written" % "AB"[a & 1]),
+    11: ("dropped", lambda a: "frame type %d" % a),
+    12: ("loader", lambda a: LOADER_STATUS[a] if a < len(LOADER_STATUS) else str(a)),
+    13: ("dump", lambda a: "after watchdog reset" if a else "requested"),
+    14: ("leaderboard", lambda a: "%s written" % board_name(a)),
+    15: ("recorder", lambda a: "%d bytes of events" % a),
+    16: ("composer", lambda a: "chart in slot %d" % (a + 1)),
+}
+
+
+def records(frames):
+    """Returns the (sequence, tick, event, arg) records of the trace frames."""
+    found = []
+    for frame_type, payload in frames:
+        if frame_type != TELEMETRY_TRACE or len(payload) < 2 or (len(payload) - 2) % 4:
+            continue
+        sequence = struct.unpack_from("<H", payload)[0]
+        for offset in range(2, len(payload), 4):
+            tick, event, arg = struct.unpack_from("<HBB", payload, offset)
+            if event:                       # 0: never written
+                found.append((sequence, tick, event, arg))
+            sequence = (sequence + 1) & 0xFFFF
+    return found
+
+
+def describe(event, arg):
+    """Returns the name of <event> and the text of its <arg>."""
+    name, text = EVENTS.get(event, ("event %d" % event, str))
+    return name, text(arg)
+
+
+def show(found):
+    last = None
+    for sequence, tick, event, arg in found:
+        if last is not None and sequence != (last + 1) & 0xFFFF:
+            print("        ... %d records lost" % ((sequence - last - 1) & 0xFFFF))
+        last = sequence
+        print("%5d %6d ms  %-14s %s" % ((sequence, tick) + describe(event, arg)))
+
+
+def missing(found, expected):
+    """Returns the first of <expected> which the records don't show in this
+    order, None if they show all."""
+    texts = iter("%s %s" % describe(event, arg) for _, _, event, arg in found)
+    for text in expected:
+        if text not in texts:
+            return text
+    return None
+
+
+def request(fd, timeout):
+    """Requests a dump and collects frames until the line is quiet."""
+    reader = FrameReader()
+    frames = []
+    os.write(fd, frame(TRACE_REQUEST))
+    end = time.monotonic() + timeout
+    while time.monotonic() < end:
+        ready, _, _ = select.select([fd], [], [], end - time.monotonic())
+        if ready:
+            frames += reader.feed(os.read(fd, 256))
+    return frames
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("port", nargs="?", help="serial port of the LaunchPad")
+    parser.add_argument("--baud", type=int, default=115200, help="UART_BAUD of the game")
+    parser.add_argument("--timeout", type=float, default=5.0, help="seconds to collect the dump")
+    parser.add_argument("--file", help="decode a file instead of asking the game")
+    parser.add_argument("--expect", action="append", default=[], help="record which has to follow the last one")
+    args = parser.parse_args()
+
+    if args.file is not None:
+        with open(args.file, "rb") as f:
+            frames = FrameReader().feed(f.read())
+    elif args.port is not None:
+        fd = open_port(args.port, args.baud)
+        try:
+            frames = request(fd, args.timeout)
+        finally:
+            os.close(fd)
+    else:
+        parser.error("a port or --file is needed")
+
+    found = records(frames)
+    show(found)
+    text = missing(found, args.expect)
+    if text is not None:
+        print("expected record not found: %s" % text)
+        return 1
+    return 0 if found else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())